@@ -1,7 +1,7 @@
 #version 330 core
 
-layout (location = 0) in vec3 aPos;
-layout (location = 1) in vec3 aColor;
+layout (location = 0) in vec4 aPos;   // Quantized position (xyz) and face index (w)
+layout (location = 1) in vec4 aColor;
 
 out vec3 vertexColor;
 
@@ -10,6 +10,6 @@ uniform mat4 view;
 uniform mat4 projection;
 
 void main() {
-    gl_Position = projection * view * model_matrix * vec4(aPos, 1.0f);
+    gl_Position = projection * view * model_matrix * vec4(aPos.xyz, 1.0f);
     vertexColor = vec3(1.0f, 1.0f, 1.0f);
 }
\ No newline at end of file
@@ -1,24 +1,55 @@
 #version 330 core
 
-layout(location = 0) in vec3 position; // Vertex position
-layout(location = 1) in vec3 color;    // Vertex color (used for base color)
-layout(location = 2) in vec3 normal;   // Vertex normal
+layout(location = 0) in vec4 packed_position; // Quantized vertex position (xyz) and face index (w)
+layout(location = 1) in vec4 color;           // Vertex color (used for base color)
+layout(location = 2) in uint cube_index;      // Index of the cube's record (instanced only)
 
-uniform mat4 model_matrix;
+// Face index -> normal, must match TotalFrame::FACE_NORMALS
+const vec3 face_normals[6] = vec3[6](
+    vec3( 1.0,  0.0,  0.0), vec3(-1.0,  0.0,  0.0),
+    vec3( 0.0,  1.0,  0.0), vec3( 0.0, -1.0,  0.0),
+    vec3( 0.0,  0.0,  1.0), vec3( 0.0,  0.0, -1.0)
+);
+
+uniform mat4 model_matrix;   // Includes the scale that undoes the position quantization
 uniform mat4 view;
 uniform mat4 projection;
 uniform mat3 normal_matrix; // Inverse transpose of the model matrix (for normals)
+uniform vec4 cube_color;    // Per cube color, multiplied with the vertex color (white for per vertex colors)
+
+uniform bool instanced;             // Drawn by an Object, position and color come from the cube's record instead
+uniform usamplerBuffer cube_records; // TotalFrame::CubeRecord per cube, 5 uints each (position xyz, color, template)
+uniform float vertex_scale;         // Undoes the position quantization (instanced only)
+uniform vec3 stretch;               // Aspect ratio stretch (instanced only)
 
 out vec3 frag_position;     // Position in world space
 out vec3 frag_normal;       // Normal in world space
 out vec3 base_color;        // Color passed to the fragment shader
 
 void main() {
-    vec4 world_position = model_matrix * vec4(position, 1.0);
+    vec4 world_position;
+    vec3 tint;
+
+    if (instanced) {
+        int record = int(cube_index) * 5;
+        vec3 cube_position = uintBitsToFloat(uvec3(
+            texelFetch(cube_records, record + 0).r,
+            texelFetch(cube_records, record + 1).r,
+            texelFetch(cube_records, record + 2).r
+        ));
+        uint packed_color = texelFetch(cube_records, record + 3).r;
+
+        world_position = vec4((cube_position + packed_position.xyz * vertex_scale) * stretch, 1.0);
+        tint = vec3(packed_color & 0xFFu, (packed_color >> 8) & 0xFFu, (packed_color >> 16) & 0xFFu) / 255.0;
+    } else {
+        world_position = model_matrix * vec4(packed_position.xyz, 1.0);
+        tint = cube_color.rgb;
+    }
     frag_position = world_position.xyz;
 
+    vec3 normal = face_normals[clamp(int(packed_position.w), 0, 5)];
     frag_normal = normalize(normal_matrix * normal);
-    base_color = color;
+    base_color = color.rgb * tint;
 
     gl_Position = projection * view * world_position;
 }
\ No newline at end of file
@@ -0,0 +1,13 @@
+#version 330 core
+
+in vec2 TexCoord;
+in vec4 Color;
+out vec4 FragColor;
+
+// glyph coverage in the red channel
+uniform sampler2D atlas;
+
+void main()
+{
+    FragColor = vec4(Color.rgb, Color.a * texture(atlas, TexCoord).r);
+}
@@ -0,0 +1,82 @@
+#ifndef SRC_ARENA_H_
+#define SRC_ARENA_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+#include <algorithm>
+#include <type_traits>
+
+#include <SDL3/SDL.h>
+
+#include "TotalFrame.h"
+#include "Util.h"
+
+/*
+ABOUT:
+Chunked bump allocator for short lived data, like the temporaries of loading an object.
+Allocating is a pointer bump, nothing is freed one by one. Reset() or destroying the arena releases everything in one shot.
+
+NOTES:
+Chunks are kept across Reset(), so a reused arena stops allocating once it has grown to its working size.
+Requests larger than the chunk size get a chunk of their own.
+Only trivially destructible types can be placed in it, destructors are never run.
+Not thread safe. Allocate on one thread, then hand disjoint ranges to the workers.
+*/
+
+class Arena {
+    public:
+        Arena(size_t chunk_size = DEFAULT_CHUNK_SIZE);
+
+        Arena(const Arena&) = delete;
+        Arena& operator=(const Arena&) = delete;
+
+        //////// CONSTANTS
+        static constexpr size_t DEFAULT_CHUNK_SIZE = 1 << 20;
+
+        //////// ALLOCATION FUNCTIONS
+        void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+        // count value initialized (zeroed) Ts
+        template <typename T>
+        T* AllocateArray(size_t count) {
+            static_assert(std::is_trivially_destructible<T>::value, "Arena never runs destructors");
+            T* memory = static_cast<T*>(Arena::Allocate(sizeof(T) * count, alignof(T)));
+            std::uninitialized_value_construct_n(memory, count);
+            return memory;
+        }
+
+        //////// MEMORY MANAGEMENT
+        // forgets every allocation, keeps the chunks for reuse
+        void Reset();
+        // forgets every allocation and releases the chunks
+        void FreeAll();
+
+        //////// GETTERS
+        size_t GetBytesUsed() const;
+        size_t GetTotalChunks() const;
+
+    private:
+        struct Chunk {
+            std::unique_ptr<std::byte[]> memory = nullptr;
+            size_t size = 0;
+        };
+
+        size_t chunk_size = DEFAULT_CHUNK_SIZE;
+
+        std::vector<Chunk> chunks = {};
+        // chunk being bumped and the offset into it
+        size_t current_chunk = 0;
+        size_t current_offset = 0;
+
+        size_t bytes_used = 0;
+
+        // moves to a chunk with at least size bytes free after alignment, creating one if there is none
+        void _NextChunk(size_t size, size_t alignment);
+};
+
+#endif // SRC_ARENA_H_
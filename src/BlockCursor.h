@@ -15,6 +15,8 @@
 #include "TotalFrame.h"
 #include "Util.h"
 #include "Cube.h"
+#include "Camera.h"
+#include "Object.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/ext.hpp"
@@ -32,8 +34,17 @@ class BlockCursor {
 
         glm::vec3 NextCubePosition();
 
-    private:
+        //////// HOVER
+        // mouse motion, camera movement and edits only mark the hover stale, UpdateHover() then picks once for all of them
+        void InvalidateHover();
+        // picks the cube under the mouse and places the cursor on its face if the hover is stale. true if the cursor moved, appeared or disappeared
+        bool UpdateHover(Object& object, Camera& camera, float mouse_x, float mouse_y);
+        // as of the last UpdateHover(), SIZE_MAX for none
+        size_t GetHoveredCube() const;
 
+    private:
+        bool hover_stale = true;
+        size_t hovered_cube = SIZE_MAX;
 };
 
 #endif // SRC_BLOCKCURSOR_H_
\ No newline at end of file
@@ -13,6 +13,7 @@
 
 #include "TotalFrame.h"
 #include "Util.h"
+#include "GLDispatch.h"
 
 /*
 ABOUT:
@@ -28,6 +29,14 @@ class Camera {
         //////// CONSTUCTOR
         Camera(glm::vec3 start_position, Uint16 window_width, Uint16 window_height, float move_speed = 0.01f, float sensitivity = 0.1f, float fov = 45.0f, TotalFrame::KEYSET movement_keyset = TotalFrame::KEYSET::WASD);
 
+        //////// TYPES
+        // where the camera is and where it looks, what input recordings check replays against
+        struct State {
+            glm::vec3 position = glm::vec3(0.0f);
+            float yaw = 0.0f;
+            float pitch = 0.0f;
+        };
+
         //////// CAMERA ATTRIBUTES
         // camera pos
         glm::vec3 position;
@@ -35,6 +44,7 @@ class Camera {
         //////// GENERAL FUNCTIONS
         glm::mat4 GetViewMatrix();
         glm::mat4 GetProjectionMatrix();
+        State GetState();
 
         //////// SHADER PROGRAM FUNCTIONS
         void UpdateShaderProgram(GLuint shader_program);
@@ -44,6 +54,8 @@ class Camera {
         void StartMove(SDL_Keycode key);
         bool UpdateMovement();
         void StopMove(SDL_Keycode key);
+        // a movement key is held, UpdateMovement() will move the camera every frame
+        bool IsMoving();
 
         //////// CAMERA MOUSE MOVEMENT FUNCTIONS
         void StartMouseMove(float x, float y);
@@ -87,9 +99,9 @@ class Camera {
         // which direction in the world is up
         glm::vec3 world_up = glm::vec3(0.0f, 1.0f, 0.0f);
         // which direction of the camera is right
-        glm::vec3 right;
+        glm::vec3 right = glm::vec3(1.0f, 0.0f, 0.0f);
         // which direction of the camera is up
-        glm::vec3 up;
+        glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
 
         //// OPENGL CAMERA FUNCTIONS
         void _UpdateMatrices();
@@ -0,0 +1,104 @@
+#ifndef SRC_COMMANDLINE_H_
+#define SRC_COMMANDLINE_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <mutex>
+
+#include <filesystem>
+#include <fstream>
+
+#include <SDL3/SDL.h>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "TotalFrame.h"
+#include "Util.h"
+#include "GLDispatch.h"
+#include "JobSystem.h"
+#include "Camera.h"
+#include "LightHandler.h"
+#include "Object.h"
+
+/*
+ABOUT:
+Headless mode, loads, transforms, culls and exports .tfobj_dev files with no window or OpenGL context.
+
+NOTES:
+main() hands over to Run() when the first argument is --headless. OpenGL goes through GLDispatch's null backend, so the render path still runs (and can be timed) without a GPU.
+Steps run in a fixed order, whatever order the options are given in: load, --translate, --hollow, --check-index, cull from --camera, --frames, --save, --export.
+--check-index serializes the lattice index, reads it back and compares every cell, the exit code is 1 if they differ. --save also writes the index next to the saved file.
+Culling uses the editor's starting camera (and its 1920x1080 aspect ratio) unless --camera moves it.
+--export-dir switches to batch export: every input pattern is expanded and each file is loaded, transformed and exported to DIR/<name>.tfobj as its own job on the JobSystem.
+Batch jobs make no OpenGL calls (nothing is rendered), so GLDispatch stays on the main thread. A file's Object runs serially on its worker, the parallelism is across files, so a file's time is its own and not other jobs run while it waited. Each file's line is printed as it finishes, then a summary, and the exit code is 1 if any file failed.
+Patterns match * and ? in the file name only, a directory as a pattern means every .tfobj_dev in it and a "**" directory searches every directory below it.
+
+USAGE:
+--headless INPUT.tfobj_dev [--translate X Y Z] [--hollow] [--check-index] [--camera X Y Z] [--frames N] [--save PATH.tfobj_dev] [--export PATH.tfobj]
+--headless --export-dir DIR PATTERN... [--translate X Y Z] [--hollow] [--jobs N]
+*/
+
+class CommandLine {
+    public:
+        //////// BASIC FUNCTIONS
+        static bool IsHeadless(int argc, char* argv[]);
+        // returns the process exit code
+        static int Run(int argc, char* argv[]);
+        // the app is linked for the windows subsystem, printf() only shows once this borrows the console it was started from
+        static void AttachParentConsole();
+
+    private:
+        //////// CONSTANTS
+        // the editor window's
+        static constexpr Uint16 WINDOW_WIDTH = 1920;
+        static constexpr Uint16 WINDOW_HEIGHT = 1080;
+
+        //////// TYPES
+        struct Options {
+            // a single file, or any number of patterns with --export-dir
+            std::vector<std::string> input_paths = {};
+            glm::vec3 translation = glm::vec3(0.0f);
+            bool hollow = false;
+            bool check_index = false;
+            glm::vec3 camera_position = glm::vec3(0.0f, 1.0f, 3.0f);
+            size_t frames = 0;
+            std::string save_path = "";
+            std::string export_path = "";
+            std::string export_directory = "";
+            // threads for --export-dir, 0 uses every core
+            unsigned int jobs = 0;
+        };
+
+        struct BatchResult {
+            std::filesystem::path input_path = "";
+            std::filesystem::path output_path = "";
+            bool succeeded = false;
+            std::string error = "";
+            size_t total_cubes = 0;
+            double load_time = 0.0;
+            double transform_time = 0.0;
+            double export_time = 0.0;
+            double total_time = 0.0;
+        };
+
+        //////// MODES
+        static int _RunSingle(const Options& options);
+        static int _RunBatch(const Options& options);
+        // loads, transforms and exports one file, runs on a worker
+        static void _ExportFile(const Options& options, BatchResult& result);
+
+        //////// PARSING FUNCTIONS
+        static bool _Parse(const std::vector<std::string>& arguments, Options& options_out);
+        static void _PrintUsage();
+        // appends the .tfobj_dev files matching pattern, false if it matched nothing
+        static bool _ExpandPattern(const std::string& pattern, std::vector<std::filesystem::path>& paths_out);
+        static bool _MatchWildcard(const char* pattern, const char* text);
+
+        //////// OUTPUT FUNCTIONS
+        static bool _WriteFile(const std::string& path, const std::string& data);
+};
+
+#endif // SRC_COMMANDLINE_H_
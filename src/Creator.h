@@ -16,6 +16,7 @@
 
 #include "TotalFrame.h"
 #include "Util.h"
+#include "Profiler.h"
 #include "Cube.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
@@ -30,15 +31,20 @@ class Creator {
 
         //////// BASIC FUNCTIONS
         std::shared_ptr<std::string> GetName();
+        // path of the object last saved, loaded or created, empty before any
+        std::string GetPath();
+        void FreeAll();
 
         //////// CUBE DEFAULT FUNCTIONS
-        void SetCubeDefault(Cube cube);
-        Cube GetCubeDefault();
+        // takes the cube over, the adjusted default is a clone of it
+        void SetCubeDefault(Cube&& cube);
+        Cube& GetCubeDefault();
         glm::vec3 GetCubeDefaultPosition();
         void UpdateCubeDefaultPosition(glm::vec3 position);
 
         //////// SAVING FUNCTIONS
-        void Save(std::string object_data);
+        // false if it was cancelled or could not be written
+        bool Save(std::string object_data);
         bool NewObject();
 
         bool Export(std::string object_data);
@@ -22,7 +22,11 @@
 
 #include "TotalFrame.h"
 #include "Util.h"
+#include "Profiler.h"
 #include "Triangle.h"
+#include "Culler.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/ext.hpp"
@@ -32,15 +36,24 @@ ABOUT:
 A collection of triangles with a shader program and positional/transformational attributes
 
 NOTES:
-Use Object to hold cubes.
+Use Object to hold cubes. Object keeps only a compact record per cube and shares the triangles through CubeTemplates, so a standalone Cube is for one-off cubes (block cursor, creator default).
+Move-only, its triangles and outline own their OpenGL objects. Use Clone() when a second independent copy is really needed.
+Those OpenGL objects are made by the first Render(), loading and transforming a cube never needs a context.
 */
 
 class Cube {
     public:
         Cube();
         Cube(std::string name, glm::vec3 position, float size, std::string path, GLuint shader_program, float aspect_ratio, std::string data_str = "");
+        Cube(const Cube&) = delete;
+        Cube& operator=(const Cube&) = delete;
+        Cube(Cube&&) = default;
+        Cube& operator=(Cube&&) = default;
         void FreeAll();
 
+        // builds a new cube with the same data and its own OpenGL objects
+        Cube Clone();
+
         //////// BASIC ATTRIBUTES
         std::string name = "";
         GLuint shader_program = 0;
@@ -53,11 +66,16 @@ class Cube {
 
         //////// BASIC FUNCTIONS
         void Create(std::string name, glm::vec3 position, float size, std::string path, GLuint shader_program, float aspect_ratio, std::string data_str = "");
+        // creates from already parsed data, see Cube::Parse()
+        void Create(std::string name, glm::vec3 position, float size, GLuint shader_program, float aspect_ratio, const TotalFrame::CubeData& data);
         void Load(std::string path, glm::vec3& position_out, std::string data_str = "");
         void Render(glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights);
         std::string GetData();
         void Verify();
 
+        // parses a cube data string without touching OpenGL. safe to call from worker threads
+        static bool Parse(const std::string& data_str, TotalFrame::CubeData& data_out);
+
         //////// EXPORTATION FUNCTIONS
         std::vector<std::array<TotalFrame::Ray, 14>> GetCornersRays();
         bool RayCollidesWithCorners(TotalFrame::Ray ray, glm::vec3 ignore_point);
@@ -77,6 +95,8 @@ class Cube {
         void SetPosition(glm::vec3 position);
 
         bool IsVisible(glm::mat4 view_projection_matrix);
+        // world space (stretched) axis aligned box around the cube
+        void GetBounds(glm::vec3& center_out, glm::vec3& extent_out);
 
         //////// TRANSLATION FUNCTIONS
         void Translate(glm::vec3 translation);
@@ -96,21 +116,23 @@ class Cube {
         //////// BASIC ATTRIBUTES
         std::unordered_map<GLuint, std::vector<Triangle>> triangles = {};
         std::vector<Triangle> export_triangles = {};
+        // largest coordinate of the triangles, they are quantized against it
+        float position_scale = 1.0f;
 
         //////// POSITION ATTRIBUTES
         std::vector<glm::vec3> corners = {};
 
         //////// LINE ATTRIBUTES
         std::vector<glm::vec3> lines_vertices = {};
-        GLuint lines_vertex_array = 0;
-        GLuint lines_vertex_buffer = 0;
+        GLVertexArray lines_vertex_array;
+        GLBuffer lines_vertex_buffer;
 
         //////// TRANSFORMATION ATTRIBUTES
-        std::shared_ptr<glm::mat4> stretched_model_matrix = std::make_shared<glm::mat4>(1.0f);
-        std::shared_ptr<glm::mat4> model_matrix = std::make_shared<glm::mat4>(1.0f);
-        std::shared_ptr<glm::mat4> initial_model_matrix = std::make_shared<glm::mat4>(1.0f);
+        glm::mat4 stretched_model_matrix = glm::mat4(1.0f);
+        glm::mat4 model_matrix = glm::mat4(1.0f);
+        glm::mat4 initial_model_matrix = glm::mat4(1.0f);
 
-        std::shared_ptr<glm::mat3> normal_matrix = std::make_shared<glm::mat3>(0.0f);
+        glm::mat3 normal_matrix = glm::mat3(0.0f);
 
         glm::vec3 true_up = glm::vec3(0.0f, 1.0f, 0.0f);
         glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
@@ -127,6 +149,8 @@ class Cube {
         //////// BASIC FUNCTIONS
         std::vector<Triangle> _Read(std::string path, glm::vec3& position_out);
         std::vector<Triangle> _CreateFromStr(std::string data_str, glm::vec3& position_out);
+        std::vector<Triangle> _CreateFromData(const TotalFrame::CubeData& data);
+        void _Finish(glm::vec3 position, glm::vec3 read_position, float size);
         float _ReadSize();
 
         //////// TRANSLATION FUNCTIONS
@@ -0,0 +1,94 @@
+#ifndef SRC_CUBETEMPLATE_H_
+#define SRC_CUBETEMPLATE_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+#include <cstring>
+#include <cmath>
+
+#include <SDL3/SDL.h>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "TotalFrame.h"
+#include "Util.h"
+#include "Triangle.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
+
+/*
+ABOUT:
+Cube geometry shared by every cube with the same triangles, size and shader program.
+Holds the packed vertices of all triangles in one vertex buffer, drawn with a single call.
+
+NOTES:
+Object keeps one template per distinct cube and stores only a TotalFrame::CubeRecord per cube.
+A cube whose triangles are all one color is stored as a white template plus the color in its record, so recolored cubes still share geometry.
+Load() never touches OpenGL (safe on worker threads). The vertex buffer is built on the main thread the first time the template is rendered.
+Move-only, it owns its vertex array and vertex buffer.
+RenderInstanced() is what Object uses, the cube index attribute is re-pointed at its own slice of the instance buffer each draw.
+*/
+
+class CubeTemplate {
+    public:
+        CubeTemplate();
+        CubeTemplate(const CubeTemplate&) = delete;
+        CubeTemplate& operator=(const CubeTemplate&) = delete;
+        CubeTemplate(CubeTemplate&&) = default;
+        CubeTemplate& operator=(CubeTemplate&&) = default;
+        void FreeAll();
+
+        //////// BASIC ATTRIBUTES
+        GLuint shader_program = 0;
+        // edge length, used for bounds and picking
+        float size = 0.0f;
+        // largest coordinate, the vertices are quantized against it
+        float position_scale = 1.0f;
+
+        //////// BASIC FUNCTIONS
+        // packs the triangles. size of READ_SIZE_FROM_FILE measures it from the vertices. color_out is white unless the triangles are all one color, which is then taken out of the template
+        void Load(const std::vector<std::vector<GLfloat>>& triangles_vertices, float size, GLuint shader_program, glm::vec3& color_out);
+        // copies vertices that were already packed (and had their color taken out) against position_scale
+        void LoadPacked(const TotalFrame::PackedVertex* vertices, size_t total_vertices, float size, float position_scale, GLuint shader_program);
+        void Build();
+        bool IsBuilt() const;
+        void Render();
+        // draws total_instances copies, instance i reads its cube index from instance_buffer at first_instance + i (attribute 2)
+        void RenderInstanced(GLuint instance_buffer, size_t first_instance, size_t total_instances);
+
+        //////// DATA FUNCTIONS
+        size_t GetTotalTriangles() const;
+        // untinted copy of the triangles, for recoloring cubes whose template has more than one color
+        std::vector<std::vector<GLfloat>> GetTrianglesVertices() const;
+        // the 18 floats of a triangle with color multiplied in, as saved in .tfobj_dev files
+        std::vector<GLfloat> GetTriangleVertices(size_t triangle, glm::vec3 color) const;
+        std::vector<glm::vec3> GetTrianglePositions(size_t triangle) const;
+        glm::vec3 GetColor() const;
+        // true for a plain white box, IsBox() with every vertex white
+        bool IsWhiteBox() const;
+        // true if the template fills its cell: every vertex on a corner, each face covered once by its triangles, and size matching the corners
+        bool IsBox() const;
+
+        //////// MATCHING FUNCTIONS
+        // identical templates have identical hashes. equal hashes still need Matches() to rule out collisions
+        Uint64 GetHash() const;
+        bool Matches(const TotalFrame::PackedVertex* vertices, size_t total_vertices, float size, float position_scale, GLuint shader_program) const;
+        bool Matches(const CubeTemplate& other) const;
+        // hash of a template that has not been built yet, equal to GetHash() of the template LoadPacked() would make
+        static Uint64 Hash(const TotalFrame::PackedVertex* vertices, size_t total_vertices, float size, float position_scale, GLuint shader_program);
+
+        //////// PACKING FUNCTIONS
+        // if every vertex has the same color, whitens them and returns that color. white otherwise
+        static glm::vec3 ExtractUniformColor(TotalFrame::PackedVertex* vertices, size_t total_vertices);
+
+    private:
+        std::vector<TotalFrame::PackedVertex> vertices = {};
+
+        GLVertexArray vertex_array;
+        GLBuffer vertex_buffer;
+};
+
+#endif // SRC_CUBETEMPLATE_H_
@@ -0,0 +1,103 @@
+#ifndef SRC_CULLER_H_
+#define SRC_CULLER_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <limits>
+
+#include <SDL3/SDL.h>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "TotalFrame.h"
+#include "Util.h"
+#include "JobSystem.h"
+
+/*
+ABOUT:
+Frustum culling of axis aligned boxes (center + extent).
+Extracts the 6 frustum planes once per frame and tests boxes against them 4 at a time (SSE) or 8 at a time (AVX builds).
+Boxes are grouped into a bounding volume hierarchy so whole off-screen regions are rejected with one test, and regions fully on screen are accepted without testing their boxes.
+
+NOTES:
+Call Build() whenever the boxes change (cubes created, destroyed or moved), then UpdateFrustum() and Cull() every frame.
+Cull() writes 1 into visibility_out[i] for every visible box i. It never clears, so zero the vector first.
+*/
+
+class Culler {
+    public:
+        Culler();
+
+        //////// FRUSTUM
+        struct Frustum {
+            // left, right, bottom, top, near, far. xyz = normal pointing inside, w = distance
+            std::array<glm::vec4, 6> planes = {};
+
+            void Update(const glm::mat4& view_projection_matrix);
+            // true if any part of the box may be on screen
+            bool IsBoxVisible(glm::vec3 center, glm::vec3 extent) const;
+            // true if the whole box is on screen
+            bool IsBoxInside(glm::vec3 center, glm::vec3 extent) const;
+        };
+
+        //////// BASIC FUNCTIONS
+        void UpdateFrustum(const glm::mat4& view_projection_matrix);
+        const Frustum& GetFrustum() const;
+
+        //////// BOUNDS TREE
+        // rebuilds the hierarchy from a box per item. centers and extents must be the same size
+        void Build(const std::vector<glm::vec3>& centers, const std::vector<glm::vec3>& extents);
+        size_t Size() const;
+
+        //////// CULLING
+        void Cull(std::vector<Uint8>& visibility_out, JobSystem* job_system = nullptr) const;
+
+    private:
+        //////// TYPES
+        struct Node {
+            glm::vec3 center = glm::vec3(0.0f);
+            glm::vec3 extent = glm::vec3(0.0f);
+            // children of inner nodes, 0 for leaves
+            Uint32 left = 0;
+            Uint32 right = 0;
+            // range of (padded) slots under this node
+            Uint32 slot_start = 0;
+            Uint32 slot_count = 0;
+        };
+
+        //////// CONSTANTS
+        // items per leaf, also the slot padding so a leaf is always a whole number of SIMD groups
+        static constexpr Uint32 LEAF_SIZE = 8;
+        // depth at which traversal is handed out to the job system
+        static constexpr int TASK_DEPTH = 5;
+        static constexpr Uint32 EMPTY_SLOT = std::numeric_limits<Uint32>::max();
+
+        //////// BASIC ATTRIBUTES
+        Frustum frustum;
+        size_t total_items = 0;
+
+        std::vector<Node> nodes = {};
+
+        // boxes in tree order, structure of arrays for SIMD. padding slots have a negative extent and never pass
+        std::vector<float> center_x = {};
+        std::vector<float> center_y = {};
+        std::vector<float> center_z = {};
+        std::vector<float> extent_x = {};
+        std::vector<float> extent_y = {};
+        std::vector<float> extent_z = {};
+        std::vector<Uint32> slot_items = {};
+
+        //////// BOUNDS TREE FUNCTIONS
+        Uint32 _BuildNode(std::vector<Uint32>& items, size_t start, size_t end, const std::vector<glm::vec3>& centers, const std::vector<glm::vec3>& extents);
+
+        //////// CULLING FUNCTIONS
+        void _CullNode(Uint32 node_index, std::vector<Uint8>& visibility_out) const;
+        void _CullLeaf(const Node& node, std::vector<Uint8>& visibility_out) const;
+        void _AcceptNode(const Node& node, std::vector<Uint8>& visibility_out) const;
+        void _CollectTasks(Uint32 node_index, int depth, std::vector<Uint32>& tasks_out, std::vector<Uint8>& visibility_out) const;
+};
+
+#endif // SRC_CULLER_H_
@@ -0,0 +1,225 @@
+#ifndef SRC_GLDISPATCH_H_
+#define SRC_GLDISPATCH_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+#include <initializer_list>
+
+#include <fstream>
+
+#include <SDL3/SDL.h>
+#include <GL/glew.h>
+
+#include "TotalFrame.h"
+#include "Util.h"
+
+/*
+ABOUT:
+Thin layer every OpenGL call goes through. It counts calls by type and bytes uploaded per frame, split by the subsystem making them, can record the command stream to a file, and can run on a null backend with no GPU.
+
+NOTES:
+Calls are named after the OpenGL function without the gl prefix, GLDispatch::DrawArrays() is glDrawArrays().
+Call EndFrame() once per frame (after swapping), GetLastFrameStats() and GetLastFrameSubsystems() then hold that frame's counts.
+Put a GLDispatch::Subsystem at the top of a scope to charge its calls to that subsystem, calls outside of one are charged to "other". Names must be string literals, only the pointer is kept.
+Recording writes one line per call: frame, subsystem, call and its scalar arguments (pointers are left out, uploads are recorded by size). Lines are buffered and written out in EndFrame().
+The null backend must be chosen before any call is made. It hands out fresh names from Gen and Create calls, reports shaders and programs as compiled and linked, and does nothing else, so the whole render path runs and can be timed without a context.
+Main thread only, like OpenGL itself.
+*/
+
+class GLDispatch {
+    public:
+        //////// TYPES
+        enum BACKEND {
+            OPENGL_BACKEND,
+            NULL_BACKEND
+        };
+
+        // one per wrapped function, in the same order as CALL_NAMES
+        enum CALL {
+            ACTIVE_TEXTURE,
+            ATTACH_SHADER,
+            BIND_BUFFER,
+            BIND_TEXTURE,
+            BIND_VERTEX_ARRAY,
+            BLEND_FUNC,
+            BUFFER_DATA,
+            BUFFER_SUB_DATA,
+            CLEAR,
+            CLEAR_COLOR,
+            COMPILE_SHADER,
+            CREATE_PROGRAM,
+            CREATE_SHADER,
+            CULL_FACE,
+            DELETE_BUFFERS,
+            DELETE_PROGRAM,
+            DELETE_SHADER,
+            DELETE_TEXTURES,
+            DELETE_VERTEX_ARRAYS,
+            DEPTH_FUNC,
+            DISABLE,
+            DRAW_ARRAYS,
+            DRAW_ARRAYS_INSTANCED,
+            ENABLE,
+            ENABLE_VERTEX_ATTRIB_ARRAY,
+            FRONT_FACE,
+            GEN_BUFFERS,
+            GEN_TEXTURES,
+            GEN_VERTEX_ARRAYS,
+            GENERATE_MIPMAP,
+            GET_ERROR,
+            GET_PROGRAM_IV,
+            GET_SHADER_IV,
+            GET_UNIFORM_LOCATION,
+            LINE_WIDTH,
+            LINK_PROGRAM,
+            PIXEL_STORE_I,
+            SHADER_SOURCE,
+            TEX_BUFFER,
+            TEX_IMAGE_2D,
+            TEX_PARAMETER_I,
+            UNIFORM_1F,
+            UNIFORM_1I,
+            UNIFORM_2FV,
+            UNIFORM_3FV,
+            UNIFORM_4F,
+            UNIFORM_MATRIX_3FV,
+            UNIFORM_MATRIX_4FV,
+            USE_PROGRAM,
+            VERTEX_ATTRIB_DIVISOR,
+            VERTEX_ATTRIB_I_POINTER,
+            VERTEX_ATTRIB_POINTER,
+            VIEWPORT,
+            TOTAL_CALLS
+        };
+
+        struct FrameStats {
+            std::array<Uint64, TOTAL_CALLS> calls = {};
+            Uint64 total_calls = 0;
+            Uint64 draw_calls = 0;
+            Uint64 bytes_uploaded = 0;
+        };
+
+        struct SubsystemStats {
+            const char* name = nullptr;
+            Uint64 total_calls = 0;
+            Uint64 bytes_uploaded = 0;
+        };
+
+        //////// SUBSYSTEMS
+        class Subsystem {
+            public:
+                explicit Subsystem(const char* name);
+                ~Subsystem();
+
+                Subsystem(const Subsystem&) = delete;
+                Subsystem& operator=(const Subsystem&) = delete;
+
+            private:
+                const char* previous = nullptr;
+        };
+
+        //////// BACKEND
+        static void SetBackend(BACKEND backend);
+        static BACKEND GetBackend();
+
+        //////// FRAMES
+        // closes the frame, its counts move to the last frame stats and recorded lines are written out
+        static void EndFrame();
+        static const FrameStats& GetLastFrameStats();
+        // subsystems in the order they first made a call that frame
+        static const std::vector<SubsystemStats>& GetLastFrameSubsystems();
+        static const char* GetCallName(CALL call);
+
+        //////// RECORDING
+        // false if the file could not be opened. a recording already running is stopped first
+        static bool StartRecording(const std::string& path);
+        static void StopRecording();
+        static bool IsRecording();
+
+        //////// CALLS
+        static void ActiveTexture(GLenum texture);
+        static void AttachShader(GLuint program, GLuint shader);
+        static void BindBuffer(GLenum target, GLuint buffer);
+        static void BindTexture(GLenum target, GLuint texture);
+        static void BindVertexArray(GLuint vertex_array);
+        static void BlendFunc(GLenum source_factor, GLenum destination_factor);
+        static void BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+        static void BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+        static void Clear(GLbitfield mask);
+        static void ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha);
+        static void CompileShader(GLuint shader);
+        static GLuint CreateProgram();
+        static GLuint CreateShader(GLenum type);
+        static void CullFace(GLenum mode);
+        static void DeleteBuffers(GLsizei count, const GLuint* buffers);
+        static void DeleteProgram(GLuint program);
+        static void DeleteShader(GLuint shader);
+        static void DeleteTextures(GLsizei count, const GLuint* textures);
+        static void DeleteVertexArrays(GLsizei count, const GLuint* vertex_arrays);
+        static void DepthFunc(GLenum function);
+        static void Disable(GLenum capability);
+        static void DrawArrays(GLenum mode, GLint first, GLsizei count);
+        static void DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instance_count);
+        static void Enable(GLenum capability);
+        static void EnableVertexAttribArray(GLuint index);
+        static void FrontFace(GLenum mode);
+        static void GenBuffers(GLsizei count, GLuint* buffers);
+        static void GenTextures(GLsizei count, GLuint* textures);
+        static void GenVertexArrays(GLsizei count, GLuint* vertex_arrays);
+        static void GenerateMipmap(GLenum target);
+        static GLenum GetError();
+        static void GetProgramiv(GLuint program, GLenum parameter, GLint* value);
+        static void GetShaderiv(GLuint shader, GLenum parameter, GLint* value);
+        static GLint GetUniformLocation(GLuint program, const GLchar* name);
+        static void LineWidth(GLfloat width);
+        static void LinkProgram(GLuint program);
+        static void PixelStorei(GLenum parameter, GLint value);
+        static void ShaderSource(GLuint shader, GLsizei count, const GLchar* const* sources, const GLint* lengths);
+        static void TexBuffer(GLenum target, GLenum internal_format, GLuint buffer);
+        static void TexImage2D(GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels);
+        static void TexParameteri(GLenum target, GLenum parameter, GLint value);
+        static void Uniform1f(GLint location, GLfloat x);
+        static void Uniform1i(GLint location, GLint x);
+        static void Uniform2fv(GLint location, GLsizei count, const GLfloat* value);
+        static void Uniform3fv(GLint location, GLsizei count, const GLfloat* value);
+        static void Uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w);
+        static void UniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+        static void UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+        static void UseProgram(GLuint program);
+        static void VertexAttribDivisor(GLuint index, GLuint divisor);
+        static void VertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer);
+        static void VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+        static void Viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+
+    private:
+        //////// BASIC ATTRIBUTES
+        static BACKEND backend;
+        static const char* subsystem;
+        // names handed out by the null backend
+        static GLuint next_null_name;
+
+        //////// FRAMES
+        static Uint64 frame;
+        static FrameStats frame_stats;
+        static FrameStats last_frame_stats;
+        static std::vector<SubsystemStats> frame_subsystems;
+        static std::vector<SubsystemStats> last_frame_subsystems;
+        static size_t last_subsystem_index;
+
+        //////// RECORDING
+        static std::ofstream recording_file;
+        static std::string recording_buffer;
+
+        //////// DISPATCH FUNCTIONS
+        // counts and records the call, true if it should reach OpenGL
+        static bool _Begin(CALL call, Uint64 bytes_uploaded, std::initializer_list<double> arguments);
+        static void _Record(CALL call, std::initializer_list<double> arguments);
+        static void _GenNullNames(GLsizei count, GLuint* names);
+        static Uint64 _GetPixelBytes(GLenum format, GLenum type);
+};
+
+#endif // SRC_GLDISPATCH_H_
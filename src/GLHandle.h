@@ -0,0 +1,91 @@
+#ifndef SRC_GLHANDLE_H_
+#define SRC_GLHANDLE_H_
+
+#pragma once
+
+#include <iostream>
+#include <utility>
+
+#include <SDL3/SDL.h>
+#include <GL/glew.h>
+
+#include "GLDispatch.h"
+
+/*
+ABOUT:
+Move-only owners of OpenGL object names: vertex arrays, buffers, textures and shader programs.
+The name is deleted when its owner is reset or destroyed, so copies (and the double frees that came with them) are compile errors.
+
+NOTES:
+Moving hands the name over and leaves the moved from handle empty (0). Empty handles never call OpenGL.
+Destroying or resetting a handle calls OpenGL, so reset them (FreeAll()) while the context is still alive.
+Get() returns the raw name for OpenGL calls, never delete it yourself.
+*/
+
+template <typename Traits>
+class GLHandle {
+    public:
+        GLHandle() = default;
+        // takes ownership of an existing name
+        explicit GLHandle(GLuint p_name) : name(p_name) {}
+        ~GLHandle() { Reset(); }
+
+        GLHandle(const GLHandle&) = delete;
+        GLHandle& operator=(const GLHandle&) = delete;
+
+        GLHandle(GLHandle&& other) noexcept : name(other.Release()) {}
+        GLHandle& operator=(GLHandle&& other) noexcept {
+            if (this != &other) Reset(other.Release());
+            return *this;
+        }
+
+        //////// BASIC FUNCTIONS
+        // deletes the current name (if any) and generates a new one
+        void Create() {
+            Reset(Traits::Create());
+        }
+        // deletes the current name (if any) and takes ownership of new_name
+        void Reset(GLuint new_name = 0) {
+            if (name != 0) Traits::Delete(name);
+            name = new_name;
+        }
+        // gives up ownership without deleting
+        GLuint Release() {
+            return std::exchange(name, 0);
+        }
+
+        GLuint Get() const { return name; }
+        explicit operator bool() const { return name != 0; }
+
+    private:
+        GLuint name = 0;
+};
+
+//////// TRAITS
+struct GLVertexArrayTraits {
+    static GLuint Create();
+    static void Delete(GLuint name);
+};
+
+struct GLBufferTraits {
+    static GLuint Create();
+    static void Delete(GLuint name);
+};
+
+struct GLTextureTraits {
+    static GLuint Create();
+    static void Delete(GLuint name);
+};
+
+struct GLProgramTraits {
+    static GLuint Create();
+    static void Delete(GLuint name);
+};
+
+//////// HANDLES
+using GLVertexArray = GLHandle<GLVertexArrayTraits>;
+using GLBuffer = GLHandle<GLBufferTraits>;
+using GLTexture = GLHandle<GLTextureTraits>;
+using GLProgram = GLHandle<GLProgramTraits>;
+
+#endif // SRC_GLHANDLE_H_
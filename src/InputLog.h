@@ -0,0 +1,144 @@
+#ifndef SRC_INPUTLOG_H_
+#define SRC_INPUTLOG_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <string>
+
+#include <fstream>
+
+#include <SDL3/SDL.h>
+
+#include <glm/glm.hpp>
+
+#include "TotalFrame.h"
+#include "Util.h"
+#include "Camera.h"
+
+/*
+ABOUT:
+Records the editor's input to a file and plays it back frame for frame, for repeatable benchmarks and correctness checks of editing sessions.
+
+NOTES:
+main() starts it from --record FILE or --replay FILE [--headless] [--report FILE], see ParseArguments().
+Use PollEvent() in place of SDL_PollEvent() and call EndFrame() once per loop iteration. Replayed events keep their frame, so everything that runs once per frame (camera movement) sees the same input it did.
+Event handling must only read the event itself (its coordinates and modifiers, not SDL_GetMouseState()), that is all a replay reproduces.
+Dialogs can't be replayed. Record what they returned with RecordLoad(), RecordNew() and RecordColor(), a replay returns it in the same place as a SDL_EVENT_USER event with an ACTION code and the dialog is skipped. Saving and exporting are skipped too.
+Each frame records the camera, the time since the last frame and the frame's own time. A replay compares the camera every frame and the object's hash (FNV-1a of its .tfobj_dev data) at the end, and reports recorded and replayed frame times and how long each session took in total (the delta times summed, a replay isn't paced so it's usually shorter).
+While replaying, real input is dropped apart from quitting.
+
+FORMAT:
+TFINPUT 1
+event TIMESTAMP_NS quit|mouse_down|mouse_up|mouse_motion|key_down|key_up FIELDS...
+action load PATH | action new | action color R G B
+frame DELTA_MS WORK_MS X Y Z YAW PITCH
+end OBJECT_HASH TOTAL_FRAMES
+*/
+
+class InputLog {
+    public:
+        InputLog() = default;
+        InputLog(const InputLog&) = delete;
+        InputLog& operator=(const InputLog&) = delete;
+
+        //////// TYPES
+        // codes of the SDL_EVENT_USER events a replay returns in place of a dialog
+        enum ACTION {
+            LOAD_ACTION,
+            NEW_ACTION,
+            COLOR_ACTION
+        };
+
+        struct Options {
+            std::string record_path = "";
+            std::string replay_path = "";
+            std::string report_path = "";
+            // replay without a window, on GLDispatch's null backend
+            bool headless = false;
+        };
+
+        //////// ARGUMENTS
+        // false on unknown or incomplete arguments
+        static bool ParseArguments(int argc, char* argv[], Options& options_out);
+
+        //////// BASIC FUNCTIONS
+        bool StartRecording(const std::string& path);
+        // report_path gets one line per frame, empty for none
+        bool StartReplay(const std::string& path, const std::string& report_path = "");
+        bool IsRecording() const;
+        bool IsReplaying() const;
+        // the replay has run every recorded frame
+        bool IsFinished() const;
+
+        //////// FRAMES
+        // SDL_PollEvent() that records while recording, returns the current frame's recorded events while replaying
+        bool PollEvent(SDL_Event& event_out);
+        // closes the frame, delta_time is the time since the last frame and work_time the frame's own time, in milliseconds
+        void EndFrame(const Camera::State& camera_state, double delta_time, double work_time);
+
+        //////// ACTIONS
+        void RecordLoad(const std::string& path);
+        void RecordNew();
+        void RecordColor(glm::vec3 color);
+        // of the last SDL_EVENT_USER event returned by PollEvent()
+        const std::string& GetActionPath() const;
+        glm::vec3 GetActionColor() const;
+
+        //////// FINISHING
+        // ends the recording with object_data's hash, or prints the replay's report. false if the replay didn't match the recording
+        bool Finish(const std::string& object_data);
+
+    private:
+        //////// TYPES
+        enum MODE {
+            OFF,
+            RECORDING,
+            REPLAYING
+        };
+
+        struct Entry {
+            SDL_Event event = {};
+            std::string action_path = "";
+            glm::vec3 action_color = glm::vec3(0.0f);
+        };
+
+        struct Frame {
+            std::vector<Entry> entries = {};
+            Camera::State camera_state;
+            double delta_time = 0.0;
+            double work_time = 0.0;
+        };
+
+        //////// BASIC ATTRIBUTES
+        MODE mode = OFF;
+
+        //////// RECORDING
+        std::ofstream record_file;
+        size_t total_recorded_frames = 0;
+
+        //////// REPLAYING
+        std::vector<Frame> frames = {};
+        Uint64 recorded_hash = 0;
+        size_t replay_frame = 0;
+        size_t replay_entry = 0;
+        const Entry* current_entry = nullptr;
+
+        std::string report_path = "";
+        std::vector<double> replay_times = {};
+        std::vector<double> replay_delta_times = {};
+        size_t total_camera_mismatches = 0;
+        size_t first_camera_mismatch = SIZE_MAX;
+
+        //////// PARSING FUNCTIONS
+        void _WriteEvent(const SDL_Event& event);
+        // frame collects entries until its frame line, which moves it to frames
+        bool _ParseLine(const std::string& line, Frame& frame, bool& ended_out);
+
+        //////// REPORT FUNCTIONS
+        static Uint64 _Hash(const std::string& data);
+        static bool _CameraMatches(const Camera::State& a, const Camera::State& b);
+};
+
+#endif // SRC_INPUTLOG_H_
@@ -0,0 +1,104 @@
+#ifndef SRC_JOBSYSTEM_H_
+#define SRC_JOBSYSTEM_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <functional>
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+#include "TotalFrame.h"
+#include "Util.h"
+#include "Profiler.h"
+
+/*
+ABOUT:
+Long-lived work-stealing thread pool shared by every subsystem of the app.
+
+NOTES:
+Create ONE JobSystem in main and pass a pointer to anything that wants to run work in parallel (Object, exporters, loaders).
+Each worker owns a queue, pops its own work from the back and steals from the front of the other queues when empty.
+The thread that calls ParallelFor() or Wait() helps run jobs until its work is done, so nested ParallelFor() calls from inside a job are safe.
+grain_size controls how many items a single job processes. Small ranges are run inline without touching the queues.
+*/
+
+class JobSystem {
+    public:
+        // thread_count = 0 uses hardware_concurrency() - 1 workers (the calling thread is the last worker)
+        JobSystem(unsigned int thread_count = 0);
+        ~JobSystem();
+
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+
+        //////// TYPES
+        using RangeFunction = std::function<void(size_t start, size_t end)>;
+
+        // counts the unfinished jobs of a submission. Wait() on it to join
+        struct Counter {
+            std::atomic<size_t> pending{0};
+        };
+
+        //////// BASIC FUNCTIONS
+        // number of threads that run jobs, including the calling thread
+        unsigned int ThreadCount();
+
+        //////// JOB FUNCTIONS
+        // queues a single job. if counter is given, it is incremented now and decremented when the job finishes
+        void Submit(std::function<void()> job, Counter* counter = nullptr);
+        // blocks until counter reaches zero, running queued jobs in the meantime
+        void Wait(Counter& counter);
+
+        // splits [0, count) into ranges of at most grain_size items and runs them on all threads. returns when every range is done
+        void ParallelFor(size_t count, size_t grain_size, const RangeFunction& function);
+        // chooses a grain size that gives every thread a few ranges to balance uneven work
+        size_t DefaultGrainSize(size_t count, size_t min_grain_size = 64);
+
+    private:
+        //////// TYPES
+        struct Job {
+            std::function<void()> function = nullptr;
+            // range jobs point at the caller's function instead of copying it
+            const RangeFunction* range_function = nullptr;
+            size_t start = 0;
+            size_t end = 0;
+            Counter* counter = nullptr;
+        };
+
+        struct WorkerQueue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        //////// BASIC ATTRIBUTES
+        std::vector<std::unique_ptr<WorkerQueue>> queues = {};
+        std::vector<std::thread> threads = {};
+
+        std::atomic<bool> running{true};
+        // total jobs sitting in queues, used to put idle workers to sleep
+        std::atomic<size_t> queued_jobs{0};
+        std::atomic<size_t> next_queue{0};
+
+        std::mutex wake_mutex;
+        std::condition_variable wake_condition;
+
+        //////// JOB FUNCTIONS
+        void _Push(Job job);
+        bool _Pop(size_t queue_index, Job& job_out);
+        bool _Steal(size_t queue_index, Job& job_out);
+        bool _TryRunOne(size_t queue_index);
+        void _Run(Job& job);
+
+        //////// WORKER FUNCTIONS
+        void _WorkerLoop(size_t queue_index);
+        size_t _CurrentQueue();
+};
+
+#endif // SRC_JOBSYSTEM_H_
@@ -0,0 +1,103 @@
+#ifndef SRC_LATENCYTRACKER_H_
+#define SRC_LATENCYTRACKER_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+
+#include <fstream>
+
+#include <SDL3/SDL.h>
+
+#include "TotalFrame.h"
+#include "Util.h"
+
+/*
+ABOUT:
+Measures input to display latency, from an SDL event's timestamp to the buffer swap that shows its effect, for hovering, placing and destroying.
+
+NOTES:
+Begin() tags an input with its event's timestamp when it is handled. Mark() the end of each stage of the frame in order, then call EndFrame() once per loop iteration.
+A frame that swapped closes every tagged input with the time split into stages: waiting to be handled, the rest of event handling (including the edit), picking, rendering (including rebuilds) and the swap itself. A frame that didn't swap showed nothing, its inputs are dropped.
+Several events of a kind in one frame (mouse motion) count once, from the oldest, the latency of the first of them.
+Times are SDL_GetTicksNS(), the clock event timestamps are on. Does nothing while disabled.
+*/
+
+class LatencyTracker {
+    public:
+        //////// TYPES
+        enum KIND {
+            HOVER,
+            PLACE,
+            DESTROY,
+            TOTAL_KINDS
+        };
+
+        // the end of each, in frame order
+        enum STAGE {
+            INPUT,
+            EVENTS,
+            PICK,
+            RENDER,
+            PRESENT,
+            TOTAL_STAGES
+        };
+
+        //////// CONSTANTS
+        // upper bounds in milliseconds, the last bucket takes everything above
+        static constexpr std::array<double, 10> BUCKET_BOUNDS = {1.0, 2.0, 4.0, 8.0, 12.0, 16.7, 25.0, 33.3, 50.0, 100.0};
+        // samples kept per kind for percentiles
+        static constexpr size_t MAX_SAMPLES = size_t(1) << 16;
+
+        //////// BASIC FUNCTIONS
+        // enabling clears the previous measurement
+        void SetEnabled(bool enabled);
+        bool IsEnabled() const;
+
+        //////// MEASURING
+        // event_timestamp is the event's SDL timestamp, the time it is handled ends its INPUT stage
+        void Begin(KIND kind, Uint64 event_timestamp);
+        // the input turned out to change nothing (a click that hit no cube)
+        void Cancel(KIND kind);
+        // ends stage for this frame, INPUT is set by Begin()
+        void Mark(STAGE stage);
+        void EndFrame();
+
+        //////// REPORTING
+        // percentiles, mean stage times and a histogram per kind. false if the file could not be opened
+        bool WriteReport(const std::string& path) const;
+
+    private:
+        //////// TYPES
+        struct Pending {
+            bool active = false;
+            Uint64 event_time = 0;
+            Uint64 handled_time = 0;
+        };
+
+        struct Measurement {
+            std::vector<float> samples = {};
+            size_t total_samples = 0;
+            std::array<size_t, BUCKET_BOUNDS.size() + 1> buckets = {};
+            // nanoseconds, for the means
+            std::array<double, TOTAL_STAGES> stage_totals = {};
+        };
+
+        //////// BASIC ATTRIBUTES
+        bool enabled = false;
+
+        //////// MEASURING
+        std::array<Pending, TOTAL_KINDS> pending = {};
+        // 0 for stages the frame hasn't reached
+        std::array<Uint64, TOTAL_STAGES> stage_ends = {};
+        std::array<Measurement, TOTAL_KINDS> measurements = {};
+
+        //////// REPORTING
+        static const char* _GetKindName(KIND kind);
+        static const char* _GetStageName(STAGE stage);
+};
+
+#endif // SRC_LATENCYTRACKER_H_
@@ -0,0 +1,144 @@
+#ifndef SRC_LOGGER_H_
+#define SRC_LOGGER_H_
+
+#pragma once
+
+#include <iostream>
+#include <array>
+#include <string>
+#include <string_view>
+
+#include <atomic>
+#include <thread>
+#include <mutex>
+#include <ctime>
+
+#include <SDL3/SDL.h>
+
+/*
+ABOUT:
+Asynchronous logging. Messages go into a lock-free ring buffer and a background thread formats and writes them to stdout, so logging never waits on the console.
+
+NOTES:
+Log with the macros, TF_LOG_ERROR("UPPER MSG", "Class::Function"), TF_LOG_WARNING(...), TF_LOG_INFO("UPPER MSG") and TF_LOG_DEBUG(...).
+Levels below TF_LOG_LEVEL (0 debug, 1 info, 2 warning, 3 error, 4 none) compile to nothing, message included. Build with make LOG_LEVEL=N, everything is kept by default.
+Every call site passes RATE_LIMIT_MESSAGES messages per RATE_LIMIT_WINDOW milliseconds, the rest are counted and the next message that passes reports how many were suppressed.
+Any thread can log. Messages are copied into fixed size slots (TEXT_SIZE, longer ones are cut), and dropped and counted when the buffer is full instead of blocking.
+The writer starts with the first message and is stopped (after writing everything left) at exit. Messages after Stop() are written directly, and one that was queued while Stop() ran is drained by the thread that logged it.
+Output printed with printf() can overtake queued messages, call Flush() first when the order matters (the headless and replay results do).
+Only includes std and SDL, Util.h includes it.
+*/
+
+#ifndef TF_LOG_LEVEL
+#define TF_LOG_LEVEL 0
+#endif
+
+#define TF_LOG(level, message, function) do { static Logger::CallSite tf_log_site; Logger::Write(level, tf_log_site, message, function); } while (0)
+
+#if TF_LOG_LEVEL <= 0
+#define TF_LOG_DEBUG(message) TF_LOG(Logger::DEBUG_LEVEL, message, "")
+#else
+#define TF_LOG_DEBUG(message) ((void)0)
+#endif
+
+#if TF_LOG_LEVEL <= 1
+#define TF_LOG_INFO(message) TF_LOG(Logger::INFO_LEVEL, message, "")
+#else
+#define TF_LOG_INFO(message) ((void)0)
+#endif
+
+#if TF_LOG_LEVEL <= 2
+#define TF_LOG_WARNING(message, function) TF_LOG(Logger::WARNING_LEVEL, message, function)
+#else
+#define TF_LOG_WARNING(message, function) ((void)0)
+#endif
+
+#if TF_LOG_LEVEL <= 3
+#define TF_LOG_ERROR(message, function) TF_LOG(Logger::ERROR_LEVEL, message, function)
+#else
+#define TF_LOG_ERROR(message, function) ((void)0)
+#endif
+
+class Logger {
+    public:
+        //////// TYPES
+        enum LEVEL {
+            DEBUG_LEVEL,
+            INFO_LEVEL,
+            WARNING_LEVEL,
+            ERROR_LEVEL
+        };
+
+        // one per TF_LOG call site, for rate limiting
+        struct CallSite {
+            std::atomic<Uint64> window_start{0};
+            std::atomic<Uint32> window_messages{0};
+            std::atomic<Uint32> suppressed_messages{0};
+        };
+
+        //////// CONSTANTS
+        // slots in the ring buffer, a power of two
+        static constexpr size_t QUEUE_MESSAGES = 1024;
+        static constexpr size_t TEXT_SIZE = 240;
+        static constexpr size_t FUNCTION_SIZE = 64;
+        static constexpr Uint32 RATE_LIMIT_MESSAGES = 10;
+        static constexpr Uint64 RATE_LIMIT_WINDOW = 1000;
+        // how long the writer sleeps when the buffer is empty
+        static constexpr Uint32 IDLE_SLEEP = 5;
+
+        //////// LOGGING
+        // use the TF_LOG macros instead
+        static void Write(LEVEL level, CallSite& site, std::string_view message, std::string_view function);
+
+        //////// WRITER
+        // waits until every message logged before the call is written
+        static void Flush();
+        // writes everything still queued and ends the writer thread, called at exit
+        static void Stop();
+
+    private:
+        //////// TYPES
+        struct Message {
+            LEVEL level = DEBUG_LEVEL;
+            std::time_t time = 0;
+            Uint32 suppressed_messages = 0;
+            char function[FUNCTION_SIZE] = {};
+            char text[TEXT_SIZE] = {};
+        };
+
+        // sequence is the write position the slot waits for, + 1 once written
+        struct Slot {
+            std::atomic<Uint64> sequence{0};
+            Message message;
+        };
+
+        //////// QUEUE
+        static std::array<Slot, QUEUE_MESSAGES> queue;
+        static std::atomic<Uint64> write_position;
+        // only read by the writer, or under drain_mutex once stopped
+        static Uint64 read_position;
+        // read_position as of the last output, for Flush()
+        static std::atomic<Uint64> written_position;
+        static std::atomic<Uint64> dropped_messages;
+
+        //////// WRITER
+        static std::thread writer;
+        static std::atomic<bool> stop_requested;
+        static std::atomic<bool> stopped;
+        // held by Stop() from setting stopped until its last drain, and by every drain after it
+        static std::mutex drain_mutex;
+
+        //////// PRIVATE FUNCTIONS
+        static void _Start();
+        // false once the message is suppressed, suppressed_out is how many were since the last one passed
+        static bool _PassRateLimit(CallSite& site, Uint32& suppressed_out);
+        static void _WriterLoop();
+        // formats every queued message into out, returns how many
+        static size_t _Drain(std::string& out);
+        // drains, writes and moves written_position up, the writer's loop and (under drain_mutex) everything after Stop()
+        static size_t _DrainAndOutput(std::string& text);
+        static void _Format(const Message& message, std::string& out);
+        static void _Output(const std::string& text);
+};
+
+#endif // SRC_LOGGER_H_
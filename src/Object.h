@@ -12,17 +12,30 @@
 #include <algorithm>
 
 #include <string>
+#include <cstring>
+#include <cstdlib>
 
 #include <SDL3/SDL.h>
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
-#include <thread>
-#include <future>
+#include <mutex>
+#include <atomic>
 
 #include "TotalFrame.h"
 #include "Util.h"
+#include "Profiler.h"
 #include "Cube.h"
+#include "CubeTemplate.h"
+#include "JobSystem.h"
+#include "Culler.h"
+#include "OcclusionCuller.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
+#include "Arena.h"
+#include "VoxelChunks.h"
+#include "VoxelOctree.h"
+#include "OccupancyGrid.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/ext.hpp"
@@ -34,12 +47,18 @@ Handles the creation, updating and rendering of Cubes
 NOTES:
 You can create cubes directly using object.Create() (preferred method).
 Ensure you link the CameraHandler's view_projection_matrix to cube
-Ensure you call UpdateAndRenderAll(), along with CameraHandler::UpdateShaderPrograms(GetShaderProgramsUpdates()) for proper results in rendering and handling Objects.
+Ensure you call UpdateAndRenderAll(), along with CameraHandler::UpdateShaderPrograms(GetShaderProgramsUpdates()) for proper results in rendering and handling Objects. Call UpdateAll() and RenderAll() separately to update the shader programs in between.
+Cubes are stored as TotalFrame::CubeRecord (position, color, template index) over CubeTemplates shared by identical cubes. The VoxelOctree, OccupancyGrid and VoxelChunks are built from those records (the octree is only a picking index), so memory grows with the number of cubes, not with the space they occupy.
+Call SaveLatticeIndex() after saving the object's data, ClearAndCreate() then reads the index back from the file next to it and only checks it against the cubes instead of inserting every one.
+Cubes are drawn from the records in a buffer texture, so their shader programs must be cube.vert compatible.
+Pass the app's JobSystem to run updating, picking, exporting, loading and bulk edits on its workers. Without one, everything runs on the calling thread.
+The first cube sets the lattice. Only cubes of its size sitting on it are indexed, and only those are touched by Hollow() and the bulk edits (FillBox(), HollowBox(), EraseBox(), PasteRegion(), FloodFill()).
+PasteRegion() only takes a Clipboard copied from this object since its last ClearAndCreate().
 */
 
 class Object {
     public:
-        Object(TotalFrame::OBJECT_TYPE type, float aspect_ratio);
+        Object(TotalFrame::OBJECT_TYPE type, float aspect_ratio, JobSystem* job_system = nullptr);
         void FreeAll();
 
         //////// BASIC ATTRIBUTES
@@ -48,23 +67,77 @@ class Object {
 
         //////// BASIC
         void UpdateAndRenderAll(glm::mat4 camera_view_projection_matrix, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights);
-        void UpdateAndRender(Cube cube, glm::mat4 camera_view_projection_matrix, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights);
+        // culls and updates every cube and flags the shader programs that need updated, draws nothing
+        void UpdateAll(const glm::mat4& camera_view_projection_matrix, glm::vec3 camera_position);
+        // draws the cubes found visible by the last UpdateAll()
+        void RenderAll(glm::vec3 camera_position, const std::vector<std::shared_ptr<TotalFrame::Light>>& lights);
+        void UpdateAndRender(Cube& cube, glm::mat4 camera_view_projection_matrix, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights);
 
         std::string GetData();
+        // writes the lattice index next to the object saved at object_path, ClearAndCreate() reads it back instead of indexing every cube again. false if it could not be written
+        bool SaveLatticeIndex(const std::string& object_path) const;
+        // serializes the lattice index, reads it back into a new tree and compares every cell, false on any difference
+        bool CheckLatticeIndex();
 
         //////// EXPORTATION
         std::string GetExportData();
 
         //////// CUBE CREATION
-        // creates a cube
+        // creates a cube. name is only kept by standalone Cubes
         void Create(std::string name, glm::vec3 position, float size, std::string obj_path, GLuint shader_program, std::string object_data_str = "");
         void CreateLight(std::shared_ptr<TotalFrame::Light> light, std::string name, glm::vec3 position, float size, std::string obj_path, GLuint shader_program, std::string object_data_str = "");
         void ClearAndCreate(std::string name, glm::vec3 position, float size, std::string obj_path, GLuint shader_program);
-        // adds a pre-created cube
-        void Add(Cube cube);
+        // adds a copy of a pre-created cube
+        void Add(Cube& cube);
+
+        //////// CUBE ACCESS
+        size_t GetTotalCubes() const;
+        const TotalFrame::CubeRecord& GetCube(size_t index) const;
+        // position of a cube, (0, 0, 0) for an invalid index
+        glm::vec3 GetCubePosition(size_t index) const;
+        // color of the cube's first triangle, (-1000, -1000, -1000) for an invalid index
+        glm::vec3 GetCubeColor(size_t index) const;
+        float GetCubeSize(size_t index) const;
+        // bit per TotalFrame::FACE, set when a cube sits right across that face. only lattice cubes have neighbors, 0 otherwise
+        Uint8 GetCubeNeighbors(size_t index) const;
+
+        //////// CUBE COLORING
+        // recolors cubes in place, the changed records are uploaded together before the next draw
+        void SetCubeColor(size_t index, glm::vec3 color);
+        void SetCubesColor(const std::vector<size_t>& indices, glm::vec3 color);
 
         //////// CUBE DESTRUCTION
-        void Destory(Cube* cube);
+        void Destory(size_t index);
+
+        //////// BULK EDITING
+        // boxes are the lattice cells between two cube centers (inclusive), given in any order
+        // each edit adds or removes all of its cubes at once, so records, bounds and chunk meshes are rebuilt once for the whole batch
+        struct Clipboard {
+            // cells relative to the copied box's lowest corner
+            std::vector<glm::ivec3> cells = {};
+            std::vector<Uint32> template_indices = {};
+            std::vector<Uint32> colors = {};
+            // templates are only valid for the object they were copied from, until it is cleared. 0 matches no object
+            Uint32 template_generation = 0;
+        };
+
+        // fills every empty cell of the box with a copy of cube, returns the cubes added
+        size_t FillBox(glm::vec3 corner_a, glm::vec3 corner_b, Cube& cube);
+        // same as FillBox() but only the outer layer of the box
+        size_t HollowBox(glm::vec3 corner_a, glm::vec3 corner_b, Cube& cube);
+        // removes every lattice cube in the box, returns the cubes removed
+        size_t EraseBox(glm::vec3 corner_a, glm::vec3 corner_b);
+        Clipboard CopyRegion(glm::vec3 corner_a, glm::vec3 corner_b) const;
+        // pastes with the copied box's lowest corner at the cell of position, skipping filled cells. returns the cubes added
+        size_t PasteRegion(const Clipboard& clipboard, glm::vec3 position);
+        // recolors the lattice cube and every cube of the same color connected to it through faces, returns the cubes recolored
+        size_t FloodFill(size_t index, glm::vec3 color);
+
+        //////// HOLLOWING
+        // removes the lattice cubes with no path to the outside (hidden behind other cubes on every side), returns the cubes removed
+        size_t Hollow();
+        // hollows every object loaded by ClearAndCreate(), toggled with F9 in the editor. the removed cubes are gone from saves too
+        bool hollow_on_load = false;
 
         //////// TRANSLATION
         void Rotate(glm::vec3 rotation, glm::vec3 camera_position);
@@ -72,44 +145,273 @@ class Object {
 
         //////// SHADER PROGRAMS
         // updates a shader program if it needs updated
-        void UpdateSP(Cube cube, bool is_visible);
+        // main thread only. the parallel update in UpdateAndRenderAll() collects dirty programs itself
+        void UpdateSP(const Cube& cube, bool is_visible);
         // returns all shader programs that need updated
         std::vector<GLuint> GetShaderProgramsUpdates();
 
         //////// CAMERA SCALING
-        void UpdateCubeCameraScale(Cube cube, glm::vec3 camera_position, bool is_visible);
+        // updates a standalone cube's OBB in place
+        void UpdateCubeCameraScale(Cube& cube, glm::vec3 camera_position, bool is_visible);
 
         //////// RAYS
-        Cube GetRayCollidingCube(TotalFrame::Ray ray);
-        Cube GetRayCollidingCubeWithFace(TotalFrame::Ray ray, glm::vec3& face_hit_normal_out);
-        Cube* GetRayCollidingCubeWithFacePtr(TotalFrame::Ray ray, glm::vec3& face_hit_normal_out);
-        std::vector<std::shared_ptr<Cube>> GetRayCollidingCubes(TotalFrame::Ray ray);
+        // index of the closest cube hit by the ray, SIZE_MAX if none
+        size_t GetRayCollidingCube(TotalFrame::Ray ray);
+        size_t GetRayCollidingCubeWithFace(TotalFrame::Ray ray, glm::vec3& face_hit_normal_out);
+        std::vector<size_t> GetRayCollidingCubes(TotalFrame::Ray ray);
+        // milliseconds the last GetRayCollidingCube() or GetRayCollidingCubeWithFace() took
+        double GetLastPickTime() const;
 
         //////// LIGHTING
         void AttachLight(std::shared_ptr<TotalFrame::Light> light);
 
+        //////// CULLING
+        struct CullStats {
+            size_t total_cubes = 0;
+            size_t frustum_visible_cubes = 0;
+            size_t occlusion_visible_cubes = 0;
+        };
+
+        // hides cubes covered by nearer, larger cubes. only kicks in once enough cubes pass frustum culling
+        bool occlusion_culling_enabled = true;
+
+        // counts from the last UpdateAndRenderAll()
+        CullStats GetCullStats() const;
+
         //////// RENDERING
-        // renders an cube if it is in view
-        void Render(Cube cube, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights, bool is_visible);
+        // draws issued by the last RenderAll()
+        TotalFrame::RenderStats GetRenderStats() const;
+
+        // renders a standalone cube if it is in view
+        void Render(Cube& cube, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights, bool is_visible);
 
     private:
+        //////// RAY FUNCTIONS
+        // index of the closest cube hit by ray, SIZE_MAX if none
+        size_t _GetClosestRayHit(TotalFrame::Ray ray, bool with_face, glm::vec3& face_hit_normal_out);
+        // slab test against the cube's stretched box. the face normal is half an axis, as BlockCursor expects
+        bool _RayCollides(const TotalFrame::CubeRecord& cube, TotalFrame::Ray ray, bool with_face, float& tmin_out, glm::vec3& face_hit_normal_out) const;
+
         //////// FILE READING FUNCTIONS
+        struct CubeSlice {
+            // byte range of the cube in the file
+            size_t start = 0;
+            size_t end = 0;
+            // non empty lines past the position, an upper bound on its triangles
+            Uint32 max_triangles = 0;
+            // where its packed vertices go
+            Uint32 first_vertex = 0;
+        };
+
         std::string _ReadData(std::string path);
-        std::vector<std::string> _SplitByCube(std::string cube_data);
+        // reads the whole file into the arena, nullptr if it does not exist
+        const char* _ReadData(std::string path, Arena& arena, size_t& size_out);
+        CubeSlice* _SplitByCube(const char* object_data, size_t object_data_size, Arena& arena, size_t& total_cubes_out);
+        // values of the 18 float lines go to triangles_values_out, other lines are skipped
+        static bool _ParseCube(const char* start, const char* end, glm::vec3& position_out, std::vector<GLfloat>& triangles_values_out, size_t& total_triangles_out);
 
         //////// BASIC ATTRIBUTES
-        std::vector<Cube> cubes = {};
-        // groups cubes by which shader program they use
-        std::unordered_map<GLuint, std::vector<Cube>> shader_program_groups = {};
+        std::vector<TotalFrame::CubeRecord> cubes = {};
         // says which shader_programs need to be updated
         std::unordered_map<GLuint, bool> shader_programs_need_update = {};
 
+        //////// TEMPLATES
+        std::vector<CubeTemplate> cube_templates = {};
+        // CubeTemplate::GetHash() -> index in cube_templates
+        std::unordered_multimap<Uint64, Uint32> template_lookup = {};
+
+        // returns the index of an identical template, adding this one if there is none
+        Uint32 _AddTemplate(CubeTemplate& cube_template);
+        // index of an identical template, UINT32_MAX if there is none
+        Uint32 _FindTemplate(Uint64 hash, const TotalFrame::PackedVertex* vertices, size_t total_vertices, float size, float position_scale, GLuint shader_program) const;
+        void _AddCube(const TotalFrame::CubeData& data, glm::vec3 position, float size, GLuint shader_program);
+        // template of the parsed cube, UINT32_MAX if it has no triangles
+        Uint32 _AddCubeTemplate(const TotalFrame::CubeData& data, float size, GLuint shader_program, Uint32& color_out);
+        void _GetCubeBounds(const TotalFrame::CubeRecord& cube, glm::vec3& center_out, glm::vec3& extent_out) const;
+        static Uint32 _PackColor(glm::vec3 color);
+        static glm::vec3 _UnpackColor(Uint32 color);
+
+        //////// EXPORTATION FUNCTIONS
+        // true if the ray passes by a corner of the box (other than ignore_point)
+        static bool _RayCollidesWithCorners(TotalFrame::Ray ray, glm::vec3 center, float size, glm::vec3 ignore_point);
+
+        //////// RENDERING
+        struct ProgramUniforms {
+            GLint model_matrix = -1;
+            GLint cube_color = -1;
+            GLint normal_matrix = -1;
+            GLint instanced = -1;
+            GLint cube_records = -1;
+            GLint vertex_scale = -1;
+            GLint stretch = -1;
+            GLint light_position = -1;
+            GLint light_intensity = -1;
+            GLint view_position = -1;
+        };
+        std::unordered_map<GLuint, ProgramUniforms> program_uniforms = {};
+
+        // outline of a cube with corners at +-1, shared by every cube
+        GLVertexArray lines_vertex_array;
+        GLBuffer lines_vertex_buffer;
+        static constexpr GLsizei TOTAL_LINE_VERTICES = 24;
+
+        const ProgramUniforms& _GetProgramUniforms(GLuint shader_program);
+        void _BuildLines();
+        void _RenderLinesInstanced(size_t first_instance, size_t total_instances);
+
+        //////// INSTANCING
+        // texture unit the record buffer texture is bound to while drawing
+        static constexpr GLint RECORDS_TEXTURE_UNIT = 1;
+        // dirty records closer than this are uploaded in one range, rewriting the clean ones between them
+        static constexpr size_t RECORD_MERGE_GAP = 64;
+
+        // cubes as is, read by cube.vert through records_texture
+        GLBuffer records_buffer;
+        GLTexture records_texture;
+        size_t records_capacity = 0;
+        // set whenever cubes are added, removed or moved so every record is uploaded again
+        bool records_dirty = true;
+        // records changed in place since the last upload
+        std::vector<Uint32> dirty_records = {};
+
+        // visible cube indices grouped by template, rebuilt every frame
+        GLBuffer visible_buffer;
+        std::vector<Uint32> visible_stream = {};
+        // template -> first entry in visible_stream, one extra at the end
+        std::vector<Uint32> template_offsets = {};
+        // template -> visible cubes that are not voxels, they come first in its part of visible_stream
+        std::vector<Uint32> template_instanced_counts = {};
+
+        // template -> the same geometry in white, for recoloring many colored cubes. UINT32_MAX until needed
+        std::vector<Uint32> white_templates = {};
+
+        void _BuildRecords();
+        void _UploadRecords();
+        void _BuildVisibleStream();
+        Uint32 _GetWhiteTemplate(Uint32 template_index);
+
+        //////// LATTICE
+        // furthest lattice cell from the origin a cube may sit in
+        static constexpr int LATTICE_MAX_CELL = 1 << 20;
+        // cube_lattice_flags bits
+        static constexpr Uint8 LATTICE_CUBE = 1;
+        static constexpr Uint8 VOXEL_CUBE = 2;
+        // lattice index file, the object's path with this appended
+        static constexpr const char* LATTICE_INDEX_EXTENSION = ".tfoct";
+        static constexpr Uint32 LATTICE_INDEX_MAGIC = 0x494C4654; // "TFLI"
+
+        // cell centers are lattice_origin + cell * lattice_cell_size
+        bool lattice_set = false;
+        glm::vec3 lattice_origin = glm::vec3(0.0f);
+        float lattice_cell_size = 0.0f;
+        GLuint lattice_shader_program = 0;
+        // per cube, LATTICE_CUBE if it is in lattice_tree, VOXEL_CUBE if it is also drawn from voxels
+        std::vector<Uint8> cube_lattice_flags = {};
+        // lattice cell -> lowest index of the cubes in it
+        VoxelOctree lattice_tree;
+        // the same cells bit-packed, for neighbor and morphology queries
+        OccupancyGrid lattice_occupancy;
+        // cubes off the lattice, rebuilt for picking after the flags change
+        std::vector<Uint32> loose_cubes = {};
+        bool loose_cubes_dirty = true;
+
+        VoxelChunks voxels;
+        // template -> 0 not checked yet, 1 white box, 2 box of any other color, 3 anything else
+        std::vector<Uint8> box_templates = {};
+
+        // unique across every object, replaced whenever the templates are cleared, see Clipboard
+        static std::atomic<Uint32> total_template_generations;
+        Uint32 template_generation = Object::_NewTemplateGeneration();
+
+        static Uint32 _NewTemplateGeneration();
+
+        // white boxes, the ones voxels can draw
+        bool _IsBoxTemplate(Uint32 template_index);
+        // any box filling its cell
+        bool _IsSolidTemplate(Uint32 template_index);
+        void _CheckBoxTemplate(Uint32 template_index);
+        void _SetLattice(glm::vec3 origin, float cell_size, GLuint shader_program);
+        // lattice cell of the cube, false if it is off the lattice or another size
+        bool _GetLatticeCell(const TotalFrame::CubeRecord& cube, glm::ivec3& cell_out) const;
+        // puts the cube in the lattice tree (and the voxels) if it can be, setting the lattice if there is none yet
+        void _SetLatticeCube(size_t index);
+        // keep_tree reuses a lattice_tree read by _LoadLatticeIndex(), it is checked against the cubes and rebuilt if it does not match
+        void _RebuildLattice(bool keep_tree = false);
+        // reads the lattice index saved with the object into lattice_tree, false if there is none or it is for other cubes
+        bool _LoadLatticeIndex(const std::string& object_path);
+        // true if every cell of lattice_tree holds a lattice cube in that cell and every occupied cell is in it
+        bool _LatticeTreeMatches();
+        // nearest lattice cell to a position, false if there is no lattice or it is past LATTICE_MAX_CELL
+        bool _GetNearestLatticeCell(glm::vec3 position, glm::ivec3& cell_out) const;
+        void _RenderVoxels(glm::vec3 camera_position, const std::vector<std::shared_ptr<TotalFrame::Light>>& lights, glm::vec3 stretch, const glm::mat3& normal_matrix);
+
+        //////// BULK EDITING FUNCTIONS
+        // most cells a single bulk edit may cover
+        static constexpr size_t BULK_MAX_CELLS = size_t(1) << 24;
+
+        struct LatticeCube {
+            glm::ivec3 cell = glm::ivec3(0);
+            Uint32 template_index = 0;
+            Uint32 color = 0xFFFFFFFF;
+        };
+
+        // sets the lattice from the template if there is none, false if the template is not the lattice's size
+        bool _PrepareBulkTemplate(glm::vec3 corner, const CubeTemplate& cube_template);
+        // box of two corners, false if either is off the lattice or the box is past BULK_MAX_CELLS
+        bool _GetBulkBox(glm::vec3 corner_a, glm::vec3 corner_b, glm::ivec3& min_cell_out, glm::ivec3& max_cell_out) const;
+        size_t _FillBox(glm::vec3 corner_a, glm::vec3 corner_b, Cube& cube, bool hollow);
+        // appends the cubes whose cells are empty in one go, returns how many were added. cells must be distinct, runs of cubes in one chunk are indexed together
+        // a new_template is only added if some cube is, and every added cube then uses it instead of its template_index
+        size_t _AddLatticeCubes(const std::vector<LatticeCube>& new_cubes, CubeTemplate* new_template = nullptr);
+        // erases every flagged cube in one compaction, returns how many were removed
+        size_t _RemoveCubes(const std::vector<Uint8>& remove);
+
+        //////// CULLING
+        Culler culler;
+        // set whenever cubes are added, removed or moved so the bounds tree is rebuilt before the next cull
+        bool bounds_dirty = true;
+        // world space bounds per cube, kept from the last rebuild for the occlusion pass
+        std::vector<glm::vec3> cube_centers = {};
+        std::vector<glm::vec3> cube_extents = {};
+        // solid lattice cubes merged into rows and slabs of touching cells, rebuilt with the bounds. the occlusion culler never counts the seam between two occluders as covered
+        std::vector<glm::vec3> merged_occluder_centers = {};
+        std::vector<glm::vec3> merged_occluder_extents = {};
+
+        OcclusionCuller occlusion_culler;
+        // below this many frustum visible cubes the occlusion pass costs more than it saves
+        static constexpr size_t OCCLUSION_MIN_CUBES = 256;
+        // most occluders rasterized per frame, picked by size over distance
+        static constexpr size_t OCCLUDER_BUDGET = 512;
+        std::vector<size_t> visible_indices = {};
+        CullStats cull_stats;
+        TotalFrame::RenderStats render_stats;
+        double last_pick_time = 0.0;
+
+        void _RebuildBounds();
+        void _RebuildOccluders();
+        void _CullOccluded(const glm::mat4& camera_view_projection_matrix, glm::vec3 camera_position);
+
+        //////// UPDATE SLOTS
+        // cubes are updated in blocks of this many, each block gets its own program mask slot
+        static constexpr size_t UPDATE_BLOCK_SIZE = 1024;
+        // written per cube by the culler, read by the workers and by the main thread when rendering
+        std::vector<Uint8> cube_visibility = {};
+        // written per block by the workers, OR'd together by the main thread
+        std::vector<Uint64> block_program_masks = {};
+        // bit index of each shader program in the masks above
+        std::vector<GLuint> shader_program_bits = {};
+
+        void _RegisterShaderProgram(GLuint shader_program);
+        Uint64 _GetShaderProgramBit(GLuint shader_program) const;
+
         //////// LIGHTING
         std::shared_ptr<TotalFrame::Light> light = nullptr;
 
         //////// MULTITHREADING
-        Uint8 total_threads = 0;
-        size_t cube_update_chunk_size = 0;
+        JobSystem* job_system = nullptr;
+
+        // runs function over [0, count) on the job system, or inline if there is none
+        void _ParallelFor(size_t count, size_t min_grain_size, const JobSystem::RangeFunction& function);
 
         float aspect_ratio = 1.778f;
 
@@ -0,0 +1,103 @@
+#ifndef SRC_OCCLUSIONCULLER_H_
+#define SRC_OCCLUSIONCULLER_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+
+#include <SDL3/SDL.h>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "TotalFrame.h"
+#include "Util.h"
+#include "JobSystem.h"
+
+/*
+ABOUT:
+CPU software occlusion culling. Rasterizes the silhouettes of occluder boxes into a small depth buffer, then tests the screen space bounds of other boxes against it.
+Pure CPU, never touches OpenGL, so it can run and be tested headless.
+
+NOTES:
+Typical frame: Clear(), SetViewProjection(), RasterizeOccluders() with the largest and nearest boxes, then IsBoxOccluded() for everything that passed frustum culling.
+The screen is split into tiles that are rasterized in parallel (one tile per job), 4 pixels at a time with SSE.
+Each 8x8 block of pixels also stores its farthest depth, so most tests are answered without reading single pixels.
+Coverage is inner conservative: a pixel is only written when it lies entirely inside an occluder's silhouette, with the farthest depth the occluder has over it. A pixel spans several screen pixels, so anything less could hide boxes that poke out past an occluder's edge.
+Boxes crossing the near plane are never used as occluders and are never reported as occluded.
+*/
+
+class OcclusionCuller {
+    public:
+        // width and height are rounded up to a multiple of TILE_SIZE
+        OcclusionCuller(int width = 256, int height = 128);
+
+        //////// BASIC FUNCTIONS
+        void Clear();
+        void SetViewProjection(const glm::mat4& view_projection_matrix);
+
+        //////// RASTERIZATION
+        void RasterizeOccluders(const std::vector<glm::vec3>& centers, const std::vector<glm::vec3>& extents, JobSystem* job_system = nullptr);
+
+        //////// TESTING
+        // true if the whole box is hidden behind already rasterized occluders. thread safe
+        bool IsBoxOccluded(glm::vec3 center, glm::vec3 extent) const;
+
+        //////// GETTERS
+        int GetWidth() const;
+        int GetHeight() const;
+        // depth per pixel, 0 = near plane, 1 = far plane (nothing rasterized)
+        const std::vector<float>& GetDepthBuffer() const;
+        size_t GetTotalOccluders() const;
+
+    private:
+        //////// TYPES
+        struct ScreenOccluder {
+            // silhouette edges (a, b, c), a * x + b * y + c >= 0 at the center of a pixel entirely inside
+            std::array<glm::vec3, 6> edges;
+            int total_edges = 0;
+            // front face depth planes (x, y, c), depth = x * x + y * y + c, already raised to the farthest depth over a pixel
+            std::array<glm::vec3, 3> planes;
+            int total_planes = 0;
+            // pixel bounds
+            int low_x, low_y, high_x, high_y;
+        };
+
+        //////// CONSTANTS
+        static constexpr int TILE_SIZE = 32;
+        static constexpr int BLOCK_SIZE = 8;
+        // depth difference needed before a pixel counts as in front, keeps boxes from hiding behind their own faces
+        static constexpr float DEPTH_BIAS = 1e-5f;
+        static constexpr float NEAR_W = 1e-4f;
+
+        //////// BASIC ATTRIBUTES
+        int width = 0;
+        int height = 0;
+        int blocks_x = 0;
+        int blocks_y = 0;
+
+        glm::mat4 view_projection_matrix = glm::mat4(1.0f);
+
+        std::vector<float> depth_buffer = {};
+        // farthest depth of each BLOCK_SIZE x BLOCK_SIZE block
+        std::vector<float> block_max_depth = {};
+
+        std::vector<ScreenOccluder> occluders = {};
+
+        //////// PROJECTION FUNCTIONS
+        // projects the 8 corners of a box to screen space. false if any corner is behind the near plane
+        bool _ProjectBox(glm::vec3 center, glm::vec3 extent, std::array<glm::vec3, 8>& screen_out) const;
+        // false if the box has no area on screen
+        bool _SetupOccluder(const std::array<glm::vec3, 8>& screen, ScreenOccluder& occluder_out) const;
+
+        //////// RASTERIZATION FUNCTIONS
+        void _RasterizeTile(int tile_x, int tile_y);
+        void _RasterizeOccluder(const ScreenOccluder& occluder, int low_x, int low_y, int high_x, int high_y);
+        void _UpdateBlocks(int low_x, int low_y, int high_x, int high_y);
+};
+
+#endif // SRC_OCCLUSIONCULLER_H_
@@ -0,0 +1,112 @@
+#ifndef SRC_OCCUPANCYGRID_H_
+#define SRC_OCCUPANCYGRID_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include "TotalFrame.h"
+#include "Util.h"
+#include "JobSystem.h"
+
+/*
+ABOUT:
+Sparse grid of bit-packed occupancy chunks, one bit per lattice cell.
+A chunk stores each row of CHUNK_SIZE cells along x as one Uint16, so neighbors along x are a bit shift away and neighbors along y and z are the rows next to it.
+Exposed faces, dilation and erosion are computed a whole z slab (256 cells, two SSE registers) at a time with shifts and ANDs, never cell by cell.
+
+NOTES:
+Chunk kernels take the six neighboring chunks (in TotalFrame::FACE order, nullptr for empty) so results are exact across chunk borders.
+Neighbors are 6 connected (faces only). Cells outside every chunk count as empty.
+Grid wide operations (Dilated(), Eroded(), GetShell(), GetEnclosed()) only read the grid, chunks are processed in parallel when a JobSystem is given.
+GetEnclosed() floods the outside in from the grid's bounds. Empty chunks are flooded whole first, then the chunks left are flooded a slab at a time in parallel passes until no chunk changes.
+*/
+
+class OccupancyGrid {
+    public:
+        OccupancyGrid();
+
+        //////// CONSTANTS
+        static constexpr int CHUNK_SIZE = 16;
+        static constexpr int CHUNK_ROWS = CHUNK_SIZE * CHUNK_SIZE;
+
+        //////// CHUNK
+        struct Chunk {
+            // bit x of rows[z * CHUNK_SIZE + y]
+            alignas(16) Uint16 rows[CHUNK_ROWS] = {};
+
+            bool Get(glm::ivec3 local_cell) const;
+            void Set(glm::ivec3 local_cell, bool occupied);
+            size_t Count() const;
+            bool IsEmpty() const;
+        };
+        // neighboring chunks in TotalFrame::FACE order, nullptr where there is none
+        using Neighbors = std::array<const Chunk*, 6>;
+
+        //////// CHUNK KERNELS
+        // faces_out[face] has a bit for every occupied cell whose neighbor across that face is empty
+        static void GetExposedFaces(const Chunk& chunk, const Neighbors& neighbors, std::array<Chunk, 6>& faces_out);
+        // occupied cells whose six neighbors are all occupied
+        static void Erode(const Chunk& chunk, const Neighbors& neighbors, Chunk& chunk_out);
+        // occupied cells plus every cell next to one
+        static void Dilate(const Chunk& chunk, const Neighbors& neighbors, Chunk& chunk_out);
+
+        //////// CELL FUNCTIONS
+        void Set(glm::ivec3 cell, bool occupied);
+        // occupies every cell set in cells at once, for bulk edits
+        void SetChunk(glm::ivec3 chunk_coordinate, const Chunk& cells);
+        bool IsOccupied(glm::ivec3 cell) const;
+        // bit per TotalFrame::FACE, set when the neighbor across that face is occupied
+        Uint8 GetNeighborMask(glm::ivec3 cell) const;
+        void Clear();
+
+        //////// GRID OPERATIONS
+        OccupancyGrid Dilated(JobSystem* job_system = nullptr) const;
+        OccupancyGrid Eroded(JobSystem* job_system = nullptr) const;
+        // occupied cells with at least one exposed face (the grid minus its erosion)
+        OccupancyGrid GetShell(JobSystem* job_system = nullptr) const;
+        // occupied cells with no path to the outside, none of their neighbors is an empty cell reachable from beyond the grid's bounds
+        OccupancyGrid GetEnclosed(JobSystem* job_system = nullptr) const;
+        size_t CountExposedFaces(JobSystem* job_system = nullptr) const;
+        void GetCells(std::vector<glm::ivec3>& cells_out) const;
+
+        //////// CHUNK ACCESS
+        const Chunk* FindChunk(glm::ivec3 chunk_coordinate) const;
+        Neighbors GetNeighbors(glm::ivec3 chunk_coordinate) const;
+        // every chunk coordinate in the grid, in no particular order
+        std::vector<glm::ivec3> GetChunkCoordinates() const;
+
+        //////// GETTERS
+        size_t GetTotalCells() const;
+        size_t GetTotalChunks() const;
+
+        //////// COORDINATE FUNCTIONS
+        static Uint64 GetKey(glm::ivec3 chunk_coordinate);
+        // floor division, so cell -1 is in chunk -1
+        static glm::ivec3 GetChunkCoordinate(glm::ivec3 cell);
+        static glm::ivec3 GetLocalCell(glm::ivec3 cell, glm::ivec3 chunk_coordinate);
+
+    private:
+        //////// BASIC ATTRIBUTES
+        std::unordered_map<Uint64, std::unique_ptr<Chunk>> chunks = {};
+        size_t total_cells = 0;
+
+        // most chunks the bounds around the grid may span in GetEnclosed()
+        static constexpr size_t ENCLOSED_MAX_CHUNKS = size_t(1) << 22;
+
+        // inverse of GetKey()
+        static glm::ivec3 _GetChunkCoordinate(Uint64 key);
+
+        // runs kernel on every chunk in coordinates, keeping the non empty results
+        template <typename Kernel>
+        OccupancyGrid _Apply(const std::vector<glm::ivec3>& coordinates, JobSystem* job_system, const Kernel& kernel) const;
+};
+
+#endif // SRC_OCCUPANCYGRID_H_
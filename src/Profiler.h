@@ -0,0 +1,105 @@
+#ifndef SRC_PROFILER_H_
+#define SRC_PROFILER_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <memory>
+#include <string>
+
+#include <atomic>
+#include <mutex>
+
+#include <SDL3/SDL.h>
+
+#include "TotalFrame.h"
+#include "Util.h"
+
+/*
+ABOUT:
+Scope timer instrumentation, written out as Chrome trace event JSON (open in chrome://tracing or ui.perfetto.dev).
+
+NOTES:
+Put TF_PROFILE_SCOPE("Class::Function") at the top of a scope to time it until the scope ends. Names must be string literals, only the pointer is kept.
+TF_PROFILE_THREAD("name") names the calling thread in the trace.
+Timers only exist when built with TF_PROFILING defined (make PROFILE=1), otherwise both macros compile to nothing.
+Every thread records into its own ring buffer of BUFFER_EVENTS events, so recording never locks or allocates. A thread only locks once, the first time it records, to register its buffer. Once full, the oldest events are overwritten.
+WriteTrace() can be called from any thread while others keep recording. Every slot holds the position of the event in it (a sequence lock, as in Logger), so events overwritten while it reads are detected and dropped, never copied half written.
+*/
+
+#ifdef TF_PROFILING
+#define TF_PROFILE_CONCAT_INNER(a, b) a##b
+#define TF_PROFILE_CONCAT(a, b) TF_PROFILE_CONCAT_INNER(a, b)
+#define TF_PROFILE_SCOPE(name) Profiler::Scope TF_PROFILE_CONCAT(profile_scope_, __LINE__)(name)
+#define TF_PROFILE_THREAD(name) Profiler::SetThreadName(name)
+#else
+#define TF_PROFILE_SCOPE(name)
+#define TF_PROFILE_THREAD(name)
+#endif
+
+class Profiler {
+    public:
+        //////// CONSTANTS
+        // events kept per thread, a power of two
+        static constexpr size_t BUFFER_EVENTS = size_t(1) << 16;
+
+        //////// SCOPE TIMER
+        class Scope {
+            public:
+                explicit Scope(const char* name);
+                ~Scope();
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+            private:
+                const char* name = nullptr;
+                Uint64 start = 0;
+        };
+
+        //////// THREADS
+        // names the calling thread in the trace, threads are "thread N" otherwise
+        static void SetThreadName(const std::string& name);
+
+        //////// OUTPUT
+        // writes every recorded event of every thread, false if nothing was recorded or the file could not be written
+        static bool WriteTrace(const std::string& path);
+
+    private:
+        //////// TYPES
+        struct Event {
+            const char* name = nullptr;
+            Uint64 start = 0;
+            Uint64 end = 0;
+        };
+
+        // sequence is the position of the event + 1 once it is written, 0 while it is being written. the fields are atomic so WriteTrace() may read them mid write
+        struct Slot {
+            std::atomic<Uint64> sequence{0};
+            std::atomic<const char*> name{nullptr};
+            std::atomic<Uint64> start{0};
+            std::atomic<Uint64> end{0};
+        };
+
+        // written only by its thread, read by WriteTrace()
+        struct ThreadBuffer {
+            std::array<Slot, BUFFER_EVENTS> slots = {};
+            std::atomic<Uint64> total_written{0};
+            Uint32 thread_index = 0;
+            std::string name = "";
+        };
+
+        //////// REGISTRY
+        // every buffer ever registered, kept until exit so threads that ended still show up in the trace
+        static std::mutex registry_mutex;
+        static std::vector<std::unique_ptr<ThreadBuffer>> registry;
+        static thread_local ThreadBuffer* thread_buffer;
+
+        //////// BUFFER FUNCTIONS
+        static ThreadBuffer& _GetThreadBuffer();
+        static void _Record(const char* name, Uint64 start, Uint64 end);
+};
+
+#endif // SRC_PROFILER_H_
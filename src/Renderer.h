@@ -4,44 +4,87 @@
 #pragma once
 
 #include <iostream>
+#include <vector>
 
 #include <SDL3/SDL.h>
 
 #include <GL/glew.h>
 #include <glm/glm.hpp>
 
-#include <thread>
-#include <future>
-
 #include "TotalFrame.h"
 #include "Util.h"
+#include "Profiler.h"
 
 // things that can be rendered
 #include "Skybox.h"
 #include "Object.h"
 #include "Texture.h"
 
+/*
+ABOUT:
+Persistent registry of everything drawn each frame, kept sorted by layer.
+
+NOTES:
+Register items once with Add(), which stores a reference (not a copy) and returns a handle for Remove() and SetLayer(). Registered items must outlive their registration.
+Layers are drawn in ascending order, layer -1 is always drawn last. Items on the same layer keep the order they were added in.
+Each frame call Update(), then CameraHandler::UpdateShaderPrograms(GetShaderProgramsUpdates()), then RenderAll().
+*/
+
 class Renderer {
     public:
         Renderer();
 
-        void Add(const Skybox& item, int layer = -1);
-        void Add(const Object& item, int layer = -1);
-        void Add(const Texture& item, int layer = -1);
+        using Handle = Uint32;
+        static constexpr Handle INVALID_HANDLE = 0;
+
+        //////// REGISTRATION
+        Handle Add(Skybox& item, int layer = -1);
+        Handle Add(Object& item, int layer = -1);
+        Handle Add(Texture& item, int layer = -1);
 
+        void Remove(Handle handle);
+        void SetLayer(Handle handle, int layer);
+
+        // removes every item
         void Clear();
 
+        //////// RENDERING
+        // culls and updates objects, must come before GetShaderProgramsUpdates() and RenderAll()
+        void Update(const glm::mat4& camera_view_matrix, const glm::mat4& camera_projection_matrix, glm::vec3 camera_position);
+
         std::vector<GLuint> GetShaderProgramsUpdates();
 
         void RenderAll(glm::mat4 camera_view_matrix, glm::mat4 camera_projection_matrix, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights);
+        // draws issued by every item in the last RenderAll()
+        TotalFrame::RenderStats GetRenderStats() const;
 
     private:
-        std::vector<std::pair<Skybox, int>> skyboxes = {};
-        std::vector<std::pair<Object, int>> objects = {};
-        std::vector<std::pair<Texture, int>> textures = {};
+        //////// TYPES
+        enum ITEM_TYPE {
+            SKYBOX_ITEM,
+            OBJECT_ITEM,
+            TEXTURE_ITEM
+        };
+
+        struct Item {
+            Handle handle = INVALID_HANDLE;
+            ITEM_TYPE type = OBJECT_ITEM;
+            int layer = -1;
+            // points at the registered Skybox, Object or Texture depending on type
+            void* pointer = nullptr;
+        };
+
+        //////// BASIC ATTRIBUTES
+        // always sorted by layer
+        std::vector<Item> items = {};
+        Handle next_handle = 1;
+        TotalFrame::RenderStats render_stats;
 
-        std::vector<TotalFrame::RenderItem> render_queue = {};
-        
+        //////// REGISTRATION FUNCTIONS
+        Handle _Insert(ITEM_TYPE type, void* pointer, int layer);
+        size_t _Find(Handle handle) const;
+        // true if a is drawn before b
+        static bool _LayerBefore(int a, int b);
 };
 
-#endif // SRC_RENDERER_H_
\ No newline at end of file
+#endif // SRC_RENDERER_H_
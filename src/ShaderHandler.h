@@ -17,6 +17,8 @@
 
 #include "TotalFrame.h"
 #include "Util.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
 
 /*
 ABOUT:
@@ -35,10 +37,11 @@ GEOMETRY SHADERS: *.geom
 class ShaderHandler {
     public:
         ShaderHandler(SDL_GLContext context);
-        ~ShaderHandler();
+        // deletes every shader program it created
+        void FreeAll();
 
         //////// BASIC SHADER FUNCTIONS
-        // creates and returns shader program based on 
+        // creates and returns shader program based on the folder, the handler keeps ownership of it
         GLuint CreateShaderProgram(std::string dir_path);
 
     private:
@@ -48,7 +51,7 @@ class ShaderHandler {
         std::vector<GLenum> shader_types = {GL_VERTEX_SHADER, GL_FRAGMENT_SHADER, GL_GEOMETRY_SHADER};
 
         //////// MEMORY MANAGEMENT
-        std::vector<GLuint> shader_programs = {};
+        std::vector<GLProgram> shader_programs = {};
 
         //////// SHADER SOURCE MAPS
         // vertex shaders
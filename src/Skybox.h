@@ -24,16 +24,23 @@
 //// TOTALFRAME LIBRARIES
 #include "TotalFrame.h"
 #include "Texture.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
 
 /*
 ABOUT:
 Basic skybox function.
 IMPORTANT: Ensure you use FreeAll() before exiting program 
+Move-only, it owns its cube map, vertex array and vertex buffer.
 */
 
 class Skybox {
     public:
         Skybox(std::string skybox_folder_path, GLuint shader_program);
+        Skybox(const Skybox&) = delete;
+        Skybox& operator=(const Skybox&) = delete;
+        Skybox(Skybox&&) = default;
+        Skybox& operator=(Skybox&&) = default;
 
         //////// BASIC FUNCTIONS
         void Build();
@@ -44,13 +51,13 @@ class Skybox {
 
     private:
         //////// BASIC ATTRIBUTES
-        GLuint cubemap_texture = 0;
+        GLTexture cubemap_texture;
         GLuint shader_program = 0;
 
         std::vector<GLfloat> vertices = {};
 
-        GLuint vertex_array = 0;
-        GLuint vertex_buffer = 0;
+        GLVertexArray vertex_array;
+        GLBuffer vertex_buffer;
 
         TF_SKYBOX_PATHS faces_paths = {};
 
@@ -0,0 +1,127 @@
+#ifndef SRC_STATSHUD_H_
+#define SRC_STATSHUD_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <string>
+
+#include <filesystem>
+
+//// SDL LIBRARIES
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_ttf.h>
+
+//// GLEW
+#include <GL/glew.h>
+
+//// GLM
+#include <glm/glm.hpp>
+#include <glm/ext.hpp>
+
+//// TOTALFRAME LIBRARIES
+#include "TotalFrame.h"
+#include "Util.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
+#include "Object.h"
+
+/*
+ABOUT:
+On screen overlay of per frame statistics: frame time percentiles, draw calls, triangles, GL calls and uploads (per subsystem and call type), cube counts, picking and the last save.
+IMPORTANT: Ensure you use FreeAll() before exiting program
+Move-only, it owns its glyph atlas, vertex array and vertex buffer.
+
+NOTES:
+The font is the first .ttf or .otf in res/fonts, otherwise the first system font found. Without one the overlay stays disabled and Render() does nothing. Needs TTF_Init().
+Printable ASCII is rasterized once into a single channel atlas, each frame the text (and the panel behind it, drawn with a white texel of the atlas) is built into one vertex buffer and drawn with a single call.
+Call AddFrameTime() every rendered frame, percentiles are over the last FRAME_SAMPLES of them. GL counts are GLDispatch's last frame, split into a row per subsystem and followed by the TOP_GL_CALLS most frequent call types.
+Draw it last, depth testing and face culling are off while it draws.
+*/
+
+class StatsHud {
+    public:
+        StatsHud(GLuint shader_program, Uint16 screen_width, Uint16 screen_height, float font_size = 16.0f);
+        StatsHud(const StatsHud&) = delete;
+        StatsHud& operator=(const StatsHud&) = delete;
+        StatsHud(StatsHud&&) = default;
+        StatsHud& operator=(StatsHud&&) = default;
+
+        //////// CONSTANTS
+        static constexpr size_t FRAME_SAMPLES = 240;
+        // call types listed under the GL counts
+        static constexpr size_t TOP_GL_CALLS = 4;
+
+        //////// BASIC ATTRIBUTES
+        // toggled by the user, ignored while no font is loaded
+        bool visible = true;
+
+        //////// TIMINGS
+        void AddFrameTime(double milliseconds);
+        void SetSaveTime(double milliseconds);
+
+        //////// RENDERING
+        // false when no font could be loaded
+        bool IsEnabled() const;
+        void Render(const TotalFrame::RenderStats& render_stats, const Object::CullStats& cull_stats, double pick_time);
+
+        //////// MEMORY MANAGEMENT
+        void FreeAll();
+
+    private:
+        //////// TYPES
+        struct Glyph {
+            glm::vec2 uv_min = glm::vec2(0.0f);
+            glm::vec2 uv_max = glm::vec2(0.0f);
+            // pixels, the quad is as wide as the glyph advances
+            glm::vec2 size = glm::vec2(0.0f);
+        };
+
+        struct HudVertex {
+            glm::vec2 position = glm::vec2(0.0f);
+            glm::vec2 uv = glm::vec2(0.0f);
+            // RGBA8
+            GLubyte color[4] = {255, 255, 255, 255};
+        };
+
+        //////// BASIC ATTRIBUTES
+        GLuint shader_program = 0;
+        glm::vec2 screen_size = glm::vec2(0.0f);
+        bool enabled = false;
+
+        //////// ATLAS
+        static constexpr Uint32 FIRST_GLYPH = 32;
+        static constexpr Uint32 LAST_GLYPH = 126;
+        static constexpr int ATLAS_WIDTH = 512;
+
+        std::array<Glyph, LAST_GLYPH - FIRST_GLYPH + 1> glyphs = {};
+        // center of the opaque block in the atlas corner, used for untextured quads
+        glm::vec2 white_uv = glm::vec2(0.0f);
+        float line_height = 0.0f;
+
+        GLTexture atlas_texture;
+        GLVertexArray vertex_array;
+        GLBuffer vertex_buffer;
+
+        //////// TIMINGS
+        std::array<double, FRAME_SAMPLES> frame_times = {};
+        size_t total_frame_times = 0;
+        double save_time = -1.0;
+
+        std::vector<HudVertex> vertices = {};
+
+        //////// ATLAS FUNCTIONS
+        static std::string _FindFont();
+        bool _BuildAtlas(const std::string& font_path, float font_size);
+        void _Build();
+
+        //////// TEXT FUNCTIONS
+        void _AppendQuad(glm::vec2 position, glm::vec2 size, glm::vec2 uv_min, glm::vec2 uv_max, Uint32 color);
+        // returns the width of the text in pixels
+        float _AppendText(const std::string& text, glm::vec2 position, Uint32 color);
+        float _GetTextWidth(const std::string& text) const;
+};
+
+#endif // SRC_STATSHUD_H_
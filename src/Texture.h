@@ -14,13 +14,19 @@
 #include <glm/glm.hpp>
 
 #include "TotalFrame.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
 
 class Texture {
     public:
         Texture(std::string path);
-        ~Texture();
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+        Texture(Texture&&) = default;
+        Texture& operator=(Texture&&) = default;
 
-        GLuint id;
+        // deleted with the texture, copies are not allowed so it is never deleted twice
+        GLTexture id;
 
         int width = 0;
         int height = 0;
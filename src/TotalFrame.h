@@ -25,12 +25,14 @@ STRUCTS:
 Material(ambient lighting coefficient, diffusion lighting coefficient, specular lighting coefficient, shininess lighting coefficient)
 Light(position, color, intensity)
 MoveQueue(key set)
+CubeData(position, triangles vertices)
+PackedVertex(quantized position + face index, RGBA8 color)
+CubeRecord(position, RGBA8 color, template index)
 Ray(origin, direction)
 */
 
 using TF_MOVEMENT_KEYSET = std::array<SDL_Keycode, 6>;
 using TF_TRIANGLE_VERTICES = std::array<GLfloat, 18>;
-using TF_TRIANGLE_VERTICES_WITH_NORMAL = std::array<GLfloat, 27>;
 using TF_SKYBOX_PATHS = std::array<std::string, 6>;
 
 class TotalFrame {
@@ -66,11 +68,6 @@ class TotalFrame {
         static constexpr float READ_SIZE_FROM_FILE = -1000.0f;
         static constexpr glm::vec3 READ_POS_FROM_FILE = glm::vec3(-1000.0f);
 
-        struct RenderItem {
-            int layer;
-            std::function<void()> RenderFunction;
-        };
-
         struct Material {
             Material(glm::vec3 p_ambient, glm::vec3 p_diffuse, glm::vec3 p_specular, GLfloat p_shininess) : ambient(p_ambient), diffuse(p_diffuse), specular(p_specular), shininess(p_shininess) {
                 ;
@@ -107,7 +104,7 @@ class TotalFrame {
             // x = -1 = "left" :: x = 1 = "right" 
             // y = -1 = "up" :: y = 1 = "down"
             // z = -1 = "back" :: z = 1 = "forward"
-            std::array<int, 3> move_dir;
+            std::array<int, 3> move_dir = {0, 0, 0};
 
             // translates keys to direction for direction vector. {key value, {move_dir index, move_dir value}}
             std::unordered_map<SDL_Keycode, std::pair<int, int>> key_to_dir;
@@ -133,6 +130,53 @@ class TotalFrame {
             MoveQueue() = default;
         };
 
+        // cube geometry faces. index into FACE_NORMALS, stored per vertex instead of a normal
+        enum FACE {
+            FACE_POSITIVE_X,
+            FACE_NEGATIVE_X,
+            FACE_POSITIVE_Y,
+            FACE_NEGATIVE_Y,
+            FACE_POSITIVE_Z,
+            FACE_NEGATIVE_Z
+        };
+
+        // must match the normal table in res/shaders/cube
+        static constexpr std::array<glm::vec3, 6> FACE_NORMALS = {
+            glm::vec3(1.0f, 0.0f, 0.0f), glm::vec3(-1.0f, 0.0f, 0.0f),
+            glm::vec3(0.0f, 1.0f, 0.0f), glm::vec3(0.0f, -1.0f, 0.0f),
+            glm::vec3(0.0f, 0.0f, 1.0f), glm::vec3(0.0f, 0.0f, -1.0f)
+        };
+
+        // largest quantized coordinate, a coordinate of +-position_scale is stored as +-POSITION_QUANTIZATION
+        static constexpr float POSITION_QUANTIZATION = 32767.0f;
+
+        // 12 byte vertex used by cube geometry (was 36 bytes of position, color and normal floats)
+        struct PackedVertex {
+            // x, y, z relative to the cube, quantized. w = FACE index
+            GLshort position[4] = {0, 0, 0, 0};
+            // RGBA8
+            GLubyte color[4] = {0, 0, 0, 255};
+        };
+
+        // compact cube stored by Object, its geometry lives in a shared CubeTemplate
+        struct CubeRecord {
+            // center, before the aspect ratio stretch
+            glm::vec3 position = glm::vec3(0.0f);
+            // RGBA8 (r in the lowest byte), multiplied with the template's vertex colors
+            Uint32 color = 0xFFFFFFFF;
+            Uint32 template_index = 0;
+        };
+        // the records are uploaded as is and read back by cube.vert as CUBE_RECORD_UINTS uints each
+        static constexpr int CUBE_RECORD_UINTS = 5;
+
+        // parsed cube data, filled off the main thread then turned into a Cube on it
+        struct CubeData {
+            glm::vec3 position = glm::vec3(0.0f);
+            std::vector<std::vector<GLfloat>> triangles_vertices = {};
+
+            CubeData() = default;
+        };
+
         struct Ray {
             Ray(glm::vec3 p_origin, glm::vec3 p_direction) : origin(p_origin), direction(p_direction) {
                 ;
@@ -143,6 +187,12 @@ class TotalFrame {
 
             Ray() = default; 
         };
+
+        // what a render pass drew, summed by the Renderer for the stats overlay
+        struct RenderStats {
+            size_t draw_calls = 0;
+            size_t triangles = 0;
+        };
 };
 
 #endif // SRC_TOTALFRAME_H_
\ No newline at end of file
@@ -6,6 +6,8 @@
 #include <iostream>
 #include <vector>
 #include <memory>
+#include <array>
+#include <cmath>
 
 #include <SDL3/SDL.h>
 
@@ -14,53 +16,79 @@
 
 #include "TotalFrame.h"
 #include "Util.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/ext.hpp"
 
 /*
 ABOUT:
-A basic colored triangle. Contains vertices, vertex array and vertex buffer.
-Typical lifecycle is construct, LoadVertices, Build then Render. 
+A basic colored triangle. Contains packed vertices, vertex array and vertex buffer.
+Typical lifecycle is construct, LoadVertices then Render. Render() builds (or re-uploads) the buffers when the vertices changed, so nothing touches OpenGL before the first draw.
+
+NOTES:
+Vertices are stored as TotalFrame::PackedVertex: positions quantized to 16 bits relative to position_scale, an RGBA8 color and a face index instead of a normal.
+All triangles of a cube share one position_scale (the cube's largest coordinate), so the cube can undo the quantization in its model matrix.
+Positions outside +-position_scale are clamped.
+Move-only, it owns its vertex array and vertex buffer.
 */
 
 class Triangle {
     public:
-        Triangle(std::vector<GLfloat> vertices);
+        // position_scale of 0 uses the largest coordinate of the vertices
+        Triangle(std::vector<GLfloat> vertices, float position_scale = 0.0f);
+        Triangle(const Triangle&) = delete;
+        Triangle& operator=(const Triangle&) = delete;
+        Triangle(Triangle&&) = default;
+        Triangle& operator=(Triangle&&) = default;
         void FreeAll();
 
-        //////// BASIC ATTRIBUTES
-        std::shared_ptr<TF_TRIANGLE_VERTICES> vertices = std::make_shared<TF_TRIANGLE_VERTICES>();
-
         //////// BASIC FUNCTIONS
-        // verifys vertex_array and vertex_buffer is valid (non-zero)
+        // verifys vertex_array and vertex_buffer is valid (non-zero), false until the first Build() or Render()
         bool Verify();
-        void LoadVertices(std::vector<GLfloat> vertices);
+        void LoadVertices(std::vector<GLfloat> vertices, float position_scale = 0.0f);
         void Build();
         void Render();
         void RenderOutline();
         std::string GetData();
+        // the 18 floats (x, y, z, r, g, b per vertex) the triangle was loaded from, after quantization
+        TF_TRIANGLE_VERTICES GetVertices() const;
+        float GetPositionScale() const;
         
         //////// EXPORTATION FUNCTIONS
         void Translate(glm::vec3 translation);
-        std::vector<glm::vec3> GetPositions();
+        std::vector<glm::vec3> GetPositions() const;
 
         //////// NORMAL FUNCTIONS
         glm::vec3 GetNormal();
-        void UpdateNormal();
-        void UpdateFullVertices();
+        TotalFrame::FACE GetFace() const;
+        // closest axis aligned face to a normal
+        static TotalFrame::FACE GetFaceFromNormal(glm::vec3 normal);
+
+        //////// PACKING FUNCTIONS
+        // packs 18 floats (x, y, z, r, g, b per vertex) into 3 vertices. shared with CubeTemplate
+        static void PackVertices(const GLfloat* vertices, float position_scale, TotalFrame::PackedVertex* vertices_out);
+        // unpacks 3 vertices back into 18 floats
+        static void UnpackVertices(const TotalFrame::PackedVertex* vertices, float position_scale, GLfloat* vertices_out);
+        // largest coordinate of a set of 18 float triangles, 1 if there is none
+        static float GetPositionScale(const std::vector<std::vector<GLfloat>>& triangles_vertices);
+        static GLshort QuantizePosition(float value, float position_scale);
+        static float DequantizePosition(GLshort value, float position_scale);
+        static GLubyte QuantizeColor(float value);
 
         //////// COLOR FUNCTIONS
         void SetColor(glm::vec3 color);
         glm::vec3 GetColor();
 
     private:
-        std::shared_ptr<TF_TRIANGLE_VERTICES_WITH_NORMAL> full_vertices = std::make_shared<TF_TRIANGLE_VERTICES_WITH_NORMAL>();
+        std::array<TotalFrame::PackedVertex, 3> vertices = {};
+        float position_scale = 1.0f;
 
-        glm::vec3 normal = glm::vec3(0.0f);
-        
-        GLuint vertex_array = 0;
-        GLuint vertex_buffer = 0;
+        GLVertexArray vertex_array;
+        GLBuffer vertex_buffer;
+        // vertices changed since the last Build()
+        bool upload_needed = true;
 };
 
-#endif // SRC_TRIANGLE_H_
\ No newline at end of file
+#endif // SRC_TRIANGLE_H_
@@ -11,6 +11,7 @@
 #include <SDL3/SDL.h>
 
 #include "TotalFrame.h"
+#include "Logger.h"
 
 /*
 ABOUT:
@@ -27,13 +28,17 @@ class Util {
         ////////// MATH
         static int ToggleInt(int x, int max);
         static std::array<float, 2> Normalize(std::array<float, 2> velocity);
+        // nearest rank percentile of sorted_values, p in [0, 1]. 0 when there are none
+        static double GetPercentile(const std::vector<double>& sorted_values, double p);
 
         ////////// OUTPUT CONTROL
-        static void Debug(std::string message);
-        // Pass __func__ as second parameter. Cannot be set as default param.
-        static void ThrowError(std::string error, std::string function);
+        // logging is TF_LOG_ERROR() and the rest of the macros in Logger.h
         static void GetOpenGLError();
 
+        ////////// TIMING
+        // milliseconds since start_counter, a SDL_GetPerformanceCounter() value
+        static double GetElapsedMilliseconds(Uint64 start_counter);
+
         ////////// COMPARISON
         static bool ComparePoint(SDL_Point a, SDL_Point b);
 };
@@ -0,0 +1,114 @@
+#ifndef SRC_VOXELCHUNKS_H_
+#define SRC_VOXELCHUNKS_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <array>
+#include <memory>
+#include <unordered_map>
+
+#include <SDL3/SDL.h>
+#include <GL/glew.h>
+#include <glm/glm.hpp>
+
+#include "TotalFrame.h"
+#include "Util.h"
+#include "GLHandle.h"
+#include "GLDispatch.h"
+#include "JobSystem.h"
+#include "Culler.h"
+#include "OccupancyGrid.h"
+
+#define GLM_ENABLE_EXPERIMENTAL
+#include "glm/ext.hpp"
+
+/*
+ABOUT:
+Sparse chunked storage for cubes on an integer lattice. Each chunk holds CHUNK_SIZE^3 cells with a bit-packed OccupancyGrid::Chunk, a color per cell and a cached mesh of the faces that are not covered by a neighboring cube.
+
+NOTES:
+Cells are addressed by integer lattice coordinates, the world transform (origin, cell size, stretch) is only applied when rendering, so moving the whole lattice never remeshes.
+Set() and Clear() only dirty the chunk they touch, plus the neighboring chunk when the cell is on its border (the neighbor's faces against it change).
+Remesh() rebuilds dirty chunks in parallel without touching OpenGL. The faces to emit come from OccupancyGrid::GetExposedFaces(), a slab at a time, so covered cells cost nothing. Render() uploads the rebuilt meshes, reusing each chunk's buffer while it is big enough, then draws the chunks in view.
+Mesh vertices are TotalFrame::PackedVertex with chunk local corner coordinates (0 to CHUNK_SIZE), drawn with the cube shader's model_matrix path.
+*/
+
+class VoxelChunks {
+    public:
+        VoxelChunks();
+        void FreeAll();
+
+        VoxelChunks(const VoxelChunks&) = delete;
+        VoxelChunks& operator=(const VoxelChunks&) = delete;
+        VoxelChunks(VoxelChunks&&) = default;
+        VoxelChunks& operator=(VoxelChunks&&) = default;
+
+        //////// CONSTANTS
+        static constexpr int CHUNK_SIZE = OccupancyGrid::CHUNK_SIZE;
+        static constexpr int CHUNK_CELLS = CHUNK_SIZE * CHUNK_SIZE * CHUNK_SIZE;
+
+        //////// CELL FUNCTIONS
+        // occupies a cell or recolors it. color is RGBA8 like TotalFrame::CubeRecord
+        void Set(glm::ivec3 cell, Uint32 color);
+        // Set() for every cell set in cells at once, colors are per cell index (x + y * CHUNK_SIZE + z * CHUNK_SIZE^2)
+        void SetChunk(glm::ivec3 chunk_coordinate, const OccupancyGrid::Chunk& cells, const std::array<Uint32, CHUNK_CELLS>& colors);
+        void Clear(glm::ivec3 cell);
+        bool IsOccupied(glm::ivec3 cell) const;
+        // 0 for an empty cell
+        Uint32 GetColor(glm::ivec3 cell) const;
+        // removes every cell and chunk
+        void ClearAll();
+
+        //////// MESH FUNCTIONS
+        // rebuilds the mesh of every dirty chunk, spread over the job system when given
+        void Remesh(JobSystem* job_system = nullptr);
+        // uploads rebuilt meshes and draws the chunks inside the frustum, adding the draws to stats_out. the shader program must already be in use
+        void Render(const Culler::Frustum& frustum, glm::vec3 origin, float cell_size, glm::vec3 stretch, GLint model_matrix_location, TotalFrame::RenderStats& stats_out);
+
+        //////// GETTERS
+        size_t GetTotalCells() const;
+        size_t GetTotalChunks() const;
+        size_t GetTotalDirtyChunks() const;
+        // triangles across every cached mesh
+        size_t GetTotalTriangles() const;
+
+    private:
+        //////// TYPES
+        struct Chunk {
+            glm::ivec3 coordinate = glm::ivec3(0);
+            OccupancyGrid::Chunk occupancy = {};
+            std::array<Uint32, CHUNK_CELLS> colors = {};
+            size_t total_cells = 0;
+
+            // the mesh no longer matches the cells
+            bool dirty = true;
+            // the mesh was rebuilt but not uploaded yet
+            bool upload_needed = false;
+            std::vector<TotalFrame::PackedVertex> mesh = {};
+
+            GLVertexArray vertex_array;
+            GLBuffer vertex_buffer;
+            // vertices the buffer can hold without being reallocated
+            size_t buffer_capacity = 0;
+        };
+
+        //////// BASIC ATTRIBUTES
+        // chunks are heap allocated so they never move while their neighbors are read during remeshing
+        std::unordered_map<Uint64, std::unique_ptr<Chunk>> chunks = {};
+        size_t total_cells = 0;
+
+        //////// CHUNK FUNCTIONS
+        static int _GetCellIndex(glm::ivec3 local_cell);
+        Chunk* _FindChunk(glm::ivec3 chunk_coordinate) const;
+        Chunk& _GetOrCreateChunk(glm::ivec3 chunk_coordinate);
+        // dirties the neighbors across every border the local cell touches
+        void _DirtyNeighbors(glm::ivec3 chunk_coordinate, glm::ivec3 local_cell);
+
+        //////// MESH FUNCTIONS
+        void _BuildMesh(Chunk& chunk) const;
+        void _Upload(Chunk& chunk);
+};
+
+#endif // SRC_VOXELCHUNKS_H_
@@ -0,0 +1,129 @@
+#ifndef SRC_VOXELOCTREE_H_
+#define SRC_VOXELOCTREE_H_
+
+#pragma once
+
+#include <iostream>
+#include <vector>
+#include <functional>
+#include <limits>
+#include <cstring>
+
+#include <SDL3/SDL.h>
+#include <glm/glm.hpp>
+
+#include "TotalFrame.h"
+#include "Util.h"
+
+/*
+ABOUT:
+Sparse voxel octree over integer lattice cells, each occupied cell holding a Uint32 value.
+Only occupied branches exist, so memory follows the occupied cells and not the space they are spread over. Finding, ray casting and region queries walk one branch per level.
+
+NOTES:
+Cell c covers [c, c + 1) on each axis. Rays and regions are given in that cell space.
+The root grows around the cells as they are inserted and shrinks back when branches empty out, so cells can be anywhere within +-MAX_CELL.
+Nodes live in one vector and are addressed by index, freed nodes are reused.
+Serialize() writes a compact pre-order layout (a child mask byte per node, the value per cell) that Deserialize() reads back.
+*/
+
+class VoxelOctree {
+    public:
+        VoxelOctree();
+
+        //////// CONSTANTS
+        // furthest cell from the origin on any axis
+        static constexpr int MAX_CELL = 1 << 24;
+
+        //////// TYPES
+        struct RayHit {
+            glm::ivec3 cell = glm::ivec3(0);
+            Uint32 value = 0;
+            // where the ray enters the cell, origin + t * direction
+            float t = 0.0f;
+            // axis of the face the ray enters through
+            int axis = 0;
+        };
+        struct Entry {
+            glm::ivec3 cell = glm::ivec3(0);
+            Uint32 value = 0;
+        };
+
+        //////// CELL FUNCTIONS
+        // occupies a cell or replaces its value. false if the cell is past MAX_CELL
+        bool Insert(glm::ivec3 cell, Uint32 value);
+        // Insert() for every entry, returns how many were inserted. each walk starts from the deepest node shared with the previous entry, so entries sorted by chunk or region skip most of the tree
+        size_t InsertMany(const Entry* entries, size_t count);
+        // false if the cell was empty
+        bool Remove(glm::ivec3 cell);
+        bool Find(glm::ivec3 cell, Uint32& value_out) const;
+        void Clear();
+        // visits every occupied cell, values may be changed in place
+        void ForEach(const std::function<void(glm::ivec3 cell, Uint32& value)>& function);
+
+        //////// QUERIES
+        // first occupied cell along the whole line origin + t * direction (t may be negative), front to back. false if none
+        bool RayCast(glm::vec3 origin, glm::vec3 direction, RayHit& hit_out) const;
+        // every occupied cell within [min_cell, max_cell] (inclusive), appended to entries_out
+        void QueryRegion(glm::ivec3 min_cell, glm::ivec3 max_cell, std::vector<Entry>& entries_out) const;
+
+        //////// SERIALIZATION
+        std::vector<Uint8> Serialize() const;
+        // replaces the tree, false (and an empty tree) if the data is not a serialized octree
+        bool Deserialize(const Uint8* data, size_t size);
+
+        //////// GETTERS
+        size_t GetTotalCells() const;
+        size_t GetTotalNodes() const;
+        size_t GetMemoryUsage() const;
+
+    private:
+        //////// TYPES
+        static constexpr Uint32 NO_NODE = UINT32_MAX;
+        // serialized layout identifiers
+        static constexpr Uint32 SERIAL_MAGIC = 0x4F564654; // "TFVO"
+        static constexpr Uint32 SERIAL_VERSION = 1;
+        // deepest the root may get, a node at depth d covers 2^d cells per axis
+        static constexpr int MAX_DEPTH = 26;
+
+        struct Node {
+            // child node indices, or values for nodes of depth 1 (their children are cells)
+            Uint32 children[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+            // bit i set when child i is occupied
+            Uint8 mask = 0;
+        };
+
+        //////// BASIC ATTRIBUTES
+        std::vector<Node> nodes = {};
+        std::vector<Uint32> free_nodes = {};
+        Uint32 root = NO_NODE;
+        // the root covers [root_origin, root_origin + 2^root_depth)
+        glm::ivec3 root_origin = glm::ivec3(0);
+        int root_depth = 0;
+        size_t total_cells = 0;
+
+        //////// NODE FUNCTIONS
+        Uint32 _NewNode();
+        void _FreeNode(Uint32 node);
+        // child slot of the cell in a node of depth at origin
+        static int _GetChild(glm::ivec3 cell, glm::ivec3 origin, int depth);
+        static glm::ivec3 _GetChildOrigin(glm::ivec3 origin, int depth, int child);
+        bool _IsInRoot(glm::ivec3 cell) const;
+        // adds levels above the root until it covers the cell
+        bool _GrowRoot(glm::ivec3 cell);
+        // drops roots with a single child
+        void _ShrinkRoot();
+
+        //////// QUERY FUNCTIONS
+        bool _RayCast(Uint32 node, glm::ivec3 origin, int depth, glm::vec3 ray_origin, glm::vec3 inverse_direction, RayHit& hit_out) const;
+        // entry and exit t of the box, false if the line misses it
+        static bool _RayBox(glm::vec3 box_min, glm::vec3 box_max, glm::vec3 ray_origin, glm::vec3 inverse_direction, float& t_enter_out, float& t_exit_out, int& axis_out);
+        void _QueryRegion(Uint32 node, glm::ivec3 origin, int depth, glm::ivec3 min_cell, glm::ivec3 max_cell, std::vector<Entry>& entries_out) const;
+        void _ForEach(Uint32 node, glm::ivec3 origin, int depth, const std::function<void(glm::ivec3 cell, Uint32& value)>& function);
+
+        //////// SERIALIZATION FUNCTIONS
+        void _Serialize(Uint32 node, int depth, std::vector<Uint8>& data_out) const;
+        Uint32 _Deserialize(int depth, const Uint8* data, size_t size, size_t& offset, bool& valid);
+};
+
+#endif // SRC_VOXELOCTREE_H_
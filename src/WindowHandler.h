@@ -17,6 +17,7 @@
 
 #include "TotalFrame.h"
 #include "Util.h"
+#include "GLDispatch.h"
 
 /*
 ABOUT:
@@ -24,6 +25,9 @@ Controls the renderer, window information and frame rate.
 
 NOTES:
 Creates OpenGL context. Can be accesed by direct reference with window_handler.context.
+On GLDispatch's null backend no window or context is created (window and context stay null) and Update() has nothing to swap, for headless replays.
+Call WaitForNextFrame() at the top of the main loop. With nothing to render and nothing animating it blocks until an event arrives, so an idle editor uses no CPU and input is handled as soon as it comes in.
+Otherwise frames are paced to target_fps on the performance counter: sleep until shortly before the frame is due, then spin the rest, since a sleep can overshoot.
 */
 
 class WindowHandler {
@@ -36,13 +40,17 @@ class WindowHandler {
         SDL_Window* window = nullptr;
         Uint16 width, height;
         float target_fps;
-        SDL_GLContext context;
+        SDL_GLContext context = nullptr;
         float aspect_ratio = 0.0f;
 
         ////////// RENDERING
         void Update();
         void Clear();
 
+        ////////// FRAME PACING
+        // animating keeps frames coming with no events (camera movement, replays)
+        void WaitForNextFrame(bool animating);
+
         ////////// DELTA TIME
         void UpdateDeltaTime(Uint64 current_app_time, Uint64 time_frequency);
 
@@ -51,6 +59,8 @@ class WindowHandler {
         bool StartRender();
         void EndRender();
         void SetColor(SDL_FColor color);
+        // 0 removes the frame cap
+        void SetTargetFps(float target_fps);
 
         void PassNamePtr(const std::shared_ptr<std::string>& name);
         void UpdateName();
@@ -67,6 +77,15 @@ class WindowHandler {
 
         std::shared_ptr<std::string> current_file_name = std::make_shared<std::string>();
 
+        ////////// FRAME PACING
+        // the last part of a frame wait is spun instead of slept
+        static constexpr double SPIN_MILLISECONDS = 2.0;
+        // the loop still comes around this often while idle
+        static constexpr Sint32 MAX_IDLE_WAIT = 500;
+
+        // performance counter the current frame was due at
+        Uint64 frame_due = 0;
+
         ////////// DELTA TIME
         float frame_duration = 0.0f;
         Uint64 last_app_time = 0;
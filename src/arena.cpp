@@ -0,0 +1,88 @@
+#include "Arena.h"
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+Arena::Arena(size_t p_chunk_size) : chunk_size(p_chunk_size) {
+    ;
+}
+
+//=============================
+// ALLOCATION FUNCTIONS
+//=============================
+
+void* Arena::Allocate(size_t size, size_t alignment) {
+    if (size == 0) size = 1;
+
+    if (current_chunk < chunks.size()) {
+        Chunk& chunk = chunks[current_chunk];
+        uintptr_t base = reinterpret_cast<uintptr_t>(chunk.memory.get());
+        size_t aligned_offset = ((base + current_offset + alignment - 1) & ~(uintptr_t(alignment) - 1)) - base;
+
+        if (aligned_offset + size <= chunk.size) {
+            current_offset = aligned_offset + size;
+            bytes_used += size;
+            return chunk.memory.get() + aligned_offset;
+        }
+    }
+
+    Arena::_NextChunk(size, alignment);
+    return Arena::Allocate(size, alignment);
+}
+
+//=============================
+// MEMORY MANAGEMENT
+//=============================
+
+void Arena::Reset() {
+    current_chunk = 0;
+    current_offset = 0;
+    bytes_used = 0;
+}
+
+void Arena::FreeAll() {
+    chunks.clear();
+    Arena::Reset();
+}
+
+//=============================
+// GETTERS
+//=============================
+
+size_t Arena::GetBytesUsed() const {
+    return bytes_used;
+}
+
+size_t Arena::GetTotalChunks() const {
+    return chunks.size();
+}
+
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
+
+void Arena::_NextChunk(size_t size, size_t alignment) {
+    size_t needed_size = size + alignment;
+
+    // reuse the kept chunks first. one too small for this request is skipped, not lost, the next Reset() starts over
+    for (size_t chunk = current_chunk + 1; chunk < chunks.size(); chunk++) {
+        if (chunks[chunk].size >= needed_size) {
+            std::swap(chunks[current_chunk + 1], chunks[chunk]);
+            current_chunk++;
+            current_offset = 0;
+            return;
+        }
+    }
+
+    Chunk new_chunk;
+    new_chunk.size = std::max(chunk_size, needed_size);
+    // left uninitialized, AllocateArray() initializes what it hands out
+    new_chunk.memory = std::unique_ptr<std::byte[]>(new std::byte[new_chunk.size]);
+
+    // an empty arena starts at chunk 0, otherwise the new chunk goes right after the current one
+    size_t insert_index = chunks.empty() ? 0 : current_chunk + 1;
+    chunks.insert(chunks.begin() + insert_index, std::move(new_chunk));
+    current_chunk = insert_index;
+    current_offset = 0;
+}
@@ -38,7 +38,7 @@ void AudioHandler::LoadMusic(std::string name, std::string path) {
 
 void AudioHandler::PlaySound(std::string name, int n, Uint8 volume) {
     if (!sound_bank.count(name) == 0) {
-        Util::ThrowError("SOUND: " + name + " DOES NOT EXIST", "AudioHandler::PlaySound");
+        TF_LOG_ERROR("SOUND: " + name + " DOES NOT EXIST", "AudioHandler::PlaySound");
         return;
     }
     if (muted) return;
@@ -49,7 +49,7 @@ void AudioHandler::PlaySound(std::string name, int n, Uint8 volume) {
 
 void AudioHandler::PlayMusic(std::string name, int n, Uint8 volume) {
     if (!music_bank.count(name) == 0) {
-        Util::ThrowError("MUSIC: " + name + " DOES NOT EXIST", "AudioHandler::PlayMusic");
+        TF_LOG_ERROR("MUSIC: " + name + " DOES NOT EXIST", "AudioHandler::PlayMusic");
         return;
     }
     if (muted) return;
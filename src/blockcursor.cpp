@@ -29,4 +29,26 @@ void BlockCursor::PlaceOnFace(glm::vec3 p_cube_position, glm::vec3 face_pos) {
 
 glm::vec3 BlockCursor::NextCubePosition() {
     return cube.GetPosition();
+}
+
+void BlockCursor::InvalidateHover() {
+    hover_stale = true;
+}
+
+bool BlockCursor::UpdateHover(Object& object, Camera& camera, float mouse_x, float mouse_y) {
+    if (!hover_stale) return false;
+    hover_stale = false;
+
+    bool was_visible = visible;
+    glm::vec3 previous_translation = current_translation;
+
+    glm::vec3 face_hit_pos;
+    hovered_cube = object.GetRayCollidingCubeWithFace(camera.MouseToWorldRay(mouse_x, mouse_y), face_hit_pos);
+    BlockCursor::PlaceOnFace(object.GetCubePosition(hovered_cube), face_hit_pos);
+
+    return visible != was_visible || current_translation != previous_translation;
+}
+
+size_t BlockCursor::GetHoveredCube() const {
+    return hovered_cube;
 }
\ No newline at end of file
@@ -35,18 +35,23 @@ glm::mat4 Camera::GetProjectionMatrix() {
     return projection_matrix;
 }
 
+Camera::State Camera::GetState() {
+    return {position, yaw, pitch};
+}
+
 //=============================
 // SHADER PROGRAM FUNCTIONS
 //=============================
 
 void Camera::UpdateShaderProgram(GLuint shader_program) {
-    glUseProgram(shader_program);
+    GLDispatch::Subsystem gl_subsystem("Camera");
+    GLDispatch::UseProgram(shader_program);
 
     // pass view and projection to shader program
-    GLuint view_location = glGetUniformLocation(shader_program, "view");
-    GLuint projection_location = glGetUniformLocation(shader_program, "projection");
-    glUniformMatrix4fv(view_location, 1, GL_FALSE, glm::value_ptr(view_matrix));
-    glUniformMatrix4fv(projection_location, 1, GL_FALSE, glm::value_ptr(projection_matrix));
+    GLuint view_location = GLDispatch::GetUniformLocation(shader_program, "view");
+    GLuint projection_location = GLDispatch::GetUniformLocation(shader_program, "projection");
+    GLDispatch::UniformMatrix4fv(view_location, 1, GL_FALSE, glm::value_ptr(view_matrix));
+    GLDispatch::UniformMatrix4fv(projection_location, 1, GL_FALSE, glm::value_ptr(projection_matrix));
 }
 
 void Camera::UpdateShaderPrograms(std::vector<GLuint> shader_programs) {
@@ -88,6 +93,10 @@ void Camera::StopMove(SDL_Keycode key) {
     move_queue.Remove(key);
 }
 
+bool Camera::IsMoving() {
+    return move_queue.move_dir[0] != 0 || move_queue.move_dir[1] != 0 || move_queue.move_dir[2] != 0;
+}
+
 //=============================
 // MOUSE MOVEMENT FUNCTIONS
 //=============================
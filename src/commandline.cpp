@@ -0,0 +1,444 @@
+#include "CommandLine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <set>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+//=============================
+// BASIC FUNCTIONS
+//=============================
+
+bool CommandLine::IsHeadless(int argc, char* argv[]) {
+    return argc > 1 && std::strcmp(argv[1], "--headless") == 0;
+}
+
+int CommandLine::Run(int argc, char* argv[]) {
+    CommandLine::AttachParentConsole();
+
+    Options options;
+    if (!CommandLine::_Parse(std::vector<std::string>(argv + 1, argv + argc), options)) {
+        CommandLine::_PrintUsage();
+        return 1;
+    }
+
+    // before anything can make an OpenGL call
+    GLDispatch::SetBackend(GLDispatch::NULL_BACKEND);
+
+    if (!options.export_directory.empty()) return CommandLine::_RunBatch(options);
+    return CommandLine::_RunSingle(options);
+}
+
+void CommandLine::AttachParentConsole() {
+#ifdef _WIN32
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        std::freopen("CONOUT$", "w", stdout);
+        std::freopen("CONOUT$", "w", stderr);
+    }
+#endif
+}
+
+//=============================
+// MODES
+//=============================
+
+int CommandLine::_RunSingle(const Options& options) {
+    const std::string& input_path = options.input_paths[0];
+
+    JobSystem job_system;
+    Camera camera(options.camera_position, WINDOW_WIDTH, WINDOW_HEIGHT, 0.025f, 0.1f, 70.0f);
+    LightHandler light_handler;
+    light_handler.Create(glm::vec3(4.0f, 12.0f, 8.0f), glm::vec3(1.0f), 1.5f);
+
+    // a name from the null backend, only used to group cubes by program
+    GLuint cube_sp = GLDispatch::CreateProgram();
+    Object object(TotalFrame::OBJECT_TYPE::CUBE_OBJ, float(WINDOW_WIDTH) / float(WINDOW_HEIGHT), &job_system);
+
+    //// LOAD
+    if (!std::filesystem::is_regular_file(input_path)) {
+        TF_LOG_ERROR("INPUT FILE DOES NOT EXIST: " + input_path, "CommandLine::_RunSingle");
+        return 1;
+    }
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    object.ClearAndCreate(std::filesystem::path(input_path).filename().string(), TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, input_path, cube_sp);
+    double load_time = Util::GetElapsedMilliseconds(start);
+    Logger::Flush();
+    std::printf("load      %zu cubes in %.2f ms\n", object.GetTotalCubes(), load_time);
+
+    //// TRANSFORM
+    if (options.translation != glm::vec3(0.0f)) {
+        start = SDL_GetPerformanceCounter();
+        object.Translate(options.translation);
+        double translate_time = Util::GetElapsedMilliseconds(start);
+        Logger::Flush();
+        std::printf("translate %.2f ms\n", translate_time);
+    }
+
+    if (options.hollow) {
+        start = SDL_GetPerformanceCounter();
+        size_t total_removed = object.Hollow();
+        double hollow_time = Util::GetElapsedMilliseconds(start);
+        Logger::Flush();
+        std::printf("hollow    %zu cubes removed in %.2f ms\n", total_removed, hollow_time);
+    }
+
+    //// INDEX
+    int exit_code = 0;
+
+    if (options.check_index) {
+        start = SDL_GetPerformanceCounter();
+        bool matched = object.CheckLatticeIndex();
+        double index_time = Util::GetElapsedMilliseconds(start);
+        Logger::Flush();
+        std::printf("index     round trip %s in %.2f ms\n", matched ? "matched" : "DIFFERS", index_time);
+        if (!matched) exit_code = 1;
+    }
+
+    //// CULL
+    glm::mat4 view_projection = camera.GetProjectionMatrix() * camera.GetViewMatrix();
+
+    start = SDL_GetPerformanceCounter();
+    object.UpdateAll(view_projection, camera.position);
+    Object::CullStats cull_stats = object.GetCullStats();
+    double cull_time = Util::GetElapsedMilliseconds(start);
+    Logger::Flush();
+    std::printf("cull      %zu in frustum, %zu visible of %zu in %.2f ms\n", cull_stats.frustum_visible_cubes, cull_stats.occlusion_visible_cubes, cull_stats.total_cubes, cull_time);
+
+    //// FRAMES
+    // full update and render, drawing into the null backend
+    if (options.frames > 0) {
+        std::vector<double> frame_times = {};
+        frame_times.reserve(options.frames);
+        Uint64 total_gl_calls = 0;
+
+        for (size_t frame = 0; frame < options.frames; frame++) {
+            start = SDL_GetPerformanceCounter();
+            object.UpdateAll(view_projection, camera.position);
+            object.RenderAll(camera.position, light_handler.lights);
+            frame_times.push_back(Util::GetElapsedMilliseconds(start));
+
+            GLDispatch::EndFrame();
+            total_gl_calls += GLDispatch::GetLastFrameStats().total_calls;
+        }
+
+        std::sort(frame_times.begin(), frame_times.end());
+        Logger::Flush();
+        std::printf("frames    %zu, p50 %.3f ms, max %.3f ms, %.1f GL calls per frame\n", options.frames, Util::GetPercentile(frame_times, 0.5), Util::GetPercentile(frame_times, 1.0), double(total_gl_calls) / double(options.frames));
+    }
+
+    //// SAVE
+    if (!options.save_path.empty()) {
+        start = SDL_GetPerformanceCounter();
+        bool saved = CommandLine::_WriteFile(options.save_path, object.GetData()) && object.SaveLatticeIndex(options.save_path);
+        double save_time = Util::GetElapsedMilliseconds(start);
+        Logger::Flush();
+        if (saved) std::printf("save      %s in %.2f ms\n", options.save_path.c_str(), save_time);
+        else exit_code = 1;
+    }
+
+    if (!options.export_path.empty()) {
+        start = SDL_GetPerformanceCounter();
+        bool exported = CommandLine::_WriteFile(options.export_path, object.GetExportData());
+        double export_time = Util::GetElapsedMilliseconds(start);
+        Logger::Flush();
+        if (exported) std::printf("export    %s in %.2f ms\n", options.export_path.c_str(), export_time);
+        else exit_code = 1;
+    }
+
+    object.FreeAll();
+    return exit_code;
+}
+
+int CommandLine::_RunBatch(const Options& options) {
+    int exit_code = 0;
+
+    std::vector<std::filesystem::path> input_paths = {};
+    for (const std::string& pattern : options.input_paths) {
+        if (!CommandLine::_ExpandPattern(pattern, input_paths)) {
+            TF_LOG_ERROR("NO .tfobj_dev FILES MATCH: " + pattern, "CommandLine::_RunBatch");
+            exit_code = 1;
+        }
+    }
+
+    // overlapping patterns would export the same file twice
+    std::sort(input_paths.begin(), input_paths.end());
+    input_paths.erase(std::unique(input_paths.begin(), input_paths.end()), input_paths.end());
+    if (input_paths.empty()) return 1;
+
+    std::error_code error;
+    std::filesystem::create_directories(options.export_directory, error);
+    if (error || !std::filesystem::is_directory(options.export_directory)) {
+        TF_LOG_ERROR("FAILED TO CREATE EXPORT DIRECTORY: " + options.export_directory, "CommandLine::_RunBatch");
+        return 1;
+    }
+
+    // outputs are flat, two inputs with the same name from different directories would overwrite each other
+    std::vector<BatchResult> results(input_paths.size());
+    std::set<std::filesystem::path> output_paths = {};
+    for (size_t i = 0; i < input_paths.size(); i++) {
+        results[i].input_path = input_paths[i];
+        results[i].output_path = std::filesystem::path(options.export_directory) / (input_paths[i].stem().string() + ".tfobj");
+        if (!output_paths.insert(results[i].output_path).second) results[i].error = "OUTPUT NAME ALREADY USED BY ANOTHER INPUT";
+    }
+
+    // the calling thread runs jobs too while it waits, so N threads is N - 1 workers. --jobs 1 runs everything on this thread
+    JobSystem job_system(options.jobs > 1 ? options.jobs - 1 : options.jobs);
+    bool serial = options.jobs == 1;
+    JobSystem::Counter counter;
+    std::mutex print_mutex;
+
+    Logger::Flush();
+    std::printf("batch     %zu files on %u threads -> %s\n", results.size(), serial ? 1 : job_system.ThreadCount(), options.export_directory.c_str());
+    std::fflush(stdout);
+
+    auto ExportAndPrint = [&options, &print_mutex](BatchResult& result) {
+        CommandLine::_ExportFile(options, result);
+
+        // printed as files finish so long batches show progress
+        std::lock_guard<std::mutex> lock(print_mutex);
+        Logger::Flush();
+        if (result.succeeded) std::printf("  %9.2f ms  %8zu cubes  load %.2f  export %.2f  %s\n", result.total_time, result.total_cubes, result.load_time, result.export_time, result.output_path.string().c_str());
+        else std::printf("  FAILED  %s: %s\n", result.input_path.string().c_str(), result.error.c_str());
+        std::fflush(stdout);
+    };
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    for (BatchResult& result : results) {
+        if (!result.error.empty()) continue;
+
+        if (serial) ExportAndPrint(result);
+        else job_system.Submit([&ExportAndPrint, &result]() { ExportAndPrint(result); }, &counter);
+    }
+    job_system.Wait(counter);
+    double wall_time = Util::GetElapsedMilliseconds(start);
+
+    //// SUMMARY
+    size_t total_exported = 0;
+    size_t total_cubes = 0;
+    double total_file_time = 0.0;
+    const BatchResult* slowest = nullptr;
+
+    for (const BatchResult& result : results) {
+        if (!result.succeeded) continue;
+        total_exported++;
+        total_cubes += result.total_cubes;
+        total_file_time += result.total_time;
+        if (slowest == nullptr || result.total_time > slowest->total_time) slowest = &result;
+    }
+
+    Logger::Flush();
+    std::printf("exported  %zu of %zu files, %zu cubes\n", total_exported, results.size(), total_cubes);
+    std::printf("time      %.2f ms wall, %.2f ms summed over files (%.2fx)\n", wall_time, total_file_time, wall_time > 0.0 ? total_file_time / wall_time : 0.0);
+    if (slowest != nullptr) std::printf("slowest   %.2f ms %s\n", slowest->total_time, slowest->input_path.string().c_str());
+
+    // repeated at the end so failures don't get lost in a long listing
+    for (const BatchResult& result : results) {
+        if (result.succeeded) continue;
+        std::printf("failed    %s: %s\n", result.input_path.string().c_str(), result.error.c_str());
+        exit_code = 1;
+    }
+
+    return exit_code;
+}
+
+void CommandLine::_ExportFile(const Options& options, BatchResult& result) {
+    Uint64 file_start = SDL_GetPerformanceCounter();
+
+    // no job system, see NOTES. the shader program is only a grouping key and nothing is rendered, so 0 does
+    Object object(TotalFrame::OBJECT_TYPE::CUBE_OBJ, float(WINDOW_WIDTH) / float(WINDOW_HEIGHT), nullptr);
+
+    Uint64 start = SDL_GetPerformanceCounter();
+    object.ClearAndCreate(result.input_path.filename().string(), TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, result.input_path.string(), 0);
+    result.load_time = Util::GetElapsedMilliseconds(start);
+    result.total_cubes = object.GetTotalCubes();
+
+    if (result.total_cubes == 0) {
+        result.error = "NO CUBES LOADED";
+        result.total_time = Util::GetElapsedMilliseconds(file_start);
+        return;
+    }
+
+    start = SDL_GetPerformanceCounter();
+    if (options.translation != glm::vec3(0.0f)) object.Translate(options.translation);
+    if (options.hollow) object.Hollow();
+    result.transform_time = Util::GetElapsedMilliseconds(start);
+    result.total_cubes = object.GetTotalCubes();
+
+    start = SDL_GetPerformanceCounter();
+    if (CommandLine::_WriteFile(result.output_path.string(), object.GetExportData())) result.succeeded = true;
+    else result.error = "FAILED TO WRITE " + result.output_path.string();
+    result.export_time = Util::GetElapsedMilliseconds(start);
+
+    result.total_time = Util::GetElapsedMilliseconds(file_start);
+}
+
+//=============================
+// PARSING FUNCTIONS
+//=============================
+
+bool CommandLine::_Parse(const std::vector<std::string>& arguments, Options& options_out) {
+    if (arguments.empty() || arguments[0] != "--headless") return false;
+
+    // reads count numbers following arguments[i], false if they are missing or not numbers
+    auto ReadNumbers = [&](size_t& i, size_t count, float* numbers_out) {
+        if (i + count >= arguments.size()) return false;
+        for (size_t n = 0; n < count; n++) {
+            try {
+                numbers_out[n] = std::stof(arguments[++i]);
+            } catch (...) {
+                return false;
+            }
+        }
+        return true;
+    };
+
+    for (size_t i = 1; i < arguments.size(); i++) {
+        const std::string& argument = arguments[i];
+
+        if (argument == "--translate") {
+            if (!ReadNumbers(i, 3, &options_out.translation[0])) return false;
+        } else if (argument == "--hollow") {
+            options_out.hollow = true;
+        } else if (argument == "--check-index") {
+            options_out.check_index = true;
+        } else if (argument == "--camera") {
+            if (!ReadNumbers(i, 3, &options_out.camera_position[0])) return false;
+        } else if (argument == "--frames") {
+            float frames = 0.0f;
+            if (!ReadNumbers(i, 1, &frames) || frames < 0.0f) return false;
+            options_out.frames = size_t(frames);
+        } else if (argument == "--save") {
+            if (++i >= arguments.size()) return false;
+            options_out.save_path = arguments[i];
+        } else if (argument == "--export") {
+            if (++i >= arguments.size()) return false;
+            options_out.export_path = arguments[i];
+        } else if (argument == "--export-dir") {
+            if (++i >= arguments.size()) return false;
+            options_out.export_directory = arguments[i];
+        } else if (argument == "--jobs") {
+            float jobs = 0.0f;
+            if (!ReadNumbers(i, 1, &jobs) || jobs < 1.0f) return false;
+            options_out.jobs = (unsigned int)jobs;
+        } else if (argument.rfind("--", 0) != 0) {
+            options_out.input_paths.push_back(argument);
+        } else {
+            TF_LOG_ERROR("UNKNOWN ARGUMENT: " + argument, "CommandLine::_Parse");
+            return false;
+        }
+    }
+
+    if (options_out.input_paths.empty()) return false;
+
+    if (!options_out.export_directory.empty()) {
+        if (options_out.frames > 0 || options_out.check_index || !options_out.save_path.empty() || !options_out.export_path.empty()) {
+            TF_LOG_ERROR("--frames, --check-index, --save AND --export NEED A SINGLE INPUT, NOT --export-dir", "CommandLine::_Parse");
+            return false;
+        }
+    } else if (options_out.input_paths.size() > 1 || options_out.jobs > 0) {
+        TF_LOG_ERROR("MORE THAN ONE INPUT AND --jobs NEED --export-dir", "CommandLine::_Parse");
+        return false;
+    }
+
+    return true;
+}
+
+void CommandLine::_PrintUsage() {
+    // after the error that led here
+    Logger::Flush();
+    std::printf("usage: --headless INPUT.tfobj_dev [--translate X Y Z] [--hollow] [--check-index] [--camera X Y Z] [--frames N] [--save PATH.tfobj_dev] [--export PATH.tfobj]\n");
+    std::printf("       --headless --export-dir DIR PATTERN... [--translate X Y Z] [--hollow] [--jobs N]\n");
+}
+
+bool CommandLine::_ExpandPattern(const std::string& pattern, std::vector<std::filesystem::path>& paths_out) {
+    size_t total_paths = paths_out.size();
+    std::error_code error;
+
+    auto IsObjectFile = [](const std::filesystem::directory_entry& entry) {
+        return entry.is_regular_file() && entry.path().extension() == ".tfobj_dev";
+    };
+
+    std::filesystem::path pattern_path(pattern);
+
+    //// PLAIN PATHS
+    if (pattern.find_first_of("*?") == std::string::npos) {
+        if (std::filesystem::is_regular_file(pattern_path, error)) {
+            paths_out.push_back(pattern_path);
+        } else if (std::filesystem::is_directory(pattern_path, error)) {
+            for (const auto& entry : std::filesystem::directory_iterator(pattern_path, error)) {
+                if (IsObjectFile(entry)) paths_out.push_back(entry.path());
+            }
+        }
+        return paths_out.size() > total_paths;
+    }
+
+    //// WILDCARDS
+    // only the file name may have wildcards, apart from a "**" directory meaning every directory below
+    std::filesystem::path directory = pattern_path.parent_path();
+    std::string name_pattern = pattern_path.filename().string();
+    bool recursive = directory.filename() == "**";
+    if (recursive) directory = directory.parent_path();
+    if (directory.empty()) directory = ".";
+
+    if (directory.string().find_first_of("*?") != std::string::npos) {
+        TF_LOG_ERROR("WILDCARDS ARE ONLY SUPPORTED IN FILE NAMES: " + pattern, "CommandLine::_ExpandPattern");
+        return false;
+    }
+
+    auto AddIfMatches = [&](const std::filesystem::directory_entry& entry) {
+        if (IsObjectFile(entry) && CommandLine::_MatchWildcard(name_pattern.c_str(), entry.path().filename().string().c_str())) paths_out.push_back(entry.path());
+    };
+
+    if (recursive) {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(directory, error)) AddIfMatches(entry);
+    } else {
+        for (const auto& entry : std::filesystem::directory_iterator(directory, error)) AddIfMatches(entry);
+    }
+
+    return paths_out.size() > total_paths;
+}
+
+bool CommandLine::_MatchWildcard(const char* pattern, const char* text) {
+    // greedy match that backtracks to the last *, linear for patterns with a single *
+    const char* star = nullptr;
+    const char* star_text = nullptr;
+
+    while (*text != '\0') {
+        if (*pattern == '?' || *pattern == *text) {
+            pattern++;
+            text++;
+        } else if (*pattern == '*') {
+            star = pattern++;
+            star_text = text;
+        } else if (star != nullptr) {
+            pattern = star + 1;
+            text = ++star_text;
+        } else {
+            return false;
+        }
+    }
+
+    while (*pattern == '*') pattern++;
+    return *pattern == '\0';
+}
+
+//=============================
+// OUTPUT FUNCTIONS
+//=============================
+
+bool CommandLine::_WriteFile(const std::string& path, const std::string& data) {
+    std::ofstream out_file(path, std::ios::out | std::ios::trunc);
+    if (!out_file) {
+        TF_LOG_ERROR("FAILED TO OPEN FILE: " + path, "CommandLine::_WriteFile");
+        return false;
+    }
+
+    out_file << data;
+    return true;
+}
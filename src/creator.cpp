@@ -16,16 +16,20 @@ std::shared_ptr<std::string> Creator::GetName() {
     return object_name;
 }
 
+std::string Creator::GetPath() {
+    return object_path;
+}
+
 //=============================
 // CUBE DEFAULT FUNCTIONS
 //=============================
 
-void Creator::SetCubeDefault(Cube cube) {
-    cube_default = cube;
-    adjusted_cube_default = cube;
+void Creator::SetCubeDefault(Cube&& cube) {
+    cube_default = std::move(cube);
+    adjusted_cube_default = cube_default.Clone();
 }
 
-Cube Creator::GetCubeDefault() {
+Cube& Creator::GetCubeDefault() {
     return adjusted_cube_default;
 }
 
@@ -41,23 +45,26 @@ void Creator::UpdateCubeDefaultPosition(glm::vec3 position) {
 // SAVING FUNCTIONS
 //=============================
 
-void Creator::Save(std::string object_data) {
+bool Creator::Save(std::string object_data) {
+    TF_PROFILE_SCOPE("Creator::Save");
     // if untitled (not yet saved), create a new object. if the user exits, cancel save and return
-    if (*object_name == "untitled") if (!Creator::NewObject()) return;
+    if (*object_name == "untitled") if (!Creator::NewObject()) return false;
 
     std::ofstream out_file(object_path, std::ios::out | std::ios::trunc);
 
     if (!out_file) {
-        Util::ThrowError("FAILED TO OPEN FILE", "Creator::Save");
-        return;
+        TF_LOG_ERROR("FAILED TO OPEN FILE", "Creator::Save");
+        return false;
     }
 
     out_file << object_data;
 
     out_file.close();
+    return !out_file.fail();
 }
 
 bool Creator::NewObject() {
+    TF_PROFILE_SCOPE("Creator::NewObject");
     const char * temp_path = tinyfd_saveFileDialog("New TotalFrame Development Object", ".tfobj_dev", 1, filter_patterns, "TotalFrame Development Object File *.tfobj_dev");
     if (temp_path == NULL) {
         return false;
@@ -72,13 +79,14 @@ bool Creator::NewObject() {
 }
 
 bool Creator::Export(std::string object_data) {
+    TF_PROFILE_SCOPE("Creator::Export");
     // if untitled (not yet saved), create a new object. if the user exits, cancel save and return
     if (!Creator::NewExport()) return false;
 
     std::ofstream out_file(exports_path, std::ios::out | std::ios::trunc);
 
     if (!out_file) {
-        Util::ThrowError("FAILED TO OPEN FILE", "Creator::Export");
+        TF_LOG_ERROR("FAILED TO OPEN FILE", "Creator::Export");
         return false;
     }
 
@@ -90,6 +98,7 @@ bool Creator::Export(std::string object_data) {
 }
 
 bool Creator::NewExport() {
+    TF_PROFILE_SCOPE("Creator::NewExport");
     const char * temp_path = tinyfd_saveFileDialog("New TotalFrame Object", ".tfobj", 1, export_filter_patterns, "TotalFrame Object File *.tfobj");
     if (temp_path == NULL) {
         return false;
@@ -107,6 +116,7 @@ bool Creator::NewExport() {
 //=============================
 
 std::string Creator::Load() {
+    TF_PROFILE_SCOPE("Creator::Load");
     const char* temp_path = tinyfd_openFileDialog("Load TotalFrame Development Object", objects_path.c_str(), 1, filter_patterns, "TotalFrame Development Object File *.tfobj_dev", 0);
     if (temp_path == NULL) {
         return "\n";
@@ -125,6 +135,7 @@ std::string Creator::Load() {
 //=============================
 
 void Creator::ChooseColor() {
+    TF_PROFILE_SCOPE("Creator::ChooseColor");
     unsigned char temp_color[3] = {255, 255, 255};
 
     const char* picked_color = tinyfd_colorChooser("Pick a Color", NULL, temp_color, temp_color);
@@ -137,6 +148,7 @@ void Creator::ChooseColor() {
     // alpha channel
     color[3] = 1.0f;
 
+    cube_default.SetColor(color);
     adjusted_cube_default.SetColor(color);
 }
 
@@ -144,5 +156,15 @@ void Creator::SetCubeDefaultColor(glm::vec3 p_color) {
     if (p_color != glm::vec3(-1000.0f)) {
         color = glm::vec4(p_color[0], p_color[1], p_color[2], 1.0f);
         cube_default.SetColor(color);
+        adjusted_cube_default.SetColor(color);
     }
+}
+
+//=============================
+// MEMORY MANAGEMENT
+//=============================
+
+void Creator::FreeAll() {
+    cube_default.FreeAll();
+    adjusted_cube_default.FreeAll();
 }
\ No newline at end of file
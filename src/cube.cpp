@@ -27,18 +27,29 @@ void Cube::Create(std::string p_name, glm::vec3 p_position, float p_size, std::s
     glm::vec3 temp_position = glm::vec3(0.0f);
     Cube::Load(p_path, temp_position, data_str);
 
-    // if position is being read from file, read from file then set position, otherwise set defined position
-    if (p_position == TotalFrame::READ_POS_FROM_FILE) Cube::SetPosition(temp_position);
-    else Cube::SetPosition(p_position);
+    Cube::_Finish(p_position, temp_position, p_size);
+}
 
-    // size
-    if (p_size == TotalFrame::READ_SIZE_FROM_FILE) size = glm::vec3(Cube::_ReadSize());
+void Cube::Create(std::string p_name, glm::vec3 p_position, float p_size, GLuint p_shader_program, float p_aspect_ratio, const TotalFrame::CubeData& data) {
+    name = p_name;
+    size = glm::vec3(p_size);
+    shader_program = p_shader_program;
+    aspect_ratio = p_aspect_ratio;
+    path = "";
 
-    *initial_model_matrix = *model_matrix;
+    triangles[shader_program] = Cube::_CreateFromData(data);
 
-    Cube::UpdateStretch();
+    Cube::_Finish(p_position, data.position, p_size);
+}
 
-    Cube::_BuildLines();
+Cube Cube::Clone() {
+    TotalFrame::CubeData data;
+    Cube::Parse(Cube::GetData(), data);
+
+    Cube temp_cube;
+    temp_cube.Create(name, TotalFrame::READ_POS_FROM_FILE, size[0], shader_program, aspect_ratio, data);
+    temp_cube.path = path;
+    return temp_cube;
 }
 
 void Cube::Load(std::string path, glm::vec3& p_position_out, std::string data_str) {
@@ -51,31 +62,41 @@ void Cube::Load(std::string path, glm::vec3& p_position_out, std::string data_st
 }
 
 void Cube::Render(glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights) {
+    TF_PROFILE_SCOPE("Cube::Render");
+    GLDispatch::Subsystem gl_subsystem("Cube");
+    if (!lines_vertex_array) Cube::_BuildLines();
     Cube::_BuildRenderLines();
 
     // render all triangles
     for (auto& [shader_program, triangles_i] : triangles) {
-        glUseProgram(shader_program);
+        GLDispatch::UseProgram(shader_program);
 
-        glUniformMatrix4fv(glGetUniformLocation(shader_program, "model_matrix"), 1, GL_FALSE, glm::value_ptr(*stretched_model_matrix));
+        // the vertices are quantized, scale them back up as part of the model matrix
+        glm::mat4 render_model_matrix = glm::scale(stretched_model_matrix, glm::vec3(position_scale / TotalFrame::POSITION_QUANTIZATION));
+        GLDispatch::UniformMatrix4fv(GLDispatch::GetUniformLocation(shader_program, "model_matrix"), 1, GL_FALSE, glm::value_ptr(render_model_matrix));
+        // standalone cubes keep their colors in the vertices
+        GLDispatch::Uniform4f(GLDispatch::GetUniformLocation(shader_program, "cube_color"), 1.0f, 1.0f, 1.0f, 1.0f);
+        // the program may have last drawn an Object, which reads its cubes from the record buffer instead
+        GLDispatch::Uniform1i(GLDispatch::GetUniformLocation(shader_program, "instanced"), GL_FALSE);
 
-        glUniform3fv(glGetUniformLocation(shader_program, "light_position"), 1, glm::value_ptr(lights[0]->position));
-        glUniform1f(glGetUniformLocation(shader_program, "light_intensity"), lights[0]->intensity);
-        glUniform3fv(glGetUniformLocation(shader_program, "view_position"), 1, glm::value_ptr(camera_position));
+        GLDispatch::Uniform3fv(GLDispatch::GetUniformLocation(shader_program, "light_position"), 1, glm::value_ptr(lights[0]->position));
+        GLDispatch::Uniform1f(GLDispatch::GetUniformLocation(shader_program, "light_intensity"), lights[0]->intensity);
+        GLDispatch::Uniform3fv(GLDispatch::GetUniformLocation(shader_program, "view_position"), 1, glm::value_ptr(camera_position));
 
         // set normal matrix
-        glUniformMatrix3fv(glGetUniformLocation(shader_program, "normal_matrix"), 1, GL_FALSE, glm::value_ptr(*normal_matrix));
+        GLDispatch::UniformMatrix3fv(GLDispatch::GetUniformLocation(shader_program, "normal_matrix"), 1, GL_FALSE, glm::value_ptr(normal_matrix));
 
         for (auto& triangle : triangles_i) {
             triangle.Render();
         }
     }
     
-    glUniformMatrix4fv(glGetUniformLocation(shader_program, "model_matrix"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
+    GLDispatch::UniformMatrix4fv(GLDispatch::GetUniformLocation(shader_program, "model_matrix"), 1, GL_FALSE, glm::value_ptr(glm::mat4(1.0f)));
     Cube::_RenderLines();
 }
 
 std::string Cube::GetData() {
+    TF_PROFILE_SCOPE("Cube::GetData");
     std::string temp_data = "";
 
     glm::vec3 temp_position = Cube::GetPosition();
@@ -103,17 +124,60 @@ void Cube::Verify() {
     for (auto& [shader_program, triangles_i] : triangles) {
         for (auto& triangle : triangles_i) {
             if (triangle.Verify() == false) {
-                Util::ThrowError("INVALID VERTEX ARRAY", "Cube::Verify");
+                TF_LOG_ERROR("INVALID VERTEX ARRAY", "Cube::Verify");
             }
         }
     }
 }
 
+bool Cube::Parse(const std::string& data_str, TotalFrame::CubeData& data_out) {
+    TF_PROFILE_SCOPE("Cube::Parse");
+    data_out.position = glm::vec3(0.0f);
+    data_out.triangles_vertices.clear();
+
+    std::istringstream stream(data_str);
+    std::string line = "";
+    bool first_line = true;
+
+    while (std::getline(stream, line)) {
+        if (line.empty()) continue;
+
+        // read through each number of the line
+        std::vector<GLfloat> temp_values = {};
+        std::string temp_number_str = "";
+        for (const auto& letter : line) {
+            if (letter == ' ') {
+                if (!temp_number_str.empty()) temp_values.push_back(std::stof(temp_number_str));
+                temp_number_str = "";
+                continue;
+            }
+            temp_number_str += letter;
+        }
+        if (!temp_number_str.empty()) temp_values.push_back(std::stof(temp_number_str));
+
+        // first line is the position, every other line is a set of vertices (triangle data)
+        if (first_line) {
+            if (temp_values.size() < 3) {
+                TF_LOG_ERROR("INVALID CUBE POSITION", "Cube::Parse");
+                return false;
+            }
+            data_out.position = glm::vec3(temp_values[0], temp_values[1], temp_values[2]);
+            first_line = false;
+            continue;
+        }
+
+        data_out.triangles_vertices.push_back(std::move(temp_values));
+    }
+
+    return !first_line;
+}
+
 //=============================
 // EXPORTATION FUNCTIONS
 //=============================
 
 std::vector<std::array<TotalFrame::Ray, 14>> Cube::GetCornersRays() {
+    TF_PROFILE_SCOPE("Cube::GetCornersRays");
     std::vector<glm::vec3> export_corners = {};
 
     glm::vec3 center = Cube::GetPosition();
@@ -192,6 +256,7 @@ bool Cube::RayCollidesWithCorners(TotalFrame::Ray ray, glm::vec3 ignore_point) {
 }
 
 void Cube::RemoveTrianglesByCorners(std::vector<glm::vec3> removed_corners) {
+    TF_PROFILE_SCOPE("Cube::RemoveTrianglesByCorners");
     glm::vec3 cube_pos = GetPosition();
 
     for (auto& [sp, triangles_i] : triangles) {
@@ -200,14 +265,9 @@ void Cube::RemoveTrianglesByCorners(std::vector<glm::vec3> removed_corners) {
             std::remove_if(triangles_i.begin(), triangles_i.end(),
                 [&](const Triangle& tri) {
 
-                    auto raw = tri.vertices;
-
-                    // if not valid vertices
-                    if (!raw || raw->size() < 18) return false;
-
                     // Check each of the 3 triangle vertices
-                    for (int i = 0; i < 18; i += 6) {
-                        glm::vec3 translated_vertex = glm::vec3((*raw)[i], (*raw)[i+1], (*raw)[i+2]) + cube_pos;
+                    for (const auto& vertex : tri.GetPositions()) {
+                        glm::vec3 translated_vertex = vertex + cube_pos;
 
                         // compare against removed_corners, if matches, return true and erase
                         for (const auto& corner : removed_corners) {
@@ -256,6 +316,7 @@ glm::vec3 Cube::GetColor() {
 //=============================
 
 void Cube::UpdatePosition(glm::vec3 camera_position) {
+    TF_PROFILE_SCOPE("Cube::UpdatePosition");
     glm::vec3 position = Cube::GetStretchedPosition();
 
     // find distance from camera to cube
@@ -263,21 +324,21 @@ void Cube::UpdatePosition(glm::vec3 camera_position) {
 
     // scale transformation based on model matrix scaling
     glm::vec3 stretched_scale = glm::vec3(
-        glm::length(glm::vec3((*stretched_model_matrix)[0])),
-        glm::length(glm::vec3((*stretched_model_matrix)[1])),
-        glm::length(glm::vec3((*stretched_model_matrix)[2]))
+        glm::length(glm::vec3(stretched_model_matrix[0])),
+        glm::length(glm::vec3(stretched_model_matrix[1])),
+        glm::length(glm::vec3(stretched_model_matrix[2]))
     );
     stretched_scale *= 0.5f;
 
     glm::vec3 scale = glm::vec3(
-        glm::length(glm::vec3((*model_matrix)[0])),
-        glm::length(glm::vec3((*model_matrix)[1])),
-        glm::length(glm::vec3((*model_matrix)[2]))
+        glm::length(glm::vec3(model_matrix[0])),
+        glm::length(glm::vec3(model_matrix[1])),
+        glm::length(glm::vec3(model_matrix[2]))
     );
     scale *= 0.5f;
     
     // rotate and scale the axes for obb
-    glm::mat3 rotation_matrix = glm::mat3(*model_matrix);
+    glm::mat3 rotation_matrix = glm::mat3(model_matrix);
     for (int i = 0; i < 3; i++) {
         axes[i] = rotation_matrix[i] * scale[i];
         stretched_axes[i] = rotation_matrix[i] * stretched_scale[i];
@@ -323,36 +384,49 @@ void Cube::UpdatePosition(glm::vec3 camera_position) {
 
 
 glm::vec3 Cube::GetPosition() {
-    return glm::vec3((*model_matrix)[3][0], (*model_matrix)[3][1], (*model_matrix)[3][2]);
+    return glm::vec3(model_matrix[3][0], model_matrix[3][1], model_matrix[3][2]);
 }
 
 glm::vec3 Cube::GetStretchedPosition() {
-    return glm::vec3((*stretched_model_matrix)[3][0], (*stretched_model_matrix)[3][1], (*stretched_model_matrix)[3][2]);
+    return glm::vec3(stretched_model_matrix[3][0], stretched_model_matrix[3][1], stretched_model_matrix[3][2]);
 }
 
 void Cube::SetPosition(glm::vec3 p_position) {
-    (*model_matrix)[3][0] = p_position[0];
-    (*model_matrix)[3][1] = p_position[1];
-    (*model_matrix)[3][2] = p_position[2];
+    model_matrix[3][0] = p_position[0];
+    model_matrix[3][1] = p_position[1];
+    model_matrix[3][2] = p_position[2];
 
     Cube::UpdateStretch();
 }
 
 bool Cube::IsVisible(glm::mat4 view_projection_matrix) {
-    for (auto& corner : corners) {
-        glm::vec4 clip_space_position = view_projection_matrix * glm::vec4(corner, 1.0f);
-        // normalize to -1 thru 1 by the transformation value
-        clip_space_position /= clip_space_position.w;
-    
-        // return if within screen bounds
-        if ((clip_space_position.x >= -1.0f && clip_space_position.x <= 1.0f) &&
-            (clip_space_position.y >= -1.0f && clip_space_position.y <= 1.0f) &&
-            (clip_space_position.z >= -1.0f && clip_space_position.z <= 1.0f)) {
-            return true;
-        }
+    TF_PROFILE_SCOPE("Cube::IsVisible");
+    // test the bounds against the frustum planes, a cube covering the whole screen is still visible
+    Culler::Frustum frustum;
+    frustum.Update(view_projection_matrix);
+
+    glm::vec3 center, extent;
+    Cube::GetBounds(center, extent);
+
+    return frustum.IsBoxVisible(center, extent);
+}
+
+void Cube::GetBounds(glm::vec3& center_out, glm::vec3& extent_out) {
+    if (corners.empty()) {
+        center_out = Cube::GetStretchedPosition();
+        extent_out = glm::vec3(0.0f);
+        return;
     }
 
-    return false;
+    glm::vec3 low = corners[0];
+    glm::vec3 high = corners[0];
+    for (const auto& corner : corners) {
+        low = glm::min(low, corner);
+        high = glm::max(high, corner);
+    }
+
+    center_out = (low + high) * 0.5f;
+    extent_out = (high - low) * 0.5f;
 }
 
 //=============================
@@ -365,11 +439,12 @@ void Cube::Translate(glm::vec3 translation) {
 }
 
 void Cube::ResetTranslation() {
-    *model_matrix = *initial_model_matrix;
-    *stretched_model_matrix = *initial_model_matrix;
+    model_matrix = initial_model_matrix;
+    stretched_model_matrix = initial_model_matrix;
 }
 
 void Cube::Rotate(glm::vec3 rotation) {
+    TF_PROFILE_SCOPE("Cube::Rotate");
     // Create a rotation matrix (starting from identity)
     glm::mat4 rotation_matrix = glm::mat4(1.0f);
 
@@ -379,14 +454,14 @@ void Cube::Rotate(glm::vec3 rotation) {
     rotation_matrix = glm::rotate(rotation_matrix, glm::radians(rotation.z), glm::vec3(0, 0, 1)); // Rotate around Z-axis
 
     // Accumulate the rotation by multiplying the current model_matrix by the new rotation_matrix
-    *model_matrix *= rotation_matrix;
+    model_matrix *= rotation_matrix;
     
     Cube::_CalculateUp();
     Cube::UpdateStretch();
 }
 
 void Cube::UpdateStretch() {
-    *stretched_model_matrix = *model_matrix;
+    stretched_model_matrix = model_matrix;
 
     // create a scaling matrix that scales each axis according to 'up' and the aspect ratio
     glm::mat4 stretch_matrix = glm::mat4(1.0f);
@@ -397,11 +472,11 @@ void Cube::UpdateStretch() {
     stretch_matrix[2][2] = 1.0f + up[2] * (aspect_ratio - 1.0f);  // Scale factor for Z
 
     // apply the scaling transformation
-    *stretched_model_matrix *= stretch_matrix;
+    stretched_model_matrix *= stretch_matrix;
 
-    (*stretched_model_matrix)[3] *= glm::vec4(stretch_matrix[0][0], stretch_matrix[1][1], stretch_matrix[2][2], 1.0f);
+    stretched_model_matrix[3] *= glm::vec4(stretch_matrix[0][0], stretch_matrix[1][1], stretch_matrix[2][2], 1.0f);
 
-    *normal_matrix = glm::transpose(glm::inverse(glm::mat3(*stretched_model_matrix)));
+    normal_matrix = glm::transpose(glm::inverse(glm::mat3(stretched_model_matrix)));
 
     stretched_size = size * glm::vec3(stretch_matrix[0][0], stretch_matrix[1][1], stretch_matrix[2][2]);
 
@@ -470,6 +545,7 @@ bool Cube::RayCollides(TotalFrame::Ray ray, float& tmin_out) {
 }
 
 bool Cube::RayCollidesWithFace(TotalFrame::Ray ray, float& tmin_out, glm::vec3& face_hit_normal_out) {
+    TF_PROFILE_SCOPE("Cube::RayCollidesWithFace");
     float tmin = -std::numeric_limits<float>::infinity();
     float tmax = std::numeric_limits<float>::max();
 
@@ -522,9 +598,10 @@ bool Cube::RayCollidesWithFace(TotalFrame::Ray ray, float& tmin_out, glm::vec3&
 //=============================
 
 std::vector<Triangle> Cube::_Read(std::string path, glm::vec3& p_position_out) {
+    TF_PROFILE_SCOPE("Cube::_Read");
     // return and throw error if path doesn't exist
     if (!std::filesystem::exists(path)) {
-        Util::ThrowError("INVALID CUBE PATH", "Cube::_Read");
+        TF_LOG_ERROR("INVALID CUBE PATH", "Cube::_Read");
         return {};
     }
 
@@ -541,71 +618,43 @@ std::vector<Triangle> Cube::_Read(std::string path, glm::vec3& p_position_out) {
 }
 
 std::vector<Triangle> Cube::_CreateFromStr(std::string data_str, glm::vec3& p_position_out) {
+    TF_PROFILE_SCOPE("Cube::_CreateFromStr");
+    TotalFrame::CubeData data;
+    Cube::Parse(data_str, data);
+
+    p_position_out = data.position;
+    return Cube::_CreateFromData(data);
+}
+
+std::vector<Triangle> Cube::_CreateFromData(const TotalFrame::CubeData& data) {
+    TF_PROFILE_SCOPE("Cube::_CreateFromData");
+    // create a triangle from each set of vertices, and build the triangle
     std::vector<Triangle> temp_triangles = {};
-    std::vector<std::string> temp_vertices_str = {};
-    std::vector<GLfloat> temp_vertices = {};
-    
-    glm::vec3 position_out = glm::vec3(0.0f);
-    std::vector<GLfloat> temp_position_out = {};
-    
-    // read through the entire cube data string and split it into triangle data lines
-    std::string temp_number_str = "";
-    for (const auto& letter : data_str) {
-        if (letter == '\n') {
-            temp_vertices_str.push_back(temp_number_str);
-            temp_number_str = "";
-            continue;
-        }
-        temp_number_str += letter;
-    }
+    temp_triangles.reserve(data.triangles_vertices.size());
 
-    // read through first line and set position out
-    std::string temp_number_str_pos = "";
-    for (const auto& letter : temp_vertices_str[0]) {
-        if (letter == ' ') {
-            temp_position_out.push_back(std::stof(temp_number_str_pos));
-            temp_number_str_pos = "";
-            continue;
-        }
-        temp_number_str_pos += letter;
+    // every triangle is quantized against the cube's largest coordinate so one model matrix fits them all
+    position_scale = Triangle::GetPositionScale(data.triangles_vertices);
+
+    for (const auto& vertices : data.triangles_vertices) {
+        temp_triangles.push_back(Triangle(vertices, position_scale));
     }
 
-    temp_position_out.push_back(std::stof(temp_number_str_pos));
+    return temp_triangles;
+}
 
-    position_out[0] = temp_position_out[0];
-    position_out[1] = temp_position_out[1];
-    position_out[2] = temp_position_out[2];
+void Cube::_Finish(glm::vec3 p_position, glm::vec3 read_position, float p_size) {
+    // if position is being read from file, read from file then set position, otherwise set defined position
+    if (p_position == TotalFrame::READ_POS_FROM_FILE) Cube::SetPosition(read_position);
+    else Cube::SetPosition(p_position);
 
-    // read through each set of vertices (triangle data), add to temp_vertices, create a triangle from the temp_vertices, and build the triangle
-    std::string temp_number_str_vertices = "";
-    bool first_line = true;
-    for (const auto& line : temp_vertices_str) {
-        if (!first_line) {
-            temp_vertices = {};
-            temp_number_str_vertices = "";
-
-            for (const auto& letter : line) {
-                if (letter == ' ') {
-                    GLfloat value = std::stof(temp_number_str_vertices);
-                    temp_vertices.push_back(value);
-                    
-                    temp_number_str_vertices = "";
-                    continue;
-                }
-                temp_number_str_vertices += letter;
-            }
+    // size
+    if (p_size == TotalFrame::READ_SIZE_FROM_FILE) size = glm::vec3(Cube::_ReadSize());
 
-            GLfloat value = std::stof(temp_number_str_vertices);
-            temp_vertices.push_back(value);
-            
-            temp_triangles.push_back(Triangle(temp_vertices));
-        }
-        first_line = false;
-    }
+    initial_model_matrix = model_matrix;
 
-    
-    p_position_out = position_out;
-    return temp_triangles;
+    Cube::UpdateStretch();
+
+    // the lines buffers are made by the first Render(), so cubes can be made without a context
 }
 
 float Cube::_ReadSize() {
@@ -629,7 +678,7 @@ float Cube::_ReadSize() {
 //=============================
 
 void Cube::_CalculateUp() {
-    glm::vec3 rotated_up = glm::normalize(glm::vec3(*model_matrix * glm::vec4(true_up, 0.0f)));
+    glm::vec3 rotated_up = glm::normalize(glm::vec3(model_matrix * glm::vec4(true_up, 0.0f)));
     up = glm::abs(rotated_up);
 }
 
@@ -638,32 +687,35 @@ void Cube::_CalculateUp() {
 //=============================
 
 void Cube::_BuildRenderLines() {
+    GLDispatch::Subsystem gl_subsystem("Cube");
     // update the VBO with new line data
-    glBindVertexArray(lines_vertex_array);
-    glBindBuffer(GL_ARRAY_BUFFER, lines_vertex_buffer);
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * lines_vertices.size(), lines_vertices.data());
-    glBindVertexArray(0);
+    GLDispatch::BindVertexArray(lines_vertex_array.Get());
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, lines_vertex_buffer.Get());
+    GLDispatch::BufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::vec3) * lines_vertices.size(), lines_vertices.data());
+    GLDispatch::BindVertexArray(0);
 }
 
 void Cube::_BuildLines() {
+    GLDispatch::Subsystem gl_subsystem("Cube");
     // generate line vertex buffer and array
-    glGenVertexArrays(1, &lines_vertex_array);
-    glGenBuffers(1, &lines_vertex_buffer);
+    lines_vertex_array.Create();
+    lines_vertex_buffer.Create();
 
-    glBindVertexArray(lines_vertex_array);
-    glBindBuffer(GL_ARRAY_BUFFER, lines_vertex_buffer);
+    GLDispatch::BindVertexArray(lines_vertex_array.Get());
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, lines_vertex_buffer.Get());
 
-    glBufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * lines_vertices.size(), nullptr, GL_DYNAMIC_DRAW);
+    GLDispatch::BufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * lines_vertices.size(), nullptr, GL_DYNAMIC_DRAW);
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
+    GLDispatch::VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
+    GLDispatch::EnableVertexAttribArray(0);
+    GLDispatch::BindVertexArray(0);
 }
 
 void Cube::_RenderLines() {
-    glBindVertexArray(lines_vertex_array);
-    glDrawArrays(GL_LINES, 0, lines_vertices.size());
-    glBindVertexArray(0);
+    GLDispatch::Subsystem gl_subsystem("Cube");
+    GLDispatch::BindVertexArray(lines_vertex_array.Get());
+    GLDispatch::DrawArrays(GL_LINES, 0, lines_vertices.size());
+    GLDispatch::BindVertexArray(0);
 }
 
 //=============================
@@ -678,8 +730,6 @@ void Cube::FreeAll() {
         }
     } 
     // free lines
-    glDeleteVertexArrays(1, &lines_vertex_array);
-    glDeleteBuffers(1, &lines_vertex_buffer);
-    lines_vertex_array = 0;
-    lines_vertex_buffer = 0;
+    lines_vertex_array.Reset();
+    lines_vertex_buffer.Reset();
 }
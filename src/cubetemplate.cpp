@@ -0,0 +1,289 @@
+#include "CubeTemplate.h"
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+CubeTemplate::CubeTemplate() {
+    ;
+}
+
+//=============================
+// BASIC FUNCTIONS
+//=============================
+
+void CubeTemplate::Load(const std::vector<std::vector<GLfloat>>& triangles_vertices, float p_size, GLuint p_shader_program, glm::vec3& color_out) {
+    shader_program = p_shader_program;
+    position_scale = Triangle::GetPositionScale(triangles_vertices);
+    color_out = glm::vec3(1.0f);
+
+    vertices.clear();
+    vertices.reserve(triangles_vertices.size() * 3);
+
+    float low_extent = std::numeric_limits<float>::max();
+    float high_extent = -std::numeric_limits<float>::max();
+
+    for (const auto& triangle_vertices : triangles_vertices) {
+        if (triangle_vertices.size() != 18) continue;
+
+        TotalFrame::PackedVertex temp_vertices[3];
+        Triangle::PackVertices(triangle_vertices.data(), position_scale, temp_vertices);
+        vertices.insert(vertices.end(), temp_vertices, temp_vertices + 3);
+
+        for (size_t i = 0; i < 18; i += 6) {
+            low_extent = std::min(low_extent, triangle_vertices[i]);
+            high_extent = std::max(high_extent, triangle_vertices[i]);
+        }
+    }
+
+    // size
+    if (p_size == TotalFrame::READ_SIZE_FROM_FILE) size = vertices.empty() ? 0.0f : high_extent - low_extent;
+    else size = p_size;
+
+    // one color for every vertex, move it out so the geometry is shared regardless of color
+    color_out = CubeTemplate::ExtractUniformColor(vertices.data(), vertices.size());
+}
+
+void CubeTemplate::LoadPacked(const TotalFrame::PackedVertex* p_vertices, size_t total_vertices, float p_size, float p_position_scale, GLuint p_shader_program) {
+    shader_program = p_shader_program;
+    size = p_size;
+    position_scale = p_position_scale;
+    vertices.assign(p_vertices, p_vertices + total_vertices);
+}
+
+void CubeTemplate::Build() {
+    if (CubeTemplate::IsBuilt()) return;
+
+    vertex_array.Create();
+    vertex_buffer.Create();
+
+    GLDispatch::BindVertexArray(vertex_array.Get());
+
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, vertex_buffer.Get());
+    GLDispatch::BufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(TotalFrame::PackedVertex), vertices.data(), GL_STATIC_DRAW);
+
+    GLsizei stride = sizeof(TotalFrame::PackedVertex);
+
+    // Position + face index (w), quantized
+    GLDispatch::VertexAttribPointer(0, 4, GL_SHORT, GL_FALSE, stride, (GLvoid*)(offsetof(TotalFrame::PackedVertex, position)));
+    GLDispatch::EnableVertexAttribArray(0);
+
+    // Color
+    GLDispatch::VertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)(offsetof(TotalFrame::PackedVertex, color)));
+    GLDispatch::EnableVertexAttribArray(1);
+
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLDispatch::BindVertexArray(0);
+}
+
+bool CubeTemplate::IsBuilt() const {
+    return bool(vertex_array);
+}
+
+void CubeTemplate::Render() {
+    if (!CubeTemplate::IsBuilt()) CubeTemplate::Build();
+
+    GLDispatch::BindVertexArray(vertex_array.Get());
+    GLDispatch::DrawArrays(GL_TRIANGLES, 0, vertices.size());
+    GLDispatch::BindVertexArray(0);
+}
+
+void CubeTemplate::RenderInstanced(GLuint instance_buffer, size_t first_instance, size_t total_instances) {
+    if (total_instances == 0) return;
+    if (!CubeTemplate::IsBuilt()) CubeTemplate::Build();
+
+    GLDispatch::BindVertexArray(vertex_array.Get());
+
+    // cube index, one per instance
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, instance_buffer);
+    GLDispatch::VertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(Uint32), (GLvoid*)(first_instance * sizeof(Uint32)));
+    GLDispatch::EnableVertexAttribArray(2);
+    GLDispatch::VertexAttribDivisor(2, 1);
+
+    GLDispatch::DrawArraysInstanced(GL_TRIANGLES, 0, vertices.size(), total_instances);
+
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLDispatch::BindVertexArray(0);
+}
+
+//=============================
+// DATA FUNCTIONS
+//=============================
+
+size_t CubeTemplate::GetTotalTriangles() const {
+    return vertices.size() / 3;
+}
+
+std::vector<GLfloat> CubeTemplate::GetTriangleVertices(size_t triangle, glm::vec3 color) const {
+    std::vector<GLfloat> temp_vertices(18);
+    Triangle::UnpackVertices(&vertices[triangle * 3], position_scale, temp_vertices.data());
+
+    int stride = 6;
+    for (int i = 0; i < 3; i++) {
+        int index = i * stride + 3; // +3 skips past x,y,z to get to r,g,b
+
+        temp_vertices[index + 0] *= color.r;
+        temp_vertices[index + 1] *= color.g;
+        temp_vertices[index + 2] *= color.b;
+    }
+
+    return temp_vertices;
+}
+
+std::vector<std::vector<GLfloat>> CubeTemplate::GetTrianglesVertices() const {
+    std::vector<std::vector<GLfloat>> temp_triangles_vertices = {};
+    for (size_t triangle = 0; triangle < CubeTemplate::GetTotalTriangles(); triangle++) {
+        temp_triangles_vertices.push_back(CubeTemplate::GetTriangleVertices(triangle, glm::vec3(1.0f)));
+    }
+    return temp_triangles_vertices;
+}
+
+std::vector<glm::vec3> CubeTemplate::GetTrianglePositions(size_t triangle) const {
+    std::vector<glm::vec3> temp_positions = {};
+    for (size_t i = triangle * 3; i < triangle * 3 + 3; i++) {
+        temp_positions.push_back(glm::vec3(
+            Triangle::DequantizePosition(vertices[i].position[0], position_scale),
+            Triangle::DequantizePosition(vertices[i].position[1], position_scale),
+            Triangle::DequantizePosition(vertices[i].position[2], position_scale)
+        ));
+    }
+    return temp_positions;
+}
+
+glm::vec3 CubeTemplate::GetColor() const {
+    if (vertices.empty()) return glm::vec3(1.0f);
+    return glm::vec3(vertices[0].color[0], vertices[0].color[1], vertices[0].color[2]) / 255.0f;
+}
+
+bool CubeTemplate::IsWhiteBox() const {
+    if (!CubeTemplate::IsBox()) return false;
+
+    for (const auto& vertex : vertices) {
+        if (vertex.color[0] != 255 || vertex.color[1] != 255 || vertex.color[2] != 255) return false;
+    }
+    return true;
+}
+
+bool CubeTemplate::IsBox() const {
+    if (vertices.size() != 36 || std::fabs(size - 2.0f * position_scale) > size * 0.001f) return false;
+
+    // a corner coordinate is +-POSITION_QUANTIZATION, give or take rounding
+    auto IsCorner = [](GLshort value) {
+        return std::abs(std::abs(int(value)) - int(TotalFrame::POSITION_QUANTIZATION)) <= 4;
+    };
+
+    // every face is split into 4 quarters around its center. a triangle over 3 of its corners covers 2 of them, so 12 triangles covering all 24 never overlap
+    bool covered[6][4] = {};
+    // a point inside each quarter, off the diagonals
+    const glm::vec2 quarter_points[4] = {glm::vec2(0.5f, 0.0f), glm::vec2(-0.5f, 0.0f), glm::vec2(0.0f, 0.5f), glm::vec2(0.0f, -0.5f)};
+
+    for (size_t triangle = 0; triangle < 12; triangle++) {
+        const TotalFrame::PackedVertex* triangle_vertices = &vertices[triangle * 3];
+
+        glm::vec3 corners[3];
+        for (int i = 0; i < 3; i++) {
+            const TotalFrame::PackedVertex& vertex = triangle_vertices[i];
+            if (!IsCorner(vertex.position[0]) || !IsCorner(vertex.position[1]) || !IsCorner(vertex.position[2])) return false;
+            corners[i] = glm::sign(glm::vec3(vertex.position[0], vertex.position[1], vertex.position[2]));
+        }
+
+        // the axis all three corners share is the face
+        int axis = -1;
+        for (int i = 0; i < 3; i++) {
+            if (corners[0][i] == corners[1][i] && corners[0][i] == corners[2][i]) axis = i;
+        }
+        if (axis == -1) return false;
+        int face = axis * 2 + (corners[0][axis] < 0.0f ? 1 : 0);
+
+        glm::vec2 points[3];
+        for (int i = 0; i < 3; i++) {
+            points[i] = glm::vec2(corners[i][(axis + 1) % 3], corners[i][(axis + 2) % 3]);
+        }
+        auto Cross = [](glm::vec2 a, glm::vec2 b, glm::vec2 c) {
+            return (b.x - a.x) * (c.y - a.y) - (b.y - a.y) * (c.x - a.x);
+        };
+        float area = Cross(points[0], points[1], points[2]);
+        if (area == 0.0f) return false;
+
+        for (int quarter = 0; quarter < 4; quarter++) {
+            glm::vec2 point = quarter_points[quarter];
+            float d0 = Cross(points[0], points[1], point) * area;
+            float d1 = Cross(points[1], points[2], point) * area;
+            float d2 = Cross(points[2], points[0], point) * area;
+            if (d0 > 0.0f && d1 > 0.0f && d2 > 0.0f) covered[face][quarter] = true;
+        }
+    }
+
+    for (const auto& face_quarters : covered) {
+        for (bool quarter_covered : face_quarters) {
+            if (!quarter_covered) return false;
+        }
+    }
+    return true;
+}
+
+//=============================
+// MATCHING FUNCTIONS
+//=============================
+
+Uint64 CubeTemplate::GetHash() const {
+    return CubeTemplate::Hash(vertices.data(), vertices.size(), size, position_scale, shader_program);
+}
+
+bool CubeTemplate::Matches(const TotalFrame::PackedVertex* p_vertices, size_t total_vertices, float p_size, float p_position_scale, GLuint p_shader_program) const {
+    if (shader_program != p_shader_program || size != p_size || position_scale != p_position_scale || vertices.size() != total_vertices) return false;
+    return total_vertices == 0 || std::memcmp(vertices.data(), p_vertices, total_vertices * sizeof(TotalFrame::PackedVertex)) == 0;
+}
+
+bool CubeTemplate::Matches(const CubeTemplate& other) const {
+    return CubeTemplate::Matches(other.vertices.data(), other.vertices.size(), other.size, other.position_scale, other.shader_program);
+}
+
+Uint64 CubeTemplate::Hash(const TotalFrame::PackedVertex* p_vertices, size_t total_vertices, float p_size, float p_position_scale, GLuint p_shader_program) {
+    // FNV-1a over the same bytes Matches() compares
+    Uint64 hash = 14695981039346656037ull;
+    auto HashBytes = [&](const void* data, size_t bytes) {
+        const unsigned char* read = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; i++) {
+            hash ^= read[i];
+            hash *= 1099511628211ull;
+        }
+    };
+
+    HashBytes(&p_shader_program, sizeof(GLuint));
+    HashBytes(&p_size, sizeof(float));
+    HashBytes(&p_position_scale, sizeof(float));
+    if (total_vertices != 0) HashBytes(p_vertices, total_vertices * sizeof(TotalFrame::PackedVertex));
+
+    return hash;
+}
+
+//=============================
+// PACKING FUNCTIONS
+//=============================
+
+glm::vec3 CubeTemplate::ExtractUniformColor(TotalFrame::PackedVertex* p_vertices, size_t total_vertices) {
+    if (total_vertices == 0) return glm::vec3(1.0f);
+
+    for (size_t i = 1; i < total_vertices; i++) {
+        if (std::memcmp(p_vertices[i].color, p_vertices[0].color, sizeof(p_vertices[i].color)) != 0) return glm::vec3(1.0f);
+    }
+
+    glm::vec3 color = glm::vec3(p_vertices[0].color[0], p_vertices[0].color[1], p_vertices[0].color[2]) / 255.0f;
+    for (size_t i = 0; i < total_vertices; i++) {
+        p_vertices[i].color[0] = 255;
+        p_vertices[i].color[1] = 255;
+        p_vertices[i].color[2] = 255;
+    }
+
+    return color;
+}
+
+//=============================
+// MEMORY MANAGEMENT
+//=============================
+
+void CubeTemplate::FreeAll() {
+    vertex_array.Reset();
+    vertex_buffer.Reset();
+}
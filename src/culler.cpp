@@ -0,0 +1,308 @@
+#include "Culler.h"
+
+#if defined(__AVX__)
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TF_CULLER_SSE
+#endif
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+Culler::Culler() {
+    ;
+}
+
+//=============================
+// FRUSTUM FUNCTIONS
+//=============================
+
+void Culler::Frustum::Update(const glm::mat4& m) {
+    // rows of the view projection matrix (glm is column major)
+    glm::vec4 row_0 = glm::vec4(m[0][0], m[1][0], m[2][0], m[3][0]);
+    glm::vec4 row_1 = glm::vec4(m[0][1], m[1][1], m[2][1], m[3][1]);
+    glm::vec4 row_2 = glm::vec4(m[0][2], m[1][2], m[2][2], m[3][2]);
+    glm::vec4 row_3 = glm::vec4(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    planes[0] = row_3 + row_0; // left
+    planes[1] = row_3 - row_0; // right
+    planes[2] = row_3 + row_1; // bottom
+    planes[3] = row_3 - row_1; // top
+    planes[4] = row_3 + row_2; // near
+    planes[5] = row_3 - row_2; // far
+
+    // normalize so distances are in world units
+    for (auto& plane : planes) {
+        float length = glm::length(glm::vec3(plane));
+        if (length > 0.0f) plane /= length;
+    }
+}
+
+bool Culler::Frustum::IsBoxVisible(glm::vec3 center, glm::vec3 extent) const {
+    for (const auto& plane : planes) {
+        // distance of the center and the projected radius of the box onto the plane normal
+        float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+        float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+
+        if (distance + radius < 0.0f) return false;
+    }
+    return true;
+}
+
+bool Culler::Frustum::IsBoxInside(glm::vec3 center, glm::vec3 extent) const {
+    for (const auto& plane : planes) {
+        float distance = glm::dot(glm::vec3(plane), center) + plane.w;
+        float radius = glm::dot(glm::abs(glm::vec3(plane)), extent);
+
+        if (distance - radius < 0.0f) return false;
+    }
+    return true;
+}
+
+//=============================
+// BASIC FUNCTIONS
+//=============================
+
+void Culler::UpdateFrustum(const glm::mat4& view_projection_matrix) {
+    frustum.Update(view_projection_matrix);
+}
+
+const Culler::Frustum& Culler::GetFrustum() const {
+    return frustum;
+}
+
+//=============================
+// BOUNDS TREE FUNCTIONS
+//=============================
+
+void Culler::Build(const std::vector<glm::vec3>& centers, const std::vector<glm::vec3>& extents) {
+    nodes.clear();
+    center_x.clear(); center_y.clear(); center_z.clear();
+    extent_x.clear(); extent_y.clear(); extent_z.clear();
+    slot_items.clear();
+
+    total_items = std::min(centers.size(), extents.size());
+    if (total_items == 0) return;
+
+    // roughly 2 nodes per leaf, and at most LEAF_SIZE - 1 padding slots per leaf
+    size_t total_leaves = (total_items + LEAF_SIZE - 1) / LEAF_SIZE * 2;
+    nodes.reserve(total_leaves * 2);
+    size_t total_slots = total_items + total_leaves * LEAF_SIZE;
+    for (auto* array : {&center_x, &center_y, &center_z, &extent_x, &extent_y, &extent_z}) array->reserve(total_slots);
+    slot_items.reserve(total_slots);
+
+    std::vector<Uint32> items(total_items);
+    for (size_t i = 0; i < total_items; i++) items[i] = Uint32(i);
+
+    Culler::_BuildNode(items, 0, total_items, centers, extents);
+}
+
+size_t Culler::Size() const {
+    return total_items;
+}
+
+Uint32 Culler::_BuildNode(std::vector<Uint32>& items, size_t start, size_t end, const std::vector<glm::vec3>& centers, const std::vector<glm::vec3>& extents) {
+    Uint32 node_index = Uint32(nodes.size());
+    nodes.push_back(Node());
+
+    // bounds of the boxes and of their centers
+    glm::vec3 low = glm::vec3(std::numeric_limits<float>::max());
+    glm::vec3 high = glm::vec3(-std::numeric_limits<float>::max());
+    glm::vec3 center_low = low;
+    glm::vec3 center_high = high;
+
+    for (size_t i = start; i < end; i++) {
+        const glm::vec3& center = centers[items[i]];
+        low = glm::min(low, center - extents[items[i]]);
+        high = glm::max(high, center + extents[items[i]]);
+        center_low = glm::min(center_low, center);
+        center_high = glm::max(center_high, center);
+    }
+
+    Node node;
+    node.center = (low + high) * 0.5f;
+    node.extent = (high - low) * 0.5f;
+
+    if (end - start <= LEAF_SIZE) {
+        // leaf, copy its boxes into the slot arrays and pad up to LEAF_SIZE
+        node.slot_start = Uint32(slot_items.size());
+        node.slot_count = LEAF_SIZE;
+
+        for (Uint32 slot = 0; slot < LEAF_SIZE; slot++) {
+            bool valid = start + slot < end;
+            glm::vec3 center = valid ? centers[items[start + slot]] : glm::vec3(0.0f);
+            glm::vec3 extent = valid ? extents[items[start + slot]] : glm::vec3(-std::numeric_limits<float>::max());
+
+            center_x.push_back(center.x); center_y.push_back(center.y); center_z.push_back(center.z);
+            extent_x.push_back(extent.x); extent_y.push_back(extent.y); extent_z.push_back(extent.z);
+            slot_items.push_back(valid ? items[start + slot] : EMPTY_SLOT);
+        }
+
+        nodes[node_index] = node;
+        return node_index;
+    }
+
+    // split at the median center along the longest axis
+    glm::vec3 spread = center_high - center_low;
+    int axis = 0;
+    if (spread.y > spread[axis]) axis = 1;
+    if (spread.z > spread[axis]) axis = 2;
+
+    size_t middle = start + (end - start) / 2;
+    // keep leaves full, round the split to a multiple of LEAF_SIZE
+    middle = start + std::max<size_t>(LEAF_SIZE, (middle - start) / LEAF_SIZE * LEAF_SIZE);
+
+    std::nth_element(items.begin() + start, items.begin() + middle, items.begin() + end, [&](Uint32 a, Uint32 b) {
+        return centers[a][axis] < centers[b][axis];
+    });
+
+    node.slot_start = Uint32(slot_items.size());
+    node.left = Culler::_BuildNode(items, start, middle, centers, extents);
+    node.right = Culler::_BuildNode(items, middle, end, centers, extents);
+    node.slot_count = Uint32(slot_items.size()) - node.slot_start;
+
+    nodes[node_index] = node;
+    return node_index;
+}
+
+//=============================
+// CULLING FUNCTIONS
+//=============================
+
+void Culler::Cull(std::vector<Uint8>& visibility_out, JobSystem* job_system) const {
+    if (nodes.empty()) return;
+    if (visibility_out.size() < total_items) visibility_out.resize(total_items, 0);
+
+    if (job_system == nullptr) {
+        Culler::_CullNode(0, visibility_out);
+        return;
+    }
+
+    // walk the top of the tree here, then hand each remaining subtree to a worker
+    std::vector<Uint32> tasks = {};
+    Culler::_CollectTasks(0, 0, tasks, visibility_out);
+
+    job_system->ParallelFor(tasks.size(), 1, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) {
+            Culler::_CullNode(tasks[i], visibility_out);
+        }
+    });
+}
+
+void Culler::_CollectTasks(Uint32 node_index, int depth, std::vector<Uint32>& tasks_out, std::vector<Uint8>& visibility_out) const {
+    const Node& node = nodes[node_index];
+
+    if (!frustum.IsBoxVisible(node.center, node.extent)) return;
+
+    if (depth >= TASK_DEPTH || node.left == 0) {
+        tasks_out.push_back(node_index);
+        return;
+    }
+
+    if (frustum.IsBoxInside(node.center, node.extent)) {
+        Culler::_AcceptNode(node, visibility_out);
+        return;
+    }
+
+    Culler::_CollectTasks(node.left, depth + 1, tasks_out, visibility_out);
+    Culler::_CollectTasks(node.right, depth + 1, tasks_out, visibility_out);
+}
+
+void Culler::_CullNode(Uint32 root_index, std::vector<Uint8>& visibility_out) const {
+    // iterative, the tree can be deep for very large objects
+    Uint32 stack[64];
+    int stack_size = 0;
+    stack[stack_size++] = root_index;
+
+    while (stack_size > 0) {
+        const Node& node = nodes[stack[--stack_size]];
+
+        if (!frustum.IsBoxVisible(node.center, node.extent)) continue;
+
+        // fully on screen, everything under it is visible
+        if (frustum.IsBoxInside(node.center, node.extent)) {
+            Culler::_AcceptNode(node, visibility_out);
+            continue;
+        }
+
+        if (node.left == 0) {
+            Culler::_CullLeaf(node, visibility_out);
+            continue;
+        }
+
+        if (stack_size + 2 > 64) {
+            // should never happen with median splits, fall back to accepting
+            Culler::_AcceptNode(node, visibility_out);
+            continue;
+        }
+
+        stack[stack_size++] = node.right;
+        stack[stack_size++] = node.left;
+    }
+}
+
+void Culler::_AcceptNode(const Node& node, std::vector<Uint8>& visibility_out) const {
+    for (Uint32 slot = node.slot_start; slot < node.slot_start + node.slot_count; slot++) {
+        if (slot_items[slot] != EMPTY_SLOT) visibility_out[slot_items[slot]] = 1;
+    }
+}
+
+void Culler::_CullLeaf(const Node& node, std::vector<Uint8>& visibility_out) const {
+    Uint32 slot = node.slot_start;
+    Uint32 slot_end = node.slot_start + node.slot_count;
+
+#if defined(__AVX__)
+    // 8 boxes per iteration
+    for (; slot + 8 <= slot_end; slot += 8) {
+        __m256 cx = _mm256_loadu_ps(&center_x[slot]), cy = _mm256_loadu_ps(&center_y[slot]), cz = _mm256_loadu_ps(&center_z[slot]);
+        __m256 ex = _mm256_loadu_ps(&extent_x[slot]), ey = _mm256_loadu_ps(&extent_y[slot]), ez = _mm256_loadu_ps(&extent_z[slot]);
+        __m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+        for (const auto& plane : frustum.planes) {
+            // distance = n . c + w, radius = |n| . e, outside when distance + radius < 0
+            __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(cx, _mm256_set1_ps(plane.x)), _mm256_mul_ps(cy, _mm256_set1_ps(plane.y))),
+                                            _mm256_add_ps(_mm256_mul_ps(cz, _mm256_set1_ps(plane.z)), _mm256_set1_ps(plane.w)));
+            __m256 radius = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ex, _mm256_set1_ps(std::fabs(plane.x))), _mm256_mul_ps(ey, _mm256_set1_ps(std::fabs(plane.y)))),
+                                          _mm256_mul_ps(ez, _mm256_set1_ps(std::fabs(plane.z))));
+            visible = _mm256_and_ps(visible, _mm256_cmp_ps(_mm256_add_ps(distance, radius), _mm256_setzero_ps(), _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(visible);
+        for (int lane = 0; lane < 8; lane++) {
+            if ((mask & (1 << lane)) && slot_items[slot + lane] != EMPTY_SLOT) visibility_out[slot_items[slot + lane]] = 1;
+        }
+    }
+#elif defined(TF_CULLER_SSE)
+    // 4 boxes per iteration
+    for (; slot + 4 <= slot_end; slot += 4) {
+        __m128 cx = _mm_loadu_ps(&center_x[slot]), cy = _mm_loadu_ps(&center_y[slot]), cz = _mm_loadu_ps(&center_z[slot]);
+        __m128 ex = _mm_loadu_ps(&extent_x[slot]), ey = _mm_loadu_ps(&extent_y[slot]), ez = _mm_loadu_ps(&extent_z[slot]);
+        __m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+        for (const auto& plane : frustum.planes) {
+            // distance = n . c + w, radius = |n| . e, outside when distance + radius < 0
+            __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(cx, _mm_set1_ps(plane.x)), _mm_mul_ps(cy, _mm_set1_ps(plane.y))),
+                                         _mm_add_ps(_mm_mul_ps(cz, _mm_set1_ps(plane.z)), _mm_set1_ps(plane.w)));
+            __m128 radius = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(std::fabs(plane.x))), _mm_mul_ps(ey, _mm_set1_ps(std::fabs(plane.y)))),
+                                       _mm_mul_ps(ez, _mm_set1_ps(std::fabs(plane.z))));
+            visible = _mm_and_ps(visible, _mm_cmpge_ps(_mm_add_ps(distance, radius), _mm_setzero_ps()));
+        }
+
+        int mask = _mm_movemask_ps(visible);
+        for (int lane = 0; lane < 4; lane++) {
+            if ((mask & (1 << lane)) && slot_items[slot + lane] != EMPTY_SLOT) visibility_out[slot_items[slot + lane]] = 1;
+        }
+    }
+#endif
+
+    // scalar tail, or everything on builds without SIMD
+    for (; slot < slot_end; slot++) {
+        if (slot_items[slot] == EMPTY_SLOT) continue;
+
+        glm::vec3 center = glm::vec3(center_x[slot], center_y[slot], center_z[slot]);
+        glm::vec3 extent = glm::vec3(extent_x[slot], extent_y[slot], extent_z[slot]);
+        if (frustum.IsBoxVisible(center, extent)) visibility_out[slot_items[slot]] = 1;
+    }
+}
@@ -0,0 +1,411 @@
+#include "GLDispatch.h"
+
+#include <cstring>
+
+GLDispatch::BACKEND GLDispatch::backend = GLDispatch::OPENGL_BACKEND;
+const char* GLDispatch::subsystem = "other";
+GLuint GLDispatch::next_null_name = 1;
+
+Uint64 GLDispatch::frame = 0;
+GLDispatch::FrameStats GLDispatch::frame_stats;
+GLDispatch::FrameStats GLDispatch::last_frame_stats;
+std::vector<GLDispatch::SubsystemStats> GLDispatch::frame_subsystems = {};
+std::vector<GLDispatch::SubsystemStats> GLDispatch::last_frame_subsystems = {};
+size_t GLDispatch::last_subsystem_index = 0;
+
+std::ofstream GLDispatch::recording_file;
+std::string GLDispatch::recording_buffer = "";
+
+namespace {
+    // same order as GLDispatch::CALL
+    constexpr std::array<const char*, GLDispatch::TOTAL_CALLS> CALL_NAMES = {
+        "ActiveTexture", "AttachShader", "BindBuffer", "BindTexture", "BindVertexArray", "BlendFunc", "BufferData", "BufferSubData",
+        "Clear", "ClearColor", "CompileShader", "CreateProgram", "CreateShader", "CullFace",
+        "DeleteBuffers", "DeleteProgram", "DeleteShader", "DeleteTextures", "DeleteVertexArrays", "DepthFunc", "Disable", "DrawArrays", "DrawArraysInstanced",
+        "Enable", "EnableVertexAttribArray", "FrontFace", "GenBuffers", "GenTextures", "GenVertexArrays", "GenerateMipmap",
+        "GetError", "GetProgramiv", "GetShaderiv", "GetUniformLocation", "LineWidth", "LinkProgram", "PixelStorei",
+        "ShaderSource", "TexBuffer", "TexImage2D", "TexParameteri",
+        "Uniform1f", "Uniform1i", "Uniform2fv", "Uniform3fv", "Uniform4f", "UniformMatrix3fv", "UniformMatrix4fv", "UseProgram",
+        "VertexAttribDivisor", "VertexAttribIPointer", "VertexAttribPointer", "Viewport"
+    };
+}
+
+//=============================
+// SUBSYSTEMS
+//=============================
+
+GLDispatch::Subsystem::Subsystem(const char* name) : previous(GLDispatch::subsystem) {
+    GLDispatch::subsystem = name;
+}
+
+GLDispatch::Subsystem::~Subsystem() {
+    GLDispatch::subsystem = previous;
+}
+
+//=============================
+// BACKEND
+//=============================
+
+void GLDispatch::SetBackend(BACKEND p_backend) {
+    backend = p_backend;
+}
+
+GLDispatch::BACKEND GLDispatch::GetBackend() {
+    return backend;
+}
+
+//=============================
+// FRAMES
+//=============================
+
+void GLDispatch::EndFrame() {
+    last_frame_stats = frame_stats;
+    frame_stats = {};
+
+    last_frame_subsystems.swap(frame_subsystems);
+    frame_subsystems.clear();
+    last_subsystem_index = 0;
+
+    if (recording_file.is_open()) {
+        recording_file << recording_buffer;
+        recording_buffer.clear();
+    }
+    frame++;
+}
+
+const GLDispatch::FrameStats& GLDispatch::GetLastFrameStats() {
+    return last_frame_stats;
+}
+
+const std::vector<GLDispatch::SubsystemStats>& GLDispatch::GetLastFrameSubsystems() {
+    return last_frame_subsystems;
+}
+
+const char* GLDispatch::GetCallName(CALL call) {
+    return call < TOTAL_CALLS ? CALL_NAMES[call] : "Unknown";
+}
+
+//=============================
+// RECORDING
+//=============================
+
+bool GLDispatch::StartRecording(const std::string& path) {
+    GLDispatch::StopRecording();
+
+    recording_file.open(path, std::ios::binary);
+    if (!recording_file.is_open()) {
+        TF_LOG_ERROR("COULD NOT OPEN GL RECORDING FILE", "GLDispatch::StartRecording");
+        return false;
+    }
+    recording_file << "# frame subsystem call arguments\n";
+    return true;
+}
+
+void GLDispatch::StopRecording() {
+    if (!recording_file.is_open()) return;
+
+    recording_file << recording_buffer;
+    recording_buffer.clear();
+    recording_file.close();
+}
+
+bool GLDispatch::IsRecording() {
+    return recording_file.is_open();
+}
+
+//=============================
+// CALLS
+//=============================
+
+void GLDispatch::ActiveTexture(GLenum texture) {
+    if (GLDispatch::_Begin(ACTIVE_TEXTURE, 0, {double(texture)})) glActiveTexture(texture);
+}
+
+void GLDispatch::AttachShader(GLuint program, GLuint shader) {
+    if (GLDispatch::_Begin(ATTACH_SHADER, 0, {double(program), double(shader)})) glAttachShader(program, shader);
+}
+
+void GLDispatch::BindBuffer(GLenum target, GLuint buffer) {
+    if (GLDispatch::_Begin(BIND_BUFFER, 0, {double(target), double(buffer)})) glBindBuffer(target, buffer);
+}
+
+void GLDispatch::BindTexture(GLenum target, GLuint texture) {
+    if (GLDispatch::_Begin(BIND_TEXTURE, 0, {double(target), double(texture)})) glBindTexture(target, texture);
+}
+
+void GLDispatch::BindVertexArray(GLuint vertex_array) {
+    if (GLDispatch::_Begin(BIND_VERTEX_ARRAY, 0, {double(vertex_array)})) glBindVertexArray(vertex_array);
+}
+
+void GLDispatch::BlendFunc(GLenum source_factor, GLenum destination_factor) {
+    if (GLDispatch::_Begin(BLEND_FUNC, 0, {double(source_factor), double(destination_factor)})) glBlendFunc(source_factor, destination_factor);
+}
+
+void GLDispatch::BufferData(GLenum target, GLsizeiptr size, const void* data, GLenum usage) {
+    // a null data pointer only allocates
+    if (GLDispatch::_Begin(BUFFER_DATA, data != nullptr ? Uint64(size) : 0, {double(target), double(size), double(usage)})) glBufferData(target, size, data, usage);
+}
+
+void GLDispatch::BufferSubData(GLenum target, GLintptr offset, GLsizeiptr size, const void* data) {
+    if (GLDispatch::_Begin(BUFFER_SUB_DATA, Uint64(size), {double(target), double(offset), double(size)})) glBufferSubData(target, offset, size, data);
+}
+
+void GLDispatch::Clear(GLbitfield mask) {
+    if (GLDispatch::_Begin(CLEAR, 0, {double(mask)})) glClear(mask);
+}
+
+void GLDispatch::ClearColor(GLfloat red, GLfloat green, GLfloat blue, GLfloat alpha) {
+    if (GLDispatch::_Begin(CLEAR_COLOR, 0, {red, green, blue, alpha})) glClearColor(red, green, blue, alpha);
+}
+
+void GLDispatch::CompileShader(GLuint shader) {
+    if (GLDispatch::_Begin(COMPILE_SHADER, 0, {double(shader)})) glCompileShader(shader);
+}
+
+GLuint GLDispatch::CreateProgram() {
+    if (GLDispatch::_Begin(CREATE_PROGRAM, 0, {})) return glCreateProgram();
+    return next_null_name++;
+}
+
+GLuint GLDispatch::CreateShader(GLenum type) {
+    if (GLDispatch::_Begin(CREATE_SHADER, 0, {double(type)})) return glCreateShader(type);
+    return next_null_name++;
+}
+
+void GLDispatch::CullFace(GLenum mode) {
+    if (GLDispatch::_Begin(CULL_FACE, 0, {double(mode)})) glCullFace(mode);
+}
+
+void GLDispatch::DeleteBuffers(GLsizei count, const GLuint* buffers) {
+    if (GLDispatch::_Begin(DELETE_BUFFERS, 0, {double(count)})) glDeleteBuffers(count, buffers);
+}
+
+void GLDispatch::DeleteProgram(GLuint program) {
+    if (GLDispatch::_Begin(DELETE_PROGRAM, 0, {double(program)})) glDeleteProgram(program);
+}
+
+void GLDispatch::DeleteShader(GLuint shader) {
+    if (GLDispatch::_Begin(DELETE_SHADER, 0, {double(shader)})) glDeleteShader(shader);
+}
+
+void GLDispatch::DeleteTextures(GLsizei count, const GLuint* textures) {
+    if (GLDispatch::_Begin(DELETE_TEXTURES, 0, {double(count)})) glDeleteTextures(count, textures);
+}
+
+void GLDispatch::DeleteVertexArrays(GLsizei count, const GLuint* vertex_arrays) {
+    if (GLDispatch::_Begin(DELETE_VERTEX_ARRAYS, 0, {double(count)})) glDeleteVertexArrays(count, vertex_arrays);
+}
+
+void GLDispatch::DepthFunc(GLenum function) {
+    if (GLDispatch::_Begin(DEPTH_FUNC, 0, {double(function)})) glDepthFunc(function);
+}
+
+void GLDispatch::Disable(GLenum capability) {
+    if (GLDispatch::_Begin(DISABLE, 0, {double(capability)})) glDisable(capability);
+}
+
+void GLDispatch::DrawArrays(GLenum mode, GLint first, GLsizei count) {
+    frame_stats.draw_calls++;
+    if (GLDispatch::_Begin(DRAW_ARRAYS, 0, {double(mode), double(first), double(count)})) glDrawArrays(mode, first, count);
+}
+
+void GLDispatch::DrawArraysInstanced(GLenum mode, GLint first, GLsizei count, GLsizei instance_count) {
+    frame_stats.draw_calls++;
+    if (GLDispatch::_Begin(DRAW_ARRAYS_INSTANCED, 0, {double(mode), double(first), double(count), double(instance_count)})) glDrawArraysInstanced(mode, first, count, instance_count);
+}
+
+void GLDispatch::Enable(GLenum capability) {
+    if (GLDispatch::_Begin(ENABLE, 0, {double(capability)})) glEnable(capability);
+}
+
+void GLDispatch::EnableVertexAttribArray(GLuint index) {
+    if (GLDispatch::_Begin(ENABLE_VERTEX_ATTRIB_ARRAY, 0, {double(index)})) glEnableVertexAttribArray(index);
+}
+
+void GLDispatch::FrontFace(GLenum mode) {
+    if (GLDispatch::_Begin(FRONT_FACE, 0, {double(mode)})) glFrontFace(mode);
+}
+
+void GLDispatch::GenBuffers(GLsizei count, GLuint* buffers) {
+    if (GLDispatch::_Begin(GEN_BUFFERS, 0, {double(count)})) glGenBuffers(count, buffers);
+    else GLDispatch::_GenNullNames(count, buffers);
+}
+
+void GLDispatch::GenTextures(GLsizei count, GLuint* textures) {
+    if (GLDispatch::_Begin(GEN_TEXTURES, 0, {double(count)})) glGenTextures(count, textures);
+    else GLDispatch::_GenNullNames(count, textures);
+}
+
+void GLDispatch::GenVertexArrays(GLsizei count, GLuint* vertex_arrays) {
+    if (GLDispatch::_Begin(GEN_VERTEX_ARRAYS, 0, {double(count)})) glGenVertexArrays(count, vertex_arrays);
+    else GLDispatch::_GenNullNames(count, vertex_arrays);
+}
+
+void GLDispatch::GenerateMipmap(GLenum target) {
+    if (GLDispatch::_Begin(GENERATE_MIPMAP, 0, {double(target)})) glGenerateMipmap(target);
+}
+
+GLenum GLDispatch::GetError() {
+    if (GLDispatch::_Begin(GET_ERROR, 0, {})) return glGetError();
+    return GL_NO_ERROR;
+}
+
+void GLDispatch::GetProgramiv(GLuint program, GLenum parameter, GLint* value) {
+    if (GLDispatch::_Begin(GET_PROGRAM_IV, 0, {double(program), double(parameter)})) glGetProgramiv(program, parameter, value);
+    else *value = (parameter == GL_LINK_STATUS || parameter == GL_VALIDATE_STATUS) ? GL_TRUE : 0;
+}
+
+void GLDispatch::GetShaderiv(GLuint shader, GLenum parameter, GLint* value) {
+    if (GLDispatch::_Begin(GET_SHADER_IV, 0, {double(shader), double(parameter)})) glGetShaderiv(shader, parameter, value);
+    else *value = parameter == GL_COMPILE_STATUS ? GL_TRUE : 0;
+}
+
+GLint GLDispatch::GetUniformLocation(GLuint program, const GLchar* name) {
+    if (GLDispatch::_Begin(GET_UNIFORM_LOCATION, 0, {double(program)})) return glGetUniformLocation(program, name);
+    // -1 is what OpenGL gives for a missing uniform, setting it is a no-op there too
+    return -1;
+}
+
+void GLDispatch::LineWidth(GLfloat width) {
+    if (GLDispatch::_Begin(LINE_WIDTH, 0, {width})) glLineWidth(width);
+}
+
+void GLDispatch::LinkProgram(GLuint program) {
+    if (GLDispatch::_Begin(LINK_PROGRAM, 0, {double(program)})) glLinkProgram(program);
+}
+
+void GLDispatch::PixelStorei(GLenum parameter, GLint value) {
+    if (GLDispatch::_Begin(PIXEL_STORE_I, 0, {double(parameter), double(value)})) glPixelStorei(parameter, value);
+}
+
+void GLDispatch::ShaderSource(GLuint shader, GLsizei count, const GLchar* const* sources, const GLint* lengths) {
+    if (GLDispatch::_Begin(SHADER_SOURCE, 0, {double(shader), double(count)})) glShaderSource(shader, count, sources, lengths);
+}
+
+void GLDispatch::TexBuffer(GLenum target, GLenum internal_format, GLuint buffer) {
+    if (GLDispatch::_Begin(TEX_BUFFER, 0, {double(target), double(internal_format), double(buffer)})) glTexBuffer(target, internal_format, buffer);
+}
+
+void GLDispatch::TexImage2D(GLenum target, GLint level, GLint internal_format, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const void* pixels) {
+    Uint64 bytes = pixels != nullptr ? Uint64(width) * Uint64(height) * GLDispatch::_GetPixelBytes(format, type) : 0;
+    if (GLDispatch::_Begin(TEX_IMAGE_2D, bytes, {double(target), double(level), double(internal_format), double(width), double(height), double(format), double(type)})) {
+        glTexImage2D(target, level, internal_format, width, height, border, format, type, pixels);
+    }
+}
+
+void GLDispatch::TexParameteri(GLenum target, GLenum parameter, GLint value) {
+    if (GLDispatch::_Begin(TEX_PARAMETER_I, 0, {double(target), double(parameter), double(value)})) glTexParameteri(target, parameter, value);
+}
+
+void GLDispatch::Uniform1f(GLint location, GLfloat x) {
+    if (GLDispatch::_Begin(UNIFORM_1F, 0, {double(location), x})) glUniform1f(location, x);
+}
+
+void GLDispatch::Uniform1i(GLint location, GLint x) {
+    if (GLDispatch::_Begin(UNIFORM_1I, 0, {double(location), double(x)})) glUniform1i(location, x);
+}
+
+void GLDispatch::Uniform2fv(GLint location, GLsizei count, const GLfloat* value) {
+    if (GLDispatch::_Begin(UNIFORM_2FV, 0, {double(location), double(count)})) glUniform2fv(location, count, value);
+}
+
+void GLDispatch::Uniform3fv(GLint location, GLsizei count, const GLfloat* value) {
+    if (GLDispatch::_Begin(UNIFORM_3FV, 0, {double(location), double(count)})) glUniform3fv(location, count, value);
+}
+
+void GLDispatch::Uniform4f(GLint location, GLfloat x, GLfloat y, GLfloat z, GLfloat w) {
+    if (GLDispatch::_Begin(UNIFORM_4F, 0, {double(location), x, y, z, w})) glUniform4f(location, x, y, z, w);
+}
+
+void GLDispatch::UniformMatrix3fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    if (GLDispatch::_Begin(UNIFORM_MATRIX_3FV, 0, {double(location), double(count)})) glUniformMatrix3fv(location, count, transpose, value);
+}
+
+void GLDispatch::UniformMatrix4fv(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value) {
+    if (GLDispatch::_Begin(UNIFORM_MATRIX_4FV, 0, {double(location), double(count)})) glUniformMatrix4fv(location, count, transpose, value);
+}
+
+void GLDispatch::UseProgram(GLuint program) {
+    if (GLDispatch::_Begin(USE_PROGRAM, 0, {double(program)})) glUseProgram(program);
+}
+
+void GLDispatch::VertexAttribDivisor(GLuint index, GLuint divisor) {
+    if (GLDispatch::_Begin(VERTEX_ATTRIB_DIVISOR, 0, {double(index), double(divisor)})) glVertexAttribDivisor(index, divisor);
+}
+
+void GLDispatch::VertexAttribIPointer(GLuint index, GLint size, GLenum type, GLsizei stride, const void* pointer) {
+    if (GLDispatch::_Begin(VERTEX_ATTRIB_I_POINTER, 0, {double(index), double(size), double(type), double(stride), double(reinterpret_cast<uintptr_t>(pointer))})) {
+        glVertexAttribIPointer(index, size, type, stride, pointer);
+    }
+}
+
+void GLDispatch::VertexAttribPointer(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer) {
+    // the pointer is a byte offset into the bound buffer, so it is recorded like one
+    if (GLDispatch::_Begin(VERTEX_ATTRIB_POINTER, 0, {double(index), double(size), double(type), double(normalized), double(stride), double(reinterpret_cast<uintptr_t>(pointer))})) {
+        glVertexAttribPointer(index, size, type, normalized, stride, pointer);
+    }
+}
+
+void GLDispatch::Viewport(GLint x, GLint y, GLsizei width, GLsizei height) {
+    if (GLDispatch::_Begin(VIEWPORT, 0, {double(x), double(y), double(width), double(height)})) glViewport(x, y, width, height);
+}
+
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
+
+bool GLDispatch::_Begin(CALL call, Uint64 bytes_uploaded, std::initializer_list<double> arguments) {
+    frame_stats.calls[call]++;
+    frame_stats.total_calls++;
+    frame_stats.bytes_uploaded += bytes_uploaded;
+
+    // subsystems change rarely between calls, so the last one is checked before searching
+    if (last_subsystem_index >= frame_subsystems.size() || frame_subsystems[last_subsystem_index].name != subsystem) {
+        last_subsystem_index = 0;
+        while (last_subsystem_index < frame_subsystems.size() && std::strcmp(frame_subsystems[last_subsystem_index].name, subsystem) != 0) last_subsystem_index++;
+        if (last_subsystem_index == frame_subsystems.size()) frame_subsystems.push_back({subsystem, 0, 0});
+    }
+    frame_subsystems[last_subsystem_index].total_calls++;
+    frame_subsystems[last_subsystem_index].bytes_uploaded += bytes_uploaded;
+
+    if (recording_file.is_open()) GLDispatch::_Record(call, arguments);
+
+    return backend == OPENGL_BACKEND;
+}
+
+void GLDispatch::_Record(CALL call, std::initializer_list<double> arguments) {
+    char number_text[32];
+
+    recording_buffer += std::to_string(frame);
+    recording_buffer += ' ';
+    recording_buffer += subsystem;
+    recording_buffer += ' ';
+    recording_buffer += CALL_NAMES[call];
+    for (double argument : arguments) {
+        std::snprintf(number_text, sizeof(number_text), " %.9g", argument);
+        recording_buffer += number_text;
+    }
+    recording_buffer += '\n';
+}
+
+void GLDispatch::_GenNullNames(GLsizei count, GLuint* names) {
+    for (GLsizei i = 0; i < count; i++) {
+        names[i] = next_null_name++;
+    }
+}
+
+Uint64 GLDispatch::_GetPixelBytes(GLenum format, GLenum type) {
+    Uint64 components = 4;
+    switch (format) {
+        case GL_RED: components = 1; break;
+        case GL_RG: components = 2; break;
+        case GL_RGB: case GL_BGR: components = 3; break;
+    }
+
+    Uint64 component_bytes = 1;
+    switch (type) {
+        case GL_SHORT: case GL_UNSIGNED_SHORT: case GL_HALF_FLOAT: component_bytes = 2; break;
+        case GL_INT: case GL_UNSIGNED_INT: case GL_FLOAT: component_bytes = 4; break;
+    }
+    return components * component_bytes;
+}
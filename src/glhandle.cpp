@@ -0,0 +1,55 @@
+#include "GLHandle.h"
+
+//=============================
+// VERTEX ARRAYS
+//=============================
+
+GLuint GLVertexArrayTraits::Create() {
+    GLuint name = 0;
+    GLDispatch::GenVertexArrays(1, &name);
+    return name;
+}
+
+void GLVertexArrayTraits::Delete(GLuint name) {
+    GLDispatch::DeleteVertexArrays(1, &name);
+}
+
+//=============================
+// BUFFERS
+//=============================
+
+GLuint GLBufferTraits::Create() {
+    GLuint name = 0;
+    GLDispatch::GenBuffers(1, &name);
+    return name;
+}
+
+void GLBufferTraits::Delete(GLuint name) {
+    GLDispatch::DeleteBuffers(1, &name);
+}
+
+//=============================
+// TEXTURES
+//=============================
+
+GLuint GLTextureTraits::Create() {
+    GLuint name = 0;
+    GLDispatch::GenTextures(1, &name);
+    return name;
+}
+
+void GLTextureTraits::Delete(GLuint name) {
+    GLDispatch::DeleteTextures(1, &name);
+}
+
+//=============================
+// SHADER PROGRAMS
+//=============================
+
+GLuint GLProgramTraits::Create() {
+    return GLDispatch::CreateProgram();
+}
+
+void GLProgramTraits::Delete(GLuint name) {
+    GLDispatch::DeleteProgram(name);
+}
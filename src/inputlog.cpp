@@ -0,0 +1,447 @@
+#include "InputLog.h"
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+namespace {
+    struct EventName {
+        Uint32 type;
+        const char* name;
+    };
+
+    // the only events the editor handles, everything else is left out of recordings
+    constexpr EventName EVENT_NAMES[] = {
+        {SDL_EVENT_QUIT, "quit"},
+        {SDL_EVENT_MOUSE_BUTTON_DOWN, "mouse_down"},
+        {SDL_EVENT_MOUSE_BUTTON_UP, "mouse_up"},
+        {SDL_EVENT_MOUSE_MOTION, "mouse_motion"},
+        {SDL_EVENT_KEY_DOWN, "key_down"},
+        {SDL_EVENT_KEY_UP, "key_up"}
+    };
+
+    const char* GetEventName(Uint32 type) {
+        for (const EventName& event_name : EVENT_NAMES) {
+            if (event_name.type == type) return event_name.name;
+        }
+        return nullptr;
+    }
+
+    bool GetEventType(const std::string& name, Uint32& type_out) {
+        for (const EventName& event_name : EVENT_NAMES) {
+            if (name == event_name.name) {
+                type_out = event_name.type;
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+//=============================
+// ARGUMENTS
+//=============================
+
+bool InputLog::ParseArguments(int argc, char* argv[], Options& options_out) {
+    for (int i = 1; i < argc; i++) {
+        std::string argument = argv[i];
+
+        auto ReadPath = [&](std::string& path_out) {
+            if (i + 1 >= argc) return false;
+            path_out = argv[++i];
+            return true;
+        };
+
+        if (argument == "--record") {
+            if (!ReadPath(options_out.record_path)) return false;
+        } else if (argument == "--replay") {
+            if (!ReadPath(options_out.replay_path)) return false;
+        } else if (argument == "--report") {
+            if (!ReadPath(options_out.report_path)) return false;
+        } else if (argument == "--headless") {
+            options_out.headless = true;
+        } else {
+            TF_LOG_ERROR("UNKNOWN ARGUMENT: " + argument, "InputLog::ParseArguments");
+            return false;
+        }
+    }
+
+    if (!options_out.record_path.empty() && !options_out.replay_path.empty()) {
+        TF_LOG_ERROR("CAN'T RECORD AND REPLAY AT ONCE", "InputLog::ParseArguments");
+        return false;
+    }
+
+    if ((options_out.headless || !options_out.report_path.empty()) && options_out.replay_path.empty()) {
+        TF_LOG_ERROR("--headless AND --report NEED --replay", "InputLog::ParseArguments");
+        return false;
+    }
+
+    return true;
+}
+
+//=============================
+// BASIC FUNCTIONS
+//=============================
+
+bool InputLog::StartRecording(const std::string& path) {
+    record_file.open(path, std::ios::out | std::ios::trunc);
+    if (!record_file) {
+        TF_LOG_ERROR("FAILED TO OPEN FILE: " + path, "InputLog::StartRecording");
+        return false;
+    }
+
+    // enough digits for floats to read back exactly
+    record_file << std::setprecision(9) << "TFINPUT 1\n";
+
+    mode = RECORDING;
+    total_recorded_frames = 0;
+    return true;
+}
+
+bool InputLog::StartReplay(const std::string& path, const std::string& p_report_path) {
+    std::ifstream in_file(path);
+    if (!in_file) {
+        TF_LOG_ERROR("FAILED TO OPEN FILE: " + path, "InputLog::StartReplay");
+        return false;
+    }
+
+    std::string line;
+    if (!std::getline(in_file, line) || line.rfind("TFINPUT 1", 0) != 0) {
+        TF_LOG_ERROR("NOT AN INPUT RECORDING: " + path, "InputLog::StartReplay");
+        return false;
+    }
+
+    frames.clear();
+    Frame frame;
+    bool ended = false;
+    size_t line_number = 1;
+
+    while (std::getline(in_file, line)) {
+        line_number++;
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (line.empty()) continue;
+
+        if (ended || !InputLog::_ParseLine(line, frame, ended)) {
+            TF_LOG_ERROR("INVALID LINE " + std::to_string(line_number) + " IN " + path, "InputLog::StartReplay");
+            frames.clear();
+            return false;
+        }
+    }
+
+    // the end line is only written when the editor closes normally
+    if (!ended) {
+        TF_LOG_ERROR("RECORDING IS INCOMPLETE: " + path, "InputLog::StartReplay");
+        frames.clear();
+        return false;
+    }
+
+    mode = REPLAYING;
+    report_path = p_report_path;
+    replay_frame = 0;
+    replay_entry = 0;
+    current_entry = nullptr;
+    replay_times.clear();
+    replay_times.reserve(frames.size());
+    replay_delta_times.clear();
+    replay_delta_times.reserve(frames.size());
+    total_camera_mismatches = 0;
+    first_camera_mismatch = SIZE_MAX;
+    return true;
+}
+
+bool InputLog::IsRecording() const {
+    return mode == RECORDING;
+}
+
+bool InputLog::IsReplaying() const {
+    return mode == REPLAYING;
+}
+
+bool InputLog::IsFinished() const {
+    return mode == REPLAYING && replay_frame >= frames.size();
+}
+
+//=============================
+// FRAMES
+//=============================
+
+bool InputLog::PollEvent(SDL_Event& event_out) {
+    if (mode == REPLAYING) {
+        // real input is dropped, but closing the window still stops the replay
+        SDL_Event real_event;
+        while (SDL_PollEvent(&real_event)) {
+            if (real_event.type == SDL_EVENT_QUIT) {
+                event_out = real_event;
+                current_entry = nullptr;
+                return true;
+            }
+        }
+
+        if (replay_frame >= frames.size() || replay_entry >= frames[replay_frame].entries.size()) return false;
+
+        current_entry = &frames[replay_frame].entries[replay_entry++];
+        event_out = current_entry->event;
+        return true;
+    }
+
+    if (!SDL_PollEvent(&event_out)) return false;
+    if (mode == RECORDING) InputLog::_WriteEvent(event_out);
+    return true;
+}
+
+void InputLog::EndFrame(const Camera::State& camera_state, double delta_time, double work_time) {
+    if (mode == RECORDING) {
+        record_file << "frame " << delta_time << ' ' << work_time << ' ' << camera_state.position.x << ' ' << camera_state.position.y << ' ' << camera_state.position.z << ' ' << camera_state.yaw << ' ' << camera_state.pitch << '\n';
+        total_recorded_frames++;
+        return;
+    }
+
+    if (mode != REPLAYING || replay_frame >= frames.size()) return;
+
+    if (!InputLog::_CameraMatches(camera_state, frames[replay_frame].camera_state)) {
+        if (total_camera_mismatches == 0) first_camera_mismatch = replay_frame;
+        total_camera_mismatches++;
+    }
+
+    replay_times.push_back(work_time);
+    replay_delta_times.push_back(delta_time);
+    replay_frame++;
+    replay_entry = 0;
+}
+
+//=============================
+// ACTIONS
+//=============================
+
+void InputLog::RecordLoad(const std::string& path) {
+    if (mode == RECORDING) record_file << "action load " << path << '\n';
+}
+
+void InputLog::RecordNew() {
+    if (mode == RECORDING) record_file << "action new\n";
+}
+
+void InputLog::RecordColor(glm::vec3 color) {
+    if (mode == RECORDING) record_file << "action color " << color.r << ' ' << color.g << ' ' << color.b << '\n';
+}
+
+const std::string& InputLog::GetActionPath() const {
+    static const std::string no_path = "";
+    return current_entry != nullptr ? current_entry->action_path : no_path;
+}
+
+glm::vec3 InputLog::GetActionColor() const {
+    return current_entry != nullptr ? current_entry->action_color : glm::vec3(0.0f);
+}
+
+//=============================
+// FINISHING
+//=============================
+
+bool InputLog::Finish(const std::string& object_data) {
+    Uint64 hash = InputLog::_Hash(object_data);
+
+    if (mode == RECORDING) {
+        record_file << "end " << std::hex << hash << std::dec << ' ' << total_recorded_frames << '\n';
+        record_file.close();
+        mode = OFF;
+        TF_LOG_INFO("INPUT RECORDING WRITTEN, " + std::to_string(total_recorded_frames) + " FRAMES");
+        return true;
+    }
+
+    if (mode != REPLAYING) return true;
+    mode = OFF;
+
+    //// REPORT
+    std::vector<double> recorded_times = {};
+    recorded_times.reserve(frames.size());
+    size_t total_events = 0;
+    for (const Frame& frame : frames) {
+        recorded_times.push_back(frame.work_time);
+        total_events += frame.entries.size();
+    }
+
+    double total_replay_time = 0.0;
+    for (double replay_time : replay_times) total_replay_time += replay_time;
+
+    // wall time of each session, over the frames the replay got through
+    double total_recorded_session = 0.0;
+    double total_replayed_session = 0.0;
+    for (size_t i = 0; i < replay_delta_times.size(); i++) {
+        total_recorded_session += frames[i].delta_time;
+        total_replayed_session += replay_delta_times[i];
+    }
+
+    // replay_times stays in frame order for the report file
+    std::vector<double> sorted_replay_times = replay_times;
+    std::sort(recorded_times.begin(), recorded_times.end());
+    std::sort(sorted_replay_times.begin(), sorted_replay_times.end());
+
+    // anything logged during the replay goes above the report
+    Logger::Flush();
+    std::printf("replay    %zu of %zu frames, %zu events, %.1f ms\n", replay_times.size(), frames.size(), total_events, total_replay_time);
+    std::printf("recorded  p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n", Util::GetPercentile(recorded_times, 0.5), Util::GetPercentile(recorded_times, 0.95), Util::GetPercentile(recorded_times, 0.99), Util::GetPercentile(recorded_times, 1.0));
+    std::printf("replayed  p50 %.3f ms, p95 %.3f ms, p99 %.3f ms, max %.3f ms\n", Util::GetPercentile(sorted_replay_times, 0.5), Util::GetPercentile(sorted_replay_times, 0.95), Util::GetPercentile(sorted_replay_times, 0.99), Util::GetPercentile(sorted_replay_times, 1.0));
+    std::printf("session   recorded %.1f ms, replayed %.1f ms (%.2fx)\n", total_recorded_session, total_replayed_session, total_replayed_session > 0.0 ? total_recorded_session / total_replayed_session : 0.0);
+
+    if (total_camera_mismatches == 0) std::printf("camera    matched on every frame\n");
+    else std::printf("camera    differed on %zu frames, first at frame %zu\n", total_camera_mismatches, first_camera_mismatch);
+
+    std::printf("object    hash %016llx, recorded %016llx\n", (unsigned long long)hash, (unsigned long long)recorded_hash);
+
+    bool matched = replay_times.size() == frames.size() && total_camera_mismatches == 0 && hash == recorded_hash;
+    std::printf("result    %s\n", matched ? "match" : "MISMATCH");
+
+    if (!report_path.empty()) {
+        std::ofstream report_file(report_path, std::ios::out | std::ios::trunc);
+        if (!report_file) {
+            TF_LOG_ERROR("FAILED TO OPEN FILE: " + report_path, "InputLog::Finish");
+        } else {
+            report_file << "frame,events,recorded_ms,replayed_ms,recorded_delta_ms,replayed_delta_ms\n";
+            for (size_t i = 0; i < replay_times.size(); i++) {
+                report_file << i << ',' << frames[i].entries.size() << ',' << frames[i].work_time << ',' << replay_times[i] << ',' << frames[i].delta_time << ',' << replay_delta_times[i] << '\n';
+            }
+        }
+    }
+
+    std::fflush(stdout);
+    return matched;
+}
+
+//=============================
+// PARSING FUNCTIONS
+//=============================
+
+void InputLog::_WriteEvent(const SDL_Event& event) {
+    const char* name = GetEventName(event.type);
+    if (name == nullptr) return;
+
+    record_file << "event " << event.common.timestamp << ' ' << name;
+
+    switch (event.type) {
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            record_file << ' ' << int(event.button.button) << ' ' << int(event.button.clicks) << ' ' << event.button.x << ' ' << event.button.y;
+            break;
+
+        case SDL_EVENT_MOUSE_MOTION:
+            record_file << ' ' << event.motion.state << ' ' << event.motion.x << ' ' << event.motion.y << ' ' << event.motion.xrel << ' ' << event.motion.yrel;
+            break;
+
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            record_file << ' ' << event.key.key << ' ' << int(event.key.scancode) << ' ' << event.key.mod << ' ' << int(event.key.repeat);
+            break;
+    }
+
+    record_file << '\n';
+}
+
+bool InputLog::_ParseLine(const std::string& line, Frame& frame, bool& ended_out) {
+    std::istringstream line_stream(line);
+    std::string kind;
+    line_stream >> kind;
+
+    //// EVENTS
+    if (kind == "event") {
+        Entry entry;
+        std::string name;
+        Uint32 type = 0;
+        line_stream >> entry.event.common.timestamp >> name;
+        if (!line_stream || !GetEventType(name, type)) return false;
+        entry.event.type = type;
+
+        int button = 0, clicks = 0, scancode = 0, repeat = 0;
+        switch (type) {
+            case SDL_EVENT_MOUSE_BUTTON_DOWN:
+            case SDL_EVENT_MOUSE_BUTTON_UP:
+                line_stream >> button >> clicks >> entry.event.button.x >> entry.event.button.y;
+                entry.event.button.button = Uint8(button);
+                entry.event.button.clicks = Uint8(clicks);
+                entry.event.button.down = type == SDL_EVENT_MOUSE_BUTTON_DOWN;
+                break;
+
+            case SDL_EVENT_MOUSE_MOTION:
+                line_stream >> entry.event.motion.state >> entry.event.motion.x >> entry.event.motion.y >> entry.event.motion.xrel >> entry.event.motion.yrel;
+                break;
+
+            case SDL_EVENT_KEY_DOWN:
+            case SDL_EVENT_KEY_UP:
+                line_stream >> entry.event.key.key >> scancode >> entry.event.key.mod >> repeat;
+                entry.event.key.scancode = SDL_Scancode(scancode);
+                entry.event.key.repeat = repeat != 0;
+                entry.event.key.down = type == SDL_EVENT_KEY_DOWN;
+                break;
+        }
+
+        if (!line_stream) return false;
+        frame.entries.push_back(entry);
+        return true;
+    }
+
+    //// ACTIONS
+    if (kind == "action") {
+        Entry entry;
+        entry.event.type = SDL_EVENT_USER;
+        std::string action;
+        line_stream >> action;
+
+        if (action == "load") {
+            entry.event.user.code = LOAD_ACTION;
+            // the rest of the line, paths can have spaces
+            std::getline(line_stream >> std::ws, entry.action_path);
+            if (entry.action_path.empty()) return false;
+        } else if (action == "new") {
+            entry.event.user.code = NEW_ACTION;
+        } else if (action == "color") {
+            entry.event.user.code = COLOR_ACTION;
+            line_stream >> entry.action_color.r >> entry.action_color.g >> entry.action_color.b;
+            if (!line_stream) return false;
+        } else {
+            return false;
+        }
+
+        frame.entries.push_back(entry);
+        return true;
+    }
+
+    //// FRAMES
+    if (kind == "frame") {
+        line_stream >> frame.delta_time >> frame.work_time >> frame.camera_state.position.x >> frame.camera_state.position.y >> frame.camera_state.position.z >> frame.camera_state.yaw >> frame.camera_state.pitch;
+        if (!line_stream) return false;
+
+        frames.push_back(std::move(frame));
+        frame = Frame();
+        return true;
+    }
+
+    if (kind == "end") {
+        size_t total_frames = 0;
+        line_stream >> std::hex >> recorded_hash >> std::dec >> total_frames;
+        if (!line_stream || total_frames != frames.size() || !frame.entries.empty()) return false;
+
+        ended_out = true;
+        return true;
+    }
+
+    return false;
+}
+
+//=============================
+// REPORT FUNCTIONS
+//=============================
+
+Uint64 InputLog::_Hash(const std::string& data) {
+    // FNV-1a
+    Uint64 hash = 14695981039346656037ull;
+    for (unsigned char character : data) {
+        hash ^= character;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+bool InputLog::_CameraMatches(const Camera::State& a, const Camera::State& b) {
+    // recordings are replayed by other builds, so allow for float differences between them
+    return glm::all(glm::lessThanEqual(glm::abs(a.position - b.position), glm::vec3(1e-3f))) && std::abs(a.yaw - b.yaw) <= 1e-2f && std::abs(a.pitch - b.pitch) <= 1e-2f;
+}
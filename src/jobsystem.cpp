@@ -0,0 +1,202 @@
+#include "JobSystem.h"
+
+// index of the queue owned by the current thread. threads outside the pool have none
+static thread_local size_t current_queue_index = SIZE_MAX;
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+JobSystem::JobSystem(unsigned int thread_count) {
+    if (thread_count == 0) {
+        unsigned int hardware_threads = std::thread::hardware_concurrency();
+        thread_count = hardware_threads > 1 ? hardware_threads - 1 : 1;
+    }
+
+    for (unsigned int i = 0; i < thread_count; i++) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    for (unsigned int i = 0; i < thread_count; i++) {
+        threads.emplace_back(&JobSystem::_WorkerLoop, this, i);
+    }
+}
+
+//=============================
+// BASIC FUNCTIONS
+//=============================
+
+unsigned int JobSystem::ThreadCount() {
+    return threads.size() + 1;
+}
+
+//=============================
+// JOB FUNCTIONS
+//=============================
+
+void JobSystem::Submit(std::function<void()> p_job, Counter* counter) {
+    Job job;
+    job.function = std::move(p_job);
+    job.counter = counter;
+
+    if (counter) counter->pending.fetch_add(1, std::memory_order_relaxed);
+
+    JobSystem::_Push(std::move(job));
+}
+
+void JobSystem::Wait(Counter& counter) {
+    size_t queue_index = JobSystem::_CurrentQueue();
+
+    // help with queued work instead of blocking
+    while (counter.pending.load(std::memory_order_acquire) > 0) {
+        if (!JobSystem::_TryRunOne(queue_index)) std::this_thread::yield();
+    }
+}
+
+void JobSystem::ParallelFor(size_t count, size_t grain_size, const RangeFunction& function) {
+    if (count == 0) return;
+    if (grain_size == 0) grain_size = 1;
+
+    // not worth waking anyone up, run inline
+    if (count <= grain_size || threads.empty()) {
+        function(0, count);
+        return;
+    }
+
+    Counter counter;
+    size_t total_ranges = (count + grain_size - 1) / grain_size;
+    counter.pending.store(total_ranges, std::memory_order_relaxed);
+
+    // queue every range but the first, which the calling thread runs right away
+    for (size_t range = 1; range < total_ranges; range++) {
+        Job job;
+        job.range_function = &function;
+        job.start = range * grain_size;
+        job.end = std::min(job.start + grain_size, count);
+        job.counter = &counter;
+        JobSystem::_Push(std::move(job));
+    }
+
+    function(0, std::min(grain_size, count));
+    counter.pending.fetch_sub(1, std::memory_order_acq_rel);
+
+    JobSystem::Wait(counter);
+}
+
+size_t JobSystem::DefaultGrainSize(size_t count, size_t min_grain_size) {
+    // roughly 4 ranges per thread so uneven ranges still balance out
+    size_t target_ranges = size_t(JobSystem::ThreadCount()) * 4;
+    return std::max(min_grain_size, (count + target_ranges - 1) / target_ranges);
+}
+
+//=============================
+// PRIVATE JOB FUNCTIONS
+//=============================
+
+void JobSystem::_Push(Job job) {
+    size_t queue_index = current_queue_index;
+
+    // threads outside the pool spread their jobs round robin
+    if (queue_index >= queues.size()) queue_index = next_queue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+
+    // count first so the total never dips below zero when a worker grabs the job immediately
+    queued_jobs.fetch_add(1, std::memory_order_release);
+
+    {
+        std::lock_guard<std::mutex> lock(queues[queue_index]->mutex);
+        queues[queue_index]->jobs.push_back(std::move(job));
+    }
+
+    // take the lock so a worker between its check and its wait cannot miss this
+    { std::lock_guard<std::mutex> lock(wake_mutex); }
+    wake_condition.notify_one();
+}
+
+bool JobSystem::_Pop(size_t queue_index, Job& job_out) {
+    if (queue_index >= queues.size()) return false;
+
+    WorkerQueue& queue = *queues[queue_index];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.jobs.empty()) return false;
+
+    // newest first, its data is most likely still in cache
+    job_out = std::move(queue.jobs.back());
+    queue.jobs.pop_back();
+    return true;
+}
+
+bool JobSystem::_Steal(size_t queue_index, Job& job_out) {
+    size_t total_queues = queues.size();
+    size_t start = queue_index < total_queues ? queue_index + 1 : 0;
+
+    for (size_t i = 0; i < total_queues; i++) {
+        WorkerQueue& queue = *queues[(start + i) % total_queues];
+
+        // never wait on a busy queue, move on to the next victim
+        std::unique_lock<std::mutex> lock(queue.mutex, std::try_to_lock);
+        if (!lock.owns_lock() || queue.jobs.empty()) continue;
+
+        // oldest first, it is usually the largest remaining piece of work
+        job_out = std::move(queue.jobs.front());
+        queue.jobs.pop_front();
+        return true;
+    }
+
+    return false;
+}
+
+bool JobSystem::_TryRunOne(size_t queue_index) {
+    Job job;
+    if (!JobSystem::_Pop(queue_index, job) && !JobSystem::_Steal(queue_index, job)) return false;
+
+    queued_jobs.fetch_sub(1, std::memory_order_acq_rel);
+    JobSystem::_Run(job);
+    return true;
+}
+
+void JobSystem::_Run(Job& job) {
+    TF_PROFILE_SCOPE("JobSystem::_Run");
+    if (job.range_function) (*job.range_function)(job.start, job.end);
+    else if (job.function) job.function();
+
+    if (job.counter) job.counter->pending.fetch_sub(1, std::memory_order_acq_rel);
+}
+
+//=============================
+// WORKER FUNCTIONS
+//=============================
+
+void JobSystem::_WorkerLoop(size_t queue_index) {
+    current_queue_index = queue_index;
+    TF_PROFILE_THREAD("worker " + std::to_string(queue_index));
+
+    while (running.load(std::memory_order_acquire)) {
+        if (JobSystem::_TryRunOne(queue_index)) continue;
+
+        // nothing to run or steal, sleep until something is pushed
+        std::unique_lock<std::mutex> lock(wake_mutex);
+        wake_condition.wait(lock, [this]() {
+            return !running.load(std::memory_order_acquire) || queued_jobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+size_t JobSystem::_CurrentQueue() {
+    return current_queue_index;
+}
+
+//=============================
+// MEMORY MANAGEMENT
+//=============================
+
+JobSystem::~JobSystem() {
+    {
+        std::lock_guard<std::mutex> lock(wake_mutex);
+        running.store(false, std::memory_order_release);
+    }
+    wake_condition.notify_all();
+
+    for (auto& thread : threads) {
+        if (thread.joinable()) thread.join();
+    }
+}
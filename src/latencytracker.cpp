@@ -0,0 +1,144 @@
+#include "LatencyTracker.h"
+
+#include <algorithm>
+#include <iomanip>
+
+//=============================
+// BASIC FUNCTIONS
+//=============================
+
+void LatencyTracker::SetEnabled(bool p_enabled) {
+    if (p_enabled && !enabled) {
+        pending = {};
+        stage_ends = {};
+        measurements = {};
+    }
+    enabled = p_enabled;
+}
+
+bool LatencyTracker::IsEnabled() const {
+    return enabled;
+}
+
+//=============================
+// MEASURING
+//=============================
+
+void LatencyTracker::Begin(KIND kind, Uint64 event_timestamp) {
+    if (!enabled || pending[kind].active) return;
+
+    Uint64 now = SDL_GetTicksNS();
+    // events pushed without a timestamp start when they are handled
+    pending[kind] = {true, event_timestamp != 0 && event_timestamp <= now ? event_timestamp : now, now};
+}
+
+void LatencyTracker::Cancel(KIND kind) {
+    pending[kind].active = false;
+}
+
+void LatencyTracker::Mark(STAGE stage) {
+    if (enabled) stage_ends[stage] = SDL_GetTicksNS();
+}
+
+void LatencyTracker::EndFrame() {
+    if (!enabled) return;
+
+    if (stage_ends[PRESENT] != 0) {
+        for (size_t kind = 0; kind < TOTAL_KINDS; kind++) {
+            if (!pending[kind].active) continue;
+            Measurement& measurement = measurements[kind];
+
+            std::array<Uint64, TOTAL_STAGES> stage_times = {};
+            stage_times[INPUT] = pending[kind].handled_time - pending[kind].event_time;
+
+            // a stage the frame skipped ends where the one before it did
+            Uint64 previous_end = pending[kind].handled_time;
+            for (size_t stage = EVENTS; stage < TOTAL_STAGES; stage++) {
+                Uint64 stage_end = std::max(stage_ends[stage], previous_end);
+                stage_times[stage] = stage_end - previous_end;
+                previous_end = stage_end;
+            }
+
+            float total = float(double(previous_end - pending[kind].event_time) / 1000000.0);
+
+            // the newest MAX_SAMPLES are kept
+            if (measurement.samples.size() < MAX_SAMPLES) measurement.samples.push_back(total);
+            else measurement.samples[measurement.total_samples % MAX_SAMPLES] = total;
+            measurement.total_samples++;
+
+            size_t bucket = 0;
+            while (bucket < BUCKET_BOUNDS.size() && total >= BUCKET_BOUNDS[bucket]) bucket++;
+            measurement.buckets[bucket]++;
+
+            for (size_t stage = 0; stage < TOTAL_STAGES; stage++) {
+                measurement.stage_totals[stage] += double(stage_times[stage]);
+            }
+        }
+    }
+
+    pending = {};
+    stage_ends = {};
+}
+
+//=============================
+// REPORTING
+//=============================
+
+bool LatencyTracker::WriteReport(const std::string& path) const {
+    std::ofstream out_file(path, std::ios::out | std::ios::trunc);
+    if (!out_file) {
+        TF_LOG_ERROR("FAILED TO OPEN FILE: " + path, "LatencyTracker::WriteReport");
+        return false;
+    }
+
+    out_file << std::fixed << std::setprecision(2);
+
+    for (size_t kind = 0; kind < TOTAL_KINDS; kind++) {
+        const Measurement& measurement = measurements[kind];
+
+        out_file << LatencyTracker::_GetKindName(KIND(kind)) << ", " << measurement.total_samples << " samples\n";
+        if (measurement.total_samples == 0) {
+            out_file << '\n';
+            continue;
+        }
+
+        std::vector<double> sorted_samples(measurement.samples.begin(), measurement.samples.end());
+        std::sort(sorted_samples.begin(), sorted_samples.end());
+        out_file << "  p50 " << Util::GetPercentile(sorted_samples, 0.5) << " ms, p95 " << Util::GetPercentile(sorted_samples, 0.95) << " ms, p99 " << Util::GetPercentile(sorted_samples, 0.99) << " ms, max " << sorted_samples.back() << " ms\n";
+
+        out_file << "  mean";
+        for (size_t stage = 0; stage < TOTAL_STAGES; stage++) {
+            out_file << ' ' << LatencyTracker::_GetStageName(STAGE(stage)) << ' ' << measurement.stage_totals[stage] / double(measurement.total_samples) / 1000000.0 << " ms" << (stage + 1 < TOTAL_STAGES ? "," : "\n");
+        }
+
+        size_t largest_bucket = *std::max_element(measurement.buckets.begin(), measurement.buckets.end());
+        for (size_t bucket = 0; bucket < measurement.buckets.size(); bucket++) {
+            if (bucket < BUCKET_BOUNDS.size()) out_file << "  < " << std::setw(6) << BUCKET_BOUNDS[bucket] << " ms ";
+            else out_file << "  >=" << std::setw(6) << BUCKET_BOUNDS.back() << " ms ";
+            out_file << std::setw(8) << measurement.buckets[bucket] << ' ' << std::string(40 * measurement.buckets[bucket] / largest_bucket, '#') << '\n';
+        }
+        out_file << '\n';
+    }
+
+    return true;
+}
+
+const char* LatencyTracker::_GetKindName(KIND kind) {
+    switch (kind) {
+        case HOVER: return "hover";
+        case PLACE: return "place";
+        case DESTROY: return "destroy";
+        default: return "unknown";
+    }
+}
+
+const char* LatencyTracker::_GetStageName(STAGE stage) {
+    switch (stage) {
+        case INPUT: return "input";
+        case EVENTS: return "events";
+        case PICK: return "pick";
+        case RENDER: return "render";
+        case PRESENT: return "present";
+        default: return "unknown";
+    }
+}
@@ -0,0 +1,223 @@
+#include "Logger.h"
+
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <algorithm>
+
+std::array<Logger::Slot, Logger::QUEUE_MESSAGES> Logger::queue;
+std::atomic<Uint64> Logger::write_position{0};
+Uint64 Logger::read_position = 0;
+std::atomic<Uint64> Logger::written_position{0};
+std::atomic<Uint64> Logger::dropped_messages{0};
+
+std::thread Logger::writer;
+std::atomic<bool> Logger::stop_requested{false};
+std::atomic<bool> Logger::stopped{false};
+std::mutex Logger::drain_mutex;
+
+namespace {
+    std::once_flag start_flag;
+
+    void CopyText(char* destination, size_t size, std::string_view text) {
+        size_t length = std::min(text.size(), size - 1);
+        text.copy(destination, length);
+        destination[length] = '\0';
+    }
+}
+
+//=============================
+// LOGGING
+//=============================
+
+void Logger::Write(LEVEL level, CallSite& site, std::string_view message, std::string_view function) {
+    Uint32 suppressed_messages = 0;
+    if (!Logger::_PassRateLimit(site, suppressed_messages)) return;
+
+    Message new_message;
+    new_message.level = level;
+    new_message.time = std::time(nullptr);
+    new_message.suppressed_messages = suppressed_messages;
+    CopyText(new_message.function, FUNCTION_SIZE, function);
+    CopyText(new_message.text, TEXT_SIZE, message);
+
+    // no writer left to hand it to
+    if (stopped.load(std::memory_order_acquire)) {
+        std::lock_guard<std::mutex> lock(drain_mutex);
+        std::string text;
+        Logger::_Format(new_message, text);
+        Logger::_Output(text);
+        return;
+    }
+
+    std::call_once(start_flag, Logger::_Start);
+
+    // claim a slot, the one at position is free once its sequence caught up to it
+    Uint64 position = write_position.load(std::memory_order_relaxed);
+    Slot* slot = nullptr;
+    while (true) {
+        slot = &queue[size_t(position & (QUEUE_MESSAGES - 1))];
+        Uint64 sequence = slot->sequence.load(std::memory_order_acquire);
+
+        if (sequence == position) {
+            if (write_position.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+        } else if (sequence < position) {
+            // still holds a message from the last lap, the queue is full
+            dropped_messages.fetch_add(1, std::memory_order_relaxed);
+            return;
+        } else {
+            position = write_position.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot->message = new_message;
+    slot->sequence.store(position + 1, std::memory_order_release);
+
+    // Stop() may have done its last drain before this was published, pairs with the fence in Stop()
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (stopped.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(drain_mutex);
+        std::string text;
+        Logger::_DrainAndOutput(text);
+    }
+}
+
+//=============================
+// WRITER
+//=============================
+
+void Logger::Flush() {
+    Uint64 target = write_position.load(std::memory_order_acquire);
+
+    while (written_position.load(std::memory_order_acquire) < target) {
+        if (stopped.load(std::memory_order_acquire)) {
+            // the writer is gone or going, wait for Stop() and write the rest here
+            std::lock_guard<std::mutex> lock(drain_mutex);
+            std::string text;
+            Logger::_DrainAndOutput(text);
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+}
+
+void Logger::Stop() {
+    // held until the last drain, so a Write() that sees stopped waits for the writer to be joined
+    std::lock_guard<std::mutex> lock(drain_mutex);
+    if (stopped.exchange(true, std::memory_order_acq_rel)) return;
+    // a Write() either sees stopped after publishing or its message is seen by the drain below
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    stop_requested.store(true, std::memory_order_release);
+    if (writer.joinable()) writer.join();
+
+    // anything queued between the writer's last drain and stopped being set
+    std::string text;
+    Logger::_DrainAndOutput(text);
+}
+
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
+
+void Logger::_Start() {
+    for (size_t i = 0; i < QUEUE_MESSAGES; i++) {
+        queue[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    writer = std::thread(Logger::_WriterLoop);
+    std::atexit(Logger::Stop);
+}
+
+bool Logger::_PassRateLimit(CallSite& site, Uint32& suppressed_out) {
+    Uint64 now = SDL_GetTicks();
+    Uint64 window_start = site.window_start.load(std::memory_order_relaxed);
+
+    // only the thread that moves the window resets it, the counts are approximate across threads
+    if ((window_start == 0 || now - window_start >= RATE_LIMIT_WINDOW) && site.window_start.compare_exchange_strong(window_start, now == 0 ? 1 : now, std::memory_order_relaxed)) {
+        site.window_messages.store(0, std::memory_order_relaxed);
+        suppressed_out = site.suppressed_messages.exchange(0, std::memory_order_relaxed);
+    }
+
+    if (site.window_messages.fetch_add(1, std::memory_order_relaxed) < RATE_LIMIT_MESSAGES) return true;
+
+    site.suppressed_messages.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+void Logger::_WriterLoop() {
+    std::string text;
+
+    while (true) {
+        bool stopping = stop_requested.load(std::memory_order_acquire);
+
+        size_t total_messages = Logger::_DrainAndOutput(text);
+
+        if (stopping) return;
+        if (total_messages == 0) std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_SLEEP));
+    }
+}
+
+size_t Logger::_Drain(std::string& out) {
+    size_t total_messages = 0;
+
+    while (true) {
+        Slot& slot = queue[size_t(read_position & (QUEUE_MESSAGES - 1))];
+        if (slot.sequence.load(std::memory_order_acquire) != read_position + 1) break;
+
+        Logger::_Format(slot.message, out);
+        // frees the slot for the next lap
+        slot.sequence.store(read_position + QUEUE_MESSAGES, std::memory_order_release);
+        read_position++;
+        total_messages++;
+    }
+
+    Uint64 total_dropped = dropped_messages.exchange(0, std::memory_order_relaxed);
+    if (total_dropped > 0) {
+        Message dropped_message;
+        dropped_message.level = WARNING_LEVEL;
+        dropped_message.time = std::time(nullptr);
+        CopyText(dropped_message.function, FUNCTION_SIZE, "Logger");
+        CopyText(dropped_message.text, TEXT_SIZE, "LOG QUEUE FULL, " + std::to_string(total_dropped) + " MESSAGES DROPPED");
+        Logger::_Format(dropped_message, out);
+    }
+
+    return total_messages;
+}
+
+size_t Logger::_DrainAndOutput(std::string& text) {
+    size_t total_messages = Logger::_Drain(text);
+    if (!text.empty()) {
+        Logger::_Output(text);
+        text.clear();
+    }
+
+    written_position.store(read_position, std::memory_order_release);
+    return total_messages;
+}
+
+void Logger::_Format(const Message& message, std::string& out) {
+    static const char* LEVEL_NAMES[] = {"DEBUG", "INFO", "WARNING", "ERROR"};
+
+    // localtime() isn't thread safe, this only runs on the writer (or under drain_mutex after it stopped)
+    std::tm* local_time = std::localtime(&message.time);
+    char time_text[16] = "??:??:??";
+    if (local_time != nullptr) std::strftime(time_text, sizeof(time_text), "%H:%M:%S", local_time);
+
+    out += LEVEL_NAMES[message.level];
+    out += " | ";
+    if (message.function[0] != '\0') {
+        out += message.function;
+        out += " | ";
+    }
+    out += time_text;
+    out += " || ";
+    out += message.text;
+    if (message.suppressed_messages > 0) out += " (" + std::to_string(message.suppressed_messages) + " SIMILAR SUPPRESSED)";
+    out += '\n';
+}
+
+void Logger::_Output(const std::string& text) {
+    std::fwrite(text.data(), 1, text.size(), stdout);
+    std::fflush(stdout);
+}
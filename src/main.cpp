@@ -37,6 +37,7 @@ ZANE WEBSTER
 #include "WindowHandler.h"
 #include "AudioHandler.h"
 #include "Renderer.h"
+#include "JobSystem.h"
 
 // textures
 #include "Texture.h"
@@ -54,17 +55,43 @@ ZANE WEBSTER
 
 // object creator
 #include "Creator.h"
+#include "CommandLine.h"
 #include "BlockCursor.h"
+#include "InputLog.h"
+#include "LatencyTracker.h"
+
+// overlays
+#include "StatsHud.h"
 
 #define GLM_ENABLE_EXPERIMENTAL
 #include "glm/ext.hpp"
 
 int main(int argc, char* argv[]) {
+    ////////// HEADLESS
+    // no window, context or audio, see CommandLine.h for the options
+    if (CommandLine::IsHeadless(argc, argv)) return CommandLine::Run(argc, argv);
+
+    ////////// INPUT RECORDING
+    // --record FILE or --replay FILE [--headless] [--report FILE], see InputLog.h
+    if (argc > 1) CommandLine::AttachParentConsole();
+
+    InputLog::Options input_options;
+    if (!InputLog::ParseArguments(argc, argv, input_options)) return 1;
+
+    InputLog input_log;
+    if (!input_options.record_path.empty() && !input_log.StartRecording(input_options.record_path)) return 1;
+    if (!input_options.replay_path.empty() && !input_log.StartReplay(input_options.replay_path, input_options.report_path)) return 1;
+
+    // before anything can make an OpenGL call
+    if (input_options.headless) GLDispatch::SetBackend(GLDispatch::NULL_BACKEND);
+
     ////////// APP INITILIZATION
-    SDL_Init(SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_EVENTS);
+    SDL_Init(input_options.headless ? SDL_INIT_EVENTS : SDL_INIT_AUDIO | SDL_INIT_VIDEO | SDL_INIT_EVENTS);
     TTF_Init();
+    TF_PROFILE_THREAD("main");
 
     ////////// APP HANDLERS
+    JobSystem job_system;
     WindowHandler window_handler(1920, 1080, {0.025f, 0.05f, 0.10f, 1.0f}, "TotalFrame3D Object Creator", false, 60.0f);
     AudioHandler audio_handler;
     Renderer renderer;
@@ -75,6 +102,9 @@ int main(int argc, char* argv[]) {
 
     window_handler.PassNamePtr(creator.GetName());
 
+    // replayed frames run back to back
+    if (input_log.IsReplaying()) window_handler.SetTargetFps(0.0f);
+
     ////////// APP VARIABLES
     //// GENERAL
     bool app_running = true;
@@ -82,8 +112,15 @@ int main(int argc, char* argv[]) {
     SDL_Event event;
     std::string app_state = "game";
     //// INPUT
-    float mouse_x, mouse_y; //SDL_GetMouseState(&mouse_x, &mouse_y);
-    Cube mouse_cube;
+    // from the last mouse event, not SDL_GetMouseState(), so replays see the same positions
+    float mouse_x = 0.0f, mouse_y = 0.0f;
+    // the hovered cube, caught up with block_cursor.UpdateHover() before use
+    size_t mouse_cube = SIZE_MAX;
+    //// BULK EDITING
+    // first corner of the box for filling, erasing and copying, the hovered cube is the other one
+    glm::vec3 bulk_corner = glm::vec3(0.0f);
+    bool bulk_corner_set = false;
+    Object::Clipboard clipboard;
     std::shared_ptr<double> delta_time = window_handler.DeltaTime();
     TotalFrame::KEYSET keyset = TotalFrame::KEYSET::WASD;
     TF_MOVEMENT_KEYSET movement_keys = TotalFrame::MOVEMENT_KEYS[keyset];
@@ -102,10 +139,11 @@ int main(int argc, char* argv[]) {
     GLuint cube_sp = shader_handler.CreateShaderProgram("res/shaders/cube");
     GLuint block_cursor_sp = shader_handler.CreateShaderProgram("res/shaders/block_cursor");
     GLuint skybox_sp = shader_handler.CreateShaderProgram("res/shaders/skybox");
+    GLuint hud_sp = shader_handler.CreateShaderProgram("res/shaders/hud");
 
     Skybox skybox("res/skybox", skybox_sp);
 
-    Object object(TotalFrame::OBJECT_TYPE::CUBE_OBJ, window_handler.aspect_ratio);
+    Object object(TotalFrame::OBJECT_TYPE::CUBE_OBJ, window_handler.aspect_ratio, &job_system);
 
     creator.SetCubeDefault(Cube("cube", TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, "res/tfobj/0.05_cube.tfobj_dev", cube_sp, window_handler.aspect_ratio));
 
@@ -115,11 +153,30 @@ int main(int argc, char* argv[]) {
 
     BlockCursor block_cursor("block cursor", TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, "res/tfobj/0.05_cube.tfobj_dev", block_cursor_sp, window_handler.aspect_ratio);
 
+    ////////// RENDER REGISTRATION
+    // registered once, the renderer keeps references and draws them in layer order every frame
+    renderer.Add(skybox, 1);
+    renderer.Add(object, 2);
+
     ////////// TEXT
+    // toggled with F3, stays off if no font is found
+    StatsHud stats_hud(hud_sp, window_handler.width, window_handler.height);
+
+    ////////// LATENCY
+    // toggled with F10, the report is written to latency.txt when it is turned off
+    LatencyTracker latency_tracker;
 
     ////////// MAIN LOOP
     while (app_running) {
+        {
+            // blocks while idle, paces frames while something changes
+            TF_PROFILE_SCOPE("WindowHandler::WaitForNextFrame");
+            window_handler.WaitForNextFrame(camera.IsMoving() || input_log.IsReplaying());
+        }
+        TF_PROFILE_SCOPE("main frame");
         window_handler.UpdateDeltaTime(SDL_GetPerformanceCounter(), SDL_GetPerformanceFrequency());
+        // after waiting, so only the work shows in the stats
+        Uint64 frame_start = SDL_GetPerformanceCounter();
 
         //=============================
         // GAME
@@ -142,181 +199,290 @@ int main(int argc, char* argv[]) {
             }
 
             ////////// EVENTS
-            while (SDL_PollEvent(&event)) {
-                switch (event.type) {
-                    case SDL_EVENT_QUIT: 
-                        app_running = false;
-                        break;
+            {
+                TF_PROFILE_SCOPE("main events");
+                while (input_log.PollEvent(event)) {
+                    switch (event.type) {
+                        case SDL_EVENT_QUIT: 
+                            app_running = false;
+                            break;
                     
-                    case SDL_EVENT_MOUSE_BUTTON_DOWN:
-                        ////////
-                        //
-                        // CUBE PLACEMENT
-                        //
-                        ////////
-
-                        if (event.button.button == SDL_BUTTON_LEFT) {
-                            //// CHECK IF HITTING CUBE FACE
-                            glm::vec3 face_hit_pos;
-                            //// GET FIRST CUBE HIT
-                            mouse_cube = object.GetRayCollidingCubeWithFace(camera.MouseToWorldRay(mouse_x, mouse_y), face_hit_pos);
-                            block_cursor.PlaceOnFace(mouse_cube.GetPosition(), face_hit_pos);
-                        
-                            if (block_cursor.visible) {
+                        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+                            // before the catch up pick, so it counts towards the click
+                            if (event.button.button == SDL_BUTTON_LEFT) latency_tracker.Begin(LatencyTracker::PLACE, event.button.timestamp);
+                            if (event.button.button == SDL_BUTTON_RIGHT) latency_tracker.Begin(LatencyTracker::DESTROY, event.button.timestamp);
+
+                            //// HOVER
+                            // catch up with the motion folded in so far this frame
+                            if (block_cursor.UpdateHover(object, camera, mouse_x, mouse_y)) window_handler.NeedRender();
+                            mouse_cube = block_cursor.GetHoveredCube();
+
+                            ////////
+                            //
+                            // CUBE PLACEMENT
+                            //
+                            ////////
+
+                            // the cursor already sits on the hovered face
+                            if (event.button.button == SDL_BUTTON_LEFT && block_cursor.visible) {
                                 creator.UpdateCubeDefaultPosition(block_cursor.NextCubePosition());
                                 object.Create(creator.GetCubeDefault().name, creator.GetCubeDefaultPosition(), creator.GetCubeDefault().size[0], "", creator.GetCubeDefault().shader_program, creator.GetCubeDefault().GetData());
+                                block_cursor.InvalidateHover();
                                 window_handler.NeedRender();
+                            } else if (event.button.button == SDL_BUTTON_LEFT) {
+                                latency_tracker.Cancel(LatencyTracker::PLACE);
                             }
-                        }
-
-                        if (event.button.button == SDL_BUTTON_RIGHT) {
-                            //// CHECK IF HITTING CUBE FACE
-                            glm::vec3 face_hit_pos;
-                            //// GET FIRST CUBE HIT
-                            mouse_cube = object.GetRayCollidingCubeWithFace(camera.MouseToWorldRay(mouse_x, mouse_y), face_hit_pos);
-                        
-                            if (face_hit_pos != glm::vec3(-1000.0f)) {
-                                object.Destory(object.GetRayCollidingCubeWithFacePtr(camera.MouseToWorldRay(mouse_x, mouse_y), face_hit_pos));
+
+                            if (event.button.button == SDL_BUTTON_RIGHT && mouse_cube != SIZE_MAX) {
+                                object.Destory(mouse_cube);
+                                block_cursor.InvalidateHover();
                                 window_handler.NeedRender();
+                            } else if (event.button.button == SDL_BUTTON_RIGHT) {
+                                latency_tracker.Cancel(LatencyTracker::DESTROY);
+                            }
+
+                            ////////
+                            //
+                            // MOUSE MOVEMENT
+                            //
+                            ////////
+
+                            if (event.button.button == SDL_BUTTON_MIDDLE) {
+                                mouse_x = event.button.x;
+                                mouse_y = event.button.y;
+                                camera.StartMouseMove(mouse_x, mouse_y);
+                            }
+                            break;
+
+                        case SDL_EVENT_MOUSE_MOTION:
+                            mouse_x = event.motion.x;
+                            mouse_y = event.motion.y;
+                            latency_tracker.Begin(LatencyTracker::HOVER, event.motion.timestamp);
+
+                            if (event.motion.state && SDL_BUTTON_MMASK) {
+                                if (camera.UpdateMouseMovement(mouse_x, mouse_y)) window_handler.NeedRender();
                             }
-                        }
-
-                        ////////
-                        //
-                        // MOUSE MOVEMENT
-                        //
-                        ////////
-
-                        if (event.button.button == SDL_BUTTON_MIDDLE) {
-                            SDL_GetMouseState(&mouse_x, &mouse_y);
-                            camera.StartMouseMove(mouse_x, mouse_y);
-                        }
-                        break;
-
-                    case SDL_EVENT_MOUSE_MOTION:
-                        SDL_GetMouseState(&mouse_x, &mouse_y);
-
-                        if (block_cursor.visible) {
-                            window_handler.NeedRender();
-                        }
-
-                        if (event.motion.state && SDL_BUTTON_MMASK) {
-                            SDL_GetMouseState(&mouse_x, &mouse_y);
-                            if (camera.UpdateMouseMovement(mouse_x, mouse_y)) window_handler.NeedRender();
-                        } else {
+
                             //// FACE TESTING
-                            glm::vec3 face_hit_pos; 
-                            mouse_cube = object.GetRayCollidingCubeWithFace(camera.MouseToWorldRay(mouse_x, mouse_y), face_hit_pos);
-                            block_cursor.PlaceOnFace(mouse_cube.GetPosition(), face_hit_pos);
-                        }
-                        break;
-
-                    case SDL_EVENT_MOUSE_BUTTON_UP:
-                        if (event.button.button == SDL_BUTTON_MIDDLE) {
-                            camera.StopMouseMove();
-                        }
-                        break;
-
-                    case SDL_EVENT_KEY_DOWN:
-                        ////////
-                        //
-                        // FUNCTION KEYS
-                        //
-                        ////////
-
-                        if (SDL_GetModState() & SDL_KMOD_ALT) {
-                            //// SAVING
-                            if (event.key.key == SDLK_S) {
-                                creator.Save(object.GetData());
-                                window_handler.UpdateName();
+                            // folded into a single pick once the queue is drained, however many motion events a frame gets
+                            block_cursor.InvalidateHover();
+                            break;
+
+                        case SDL_EVENT_MOUSE_BUTTON_UP:
+                            if (event.button.button == SDL_BUTTON_MIDDLE) {
+                                camera.StopMouseMove();
                             }
+                            break;
+
+                        case SDL_EVENT_KEY_DOWN:
+                            ////////
+                            //
+                            // FUNCTION KEYS
+                            //
+                            ////////
+
+                            // dialogs, saving and exporting are skipped while replaying, the dialogs' results are replayed as SDL_EVENT_USER
+                            if (event.key.mod & SDL_KMOD_ALT) {
+                                //// HOVER
+                                // catch up with the motion folded in so far this frame, edits below then leave it stale
+                                if (block_cursor.UpdateHover(object, camera, mouse_x, mouse_y)) window_handler.NeedRender();
+                                mouse_cube = block_cursor.GetHoveredCube();
+                                block_cursor.InvalidateHover();
+
+                                //// SAVING
+                                if (event.key.key == SDLK_S && !input_log.IsReplaying()) {
+                                    Uint64 save_start = SDL_GetPerformanceCounter();
+                                    if (creator.Save(object.GetData())) object.SaveLatticeIndex(creator.GetPath());
+                                    stats_hud.SetSaveTime(Util::GetElapsedMilliseconds(save_start));
+                                    window_handler.UpdateName();
+                                }
+
+                                //// LOADING
+                                if (event.key.key == SDLK_O && !input_log.IsReplaying()) {
+                                    if (*creator.GetName() != "untitled" && creator.Save(object.GetData())) object.SaveLatticeIndex(creator.GetPath());
+                                    std::string loaded_object_path = creator.Load();
+                                    if (loaded_object_path != "\n") {
+                                        input_log.RecordLoad(loaded_object_path);
+                                        object.ClearAndCreate("new object", TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, loaded_object_path, cube_sp);
+                                        window_handler.NeedRender();
+                                        window_handler.UpdateName();
+                                    }
+                                }
+
+                                //// NEW OBJECT
+                                if (event.key.key == SDLK_N && !input_log.IsReplaying()) {
+                                    if (*creator.GetName() != "untitled" && creator.Save(object.GetData())) object.SaveLatticeIndex(creator.GetPath());
+                                    if (creator.NewObject()) {
+                                        input_log.RecordNew();
+                                        object.ClearAndCreate("starting cube", TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, "res/tfobj/0.05_cube.tfobj_dev", cube_sp);
+                                        window_handler.NeedRender();
+                                        window_handler.UpdateName();
+                                    }
+                                }
 
-                            //// LOADING
-                            if (event.key.key == SDLK_O) {
-                                if (*creator.GetName() != "untitled") creator.Save(object.GetData());
-                                std::string loaded_object_path = creator.Load();
-                                if (loaded_object_path != "\n") {
-                                    object.ClearAndCreate("new object", TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, loaded_object_path, cube_sp);
+                                //// EXPORT
+                                // exporting trims the object's hidden triangles in place, so the app closes after it and the time is logged instead of shown
+                                if (event.key.key == SDLK_M && !input_log.IsReplaying()) {
+                                    Uint64 export_start = SDL_GetPerformanceCounter();
+                                    std::string export_data = object.GetExportData();
+                                    double export_time = Util::GetElapsedMilliseconds(export_start);
+                                    if (creator.Export(export_data)) TF_LOG_INFO("EXPORTED IN " + std::to_string(int(export_time + 0.5)) + " MS");
+                                    app_running = false;
+                                    break;
+                                }
+
+                                //// COLOR PICKER
+                                if (event.key.key == SDLK_T && mouse_cube != SIZE_MAX) {
+                                    creator.SetCubeDefaultColor(object.GetCubeColor(mouse_cube));
+                                }
+                            
+                                //// PAINTING
+                                if (event.key.key == SDLK_P && mouse_cube != SIZE_MAX) {
+                                    object.SetCubeColor(mouse_cube, creator.GetCubeDefault().GetColor());
                                     window_handler.NeedRender();
-                                    window_handler.UpdateName();
                                 }
-                            }
 
-                            //// NEW OBJECT
-                            if (event.key.key == SDLK_N) {
-                                if (*creator.GetName() != "untitled") creator.Save(object.GetData());
-                                if (creator.NewObject()) {
-                                    object.ClearAndCreate("starting cube", TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, "res/tfobj/0.05_cube.tfobj_dev", cube_sp);
+                                //// BULK EDITING
+                                if (event.key.key == SDLK_B && mouse_cube != SIZE_MAX) {
+                                    bulk_corner = object.GetCubePosition(mouse_cube);
+                                    bulk_corner_set = true;
+                                }
+
+                                // boxes are filled up to the cursor, erased and copied up to the hovered cube
+                                if (bulk_corner_set && block_cursor.visible) {
+                                    if (event.key.key == SDLK_F && object.FillBox(bulk_corner, block_cursor.NextCubePosition(), creator.GetCubeDefault()) > 0) window_handler.NeedRender();
+                                    if (event.key.key == SDLK_H && object.HollowBox(bulk_corner, block_cursor.NextCubePosition(), creator.GetCubeDefault()) > 0) window_handler.NeedRender();
+                                }
+                                if (bulk_corner_set && mouse_cube != SIZE_MAX) {
+                                    if (event.key.key == SDLK_X && object.EraseBox(bulk_corner, object.GetCubePosition(mouse_cube)) > 0) window_handler.NeedRender();
+                                    if (event.key.key == SDLK_C) clipboard = object.CopyRegion(bulk_corner, object.GetCubePosition(mouse_cube));
+                                }
+
+                                if (event.key.key == SDLK_V && block_cursor.visible && object.PasteRegion(clipboard, block_cursor.NextCubePosition()) > 0) window_handler.NeedRender();
+
+                                //// FLOOD FILL
+                                if (event.key.key == SDLK_G && mouse_cube != SIZE_MAX && object.FloodFill(mouse_cube, creator.GetCubeDefault().GetColor()) > 0) window_handler.NeedRender();
+
+                                //// HOLLOWING
+                                if (event.key.key == SDLK_I && object.Hollow() > 0) window_handler.NeedRender();
+
+                                //// OBJECT TRANSLATION
+                                if (event.key.key == SDLK_DOWN) {
+                                    object.Translate(glm::vec3(0.0f, -0.05f, 0.0f));
+                                    window_handler.NeedRender();
+                                }
+                                if (event.key.key == SDLK_UP) {
+                                    object.Translate(glm::vec3(0.0f, 0.05f, 0.0f));
+                                    window_handler.NeedRender();
+                                }
+                                if (event.key.key == SDLK_LEFT) {
+                                    object.Translate(glm::vec3(-0.05f, 0.0f, 0.0f));
+                                    window_handler.NeedRender();
+                                }
+                                if (event.key.key == SDLK_RIGHT) {
+                                    object.Translate(glm::vec3(0.05f, 0.0f, 0.0f));
                                     window_handler.NeedRender();
-                                    window_handler.UpdateName();
                                 }
                             }
 
-                            //// EXPORT
-                            if (event.key.key == SDLK_M) {
-                                creator.Export(object.GetExportData());
-                                app_running = false;
-                                break;
+                            if (event.key.key == SDLK_TAB && !input_log.IsReplaying()) {
+                                creator.ChooseColor();
+                                input_log.RecordColor(glm::vec3(creator.color));
                             }
 
-                            //// COLOR PICKER
-                            if (event.key.key == SDLK_T) {
-                                glm::vec3 face_hit_pos;
-                                //// GET FIRST CUBE HIT
-                                mouse_cube = object.GetRayCollidingCubeWithFace(camera.MouseToWorldRay(mouse_x, mouse_y), face_hit_pos);
-                            
-                                if (face_hit_pos != glm::vec3(-1000.0f)) {
-                                    creator.SetCubeDefaultColor(mouse_cube.GetColor());
-                                }
-                            }
-                            
-                            //// OBJECT TRANSLATION
-                            if (event.key.key == SDLK_DOWN) {
-                                object.Translate(glm::vec3(0.0f, -0.05f, 0.0f));
+                            //// STATS
+                            if (event.key.key == SDLK_F3 && stats_hud.IsEnabled()) {
+                                stats_hud.visible = !stats_hud.visible;
                                 window_handler.NeedRender();
                             }
-                            if (event.key.key == SDLK_UP) {
-                                object.Translate(glm::vec3(0.0f, 0.05f, 0.0f));
-                                window_handler.NeedRender();
+
+                            //// HOLLOW ON LOAD
+                            if (event.key.key == SDLK_F9) {
+                                object.hollow_on_load = !object.hollow_on_load;
+                                TF_LOG_INFO(object.hollow_on_load ? "HOLLOW ON LOAD ON" : "HOLLOW ON LOAD OFF");
                             }
-                            if (event.key.key == SDLK_LEFT) {
-                                object.Translate(glm::vec3(-0.05f, 0.0f, 0.0f));
-                                window_handler.NeedRender();
+
+                            //// GL RECORDING
+                            if (event.key.key == SDLK_F11) {
+                                if (GLDispatch::IsRecording()) {
+                                    GLDispatch::StopRecording();
+                                    TF_LOG_INFO("GL RECORDING WRITTEN TO gl_stream.txt");
+                                } else if (GLDispatch::StartRecording("gl_stream.txt")) {
+                                    TF_LOG_INFO("GL RECORDING STARTED");
+                                }
                             }
-                            if (event.key.key == SDLK_RIGHT) {
-                                object.Translate(glm::vec3(0.05f, 0.0f, 0.0f));
-                                window_handler.NeedRender();
+
+                            //// LATENCY
+                            // replayed timestamps are from the recording, nothing to measure
+                            if (event.key.key == SDLK_F10 && !input_log.IsReplaying()) {
+                                if (!latency_tracker.IsEnabled()) {
+                                    latency_tracker.SetEnabled(true);
+                                    TF_LOG_INFO("LATENCY MEASUREMENT STARTED");
+                                } else {
+                                    latency_tracker.SetEnabled(false);
+                                    if (latency_tracker.WriteReport("latency.txt")) TF_LOG_INFO("LATENCY REPORT WRITTEN TO latency.txt");
+                                }
                             }
-                        }
 
-                        if (event.key.key == SDLK_TAB) {
-                            creator.ChooseColor();
-                        }
+                            //// PROFILING
+                            if (event.key.key == SDLK_F12 && Profiler::WriteTrace("trace.json")) TF_LOG_INFO("TRACE WRITTEN TO trace.json");
 
-                        ////////
-                        //
-                        // KEYBOARD MOVEMENT
-                        //
-                        ////////
+                            ////////
+                            //
+                            // KEYBOARD MOVEMENT
+                            //
+                            ////////
 
-                        for (auto movement_key : movement_keys) {
-                            if (event.key.key == movement_key) {
-                                camera.StartMove(event.key.key);
+                            for (auto movement_key : movement_keys) {
+                                if (event.key.key == movement_key) {
+                                    camera.StartMove(event.key.key);
+                                }
+                            }
+                            break;
+
+                        case SDL_EVENT_KEY_UP:
+                            for (auto movement_key : movement_keys) {
+                                if (event.key.key == movement_key) {
+                                    camera.StopMove(event.key.key);
+                                }
+                            }
+                            break;
+
+                        case SDL_EVENT_USER:
+                            ////////
+                            //
+                            // REPLAYED DIALOGS
+                            //
+                            ////////
+
+                            if (event.user.code == InputLog::LOAD_ACTION) {
+                                object.ClearAndCreate("new object", TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, input_log.GetActionPath(), cube_sp);
+                                window_handler.NeedRender();
                             }
-                        }
-                        break;
 
-                    case SDL_EVENT_KEY_UP:
-                        for (auto movement_key : movement_keys) {
-                            if (event.key.key == movement_key) {
-                                camera.StopMove(event.key.key);
+                            if (event.user.code == InputLog::NEW_ACTION) {
+                                object.ClearAndCreate("starting cube", TotalFrame::READ_POS_FROM_FILE, TotalFrame::READ_SIZE_FROM_FILE, "res/tfobj/0.05_cube.tfobj_dev", cube_sp);
+                                window_handler.NeedRender();
                             }
-                        }
-                        break;
+
+                            if (event.user.code == InputLog::COLOR_ACTION) creator.SetCubeDefaultColor(input_log.GetActionColor());
+                            block_cursor.InvalidateHover();
+                            break;
+                    }
                 }
             }
+            latency_tracker.Mark(LatencyTracker::EVENTS);
 
-            if (camera.UpdateMovement()) window_handler.NeedRender();
+            if (camera.UpdateMovement()) {
+                block_cursor.InvalidateHover();
+                window_handler.NeedRender();
+            }
+
+            //// HOVER
+            // the one pick of the frame, for everything that moved the mouse, camera or cubes since the last
+            if (block_cursor.UpdateHover(object, camera, mouse_x, mouse_y)) window_handler.NeedRender();
+            mouse_cube = block_cursor.GetHoveredCube();
+            latency_tracker.Mark(LatencyTracker::PICK);
 
             ////////
             //
@@ -325,11 +491,9 @@ int main(int argc, char* argv[]) {
             ////////
 
             if (window_handler.StartRender()) {
+                TF_PROFILE_SCOPE("main render");
                 window_handler.Clear();
-                renderer.Clear();
-
-                renderer.Add(skybox, 1);
-                renderer.Add(object, 2);
+                renderer.Update(camera.GetViewMatrix(), camera.GetProjectionMatrix(), camera.position);
 
                 camera.UpdateShaderPrograms(renderer.GetShaderProgramsUpdates());
 
@@ -341,20 +505,49 @@ int main(int argc, char* argv[]) {
                     object.UpdateAndRender(block_cursor.cube, camera.GetProjectionMatrix() * camera.GetViewMatrix(), camera.position, light_handler.lights);
                 }
 
-                window_handler.Update();
+                // shows the previous frame's time, this one is still going
+                stats_hud.Render(renderer.GetRenderStats(), object.GetCullStats(), object.GetLastPickTime());
+
+                latency_tracker.Mark(LatencyTracker::RENDER);
+                {
+                    TF_PROFILE_SCOPE("WindowHandler::Update");
+                    window_handler.Update();
+                }
+                latency_tracker.Mark(LatencyTracker::PRESENT);
                 window_handler.EndRender();
+                GLDispatch::EndFrame();
+                stats_hud.AddFrameTime(Util::GetElapsedMilliseconds(frame_start));
             }
+
+            latency_tracker.EndFrame();
+            input_log.EndFrame(camera.GetState(), *delta_time, Util::GetElapsedMilliseconds(frame_start));
+            if (input_log.IsFinished()) app_running = false;
         }
     }
 
+    ////////// INPUT RECORDING
+    // ends the recording, or reports how the replay compared to it
+    bool replay_matched = input_log.Finish(object.GetData());
+
+    ////////// LATENCY
+    if (latency_tracker.IsEnabled()) latency_tracker.WriteReport("latency.txt");
+
+    ////////// PROFILING
+    Profiler::WriteTrace("trace.json");
+    GLDispatch::StopRecording();
+
     ////////// MEMORY MANAGEMENT
     audio_handler.FreeAll();
     object.FreeAll();
     skybox.FreeAll();
+    block_cursor.cube.FreeAll();
+    stats_hud.FreeAll();
+    creator.FreeAll();
+    shader_handler.FreeAll();
 
     SDL_Quit();
     Mix_Quit();
     TTF_Quit();
 
-    return 0;
+    return replay_matched ? 0 : 1;
 }
\ No newline at end of file
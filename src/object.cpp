@@ -1,10 +1,15 @@
 #include "Object.h"
+
+static_assert(sizeof(TotalFrame::CubeRecord) == TotalFrame::CUBE_RECORD_UINTS * sizeof(Uint32), "cube.vert reads records as CUBE_RECORD_UINTS uints");
+
+std::atomic<Uint32> Object::total_template_generations{0};
+
 //=============================
 // DEFAULT CONSTRUCTOR
 //=============================
 
-Object::Object(TotalFrame::OBJECT_TYPE p_type, float p_aspect_ratio) : type(p_type), aspect_ratio(p_aspect_ratio) {
-    total_threads = std::thread::hardware_concurrency();
+Object::Object(TotalFrame::OBJECT_TYPE p_type, float p_aspect_ratio, JobSystem* p_job_system) : type(p_type), job_system(p_job_system), aspect_ratio(p_aspect_ratio) {
+    ;
 }
 
 //=============================
@@ -12,43 +17,130 @@ Object::Object(TotalFrame::OBJECT_TYPE p_type, float p_aspect_ratio) : type(p_ty
 //=============================
 
 void Object::UpdateAndRenderAll(glm::mat4 camera_view_projection_matrix, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights) {
-    // local helper function to process a chunk of cubes
-    auto ProcessCubesInRange = [](Object* object, size_t start_index, size_t end_index, const glm::mat4& view_proj_matrix, const glm::vec3& cam_position, const std::vector<std::shared_ptr<TotalFrame::Light>>& scene_lights) {
-        for (size_t index = start_index; index < end_index; ++index) {
-            Cube& cube = object->cubes[index];
-
-            if (cube.IsVisible(view_proj_matrix)) {
-                object->UpdateSP(cube, true);
-                object->UpdateCubeCameraScale(cube, cam_position, true);
-            }
-        }
-    };
+    Object::UpdateAll(camera_view_projection_matrix, camera_position);
+    Object::RenderAll(camera_position, lights);
+}
+
+void Object::UpdateAll(const glm::mat4& camera_view_projection_matrix, glm::vec3 camera_position) {
+    TF_PROFILE_SCOPE("Object::UpdateAll");
+    //// CULLING
+    // frustum planes are extracted once, the bounds tree is only rebuilt when cubes were added, removed or moved
+    if (bounds_dirty) Object::_RebuildBounds();
 
-    // futures for async
-    std::vector<std::future<void>> tasks = {};
+    culler.UpdateFrustum(camera_view_projection_matrix);
+    cube_visibility.assign(cubes.size(), 0);
+    culler.Cull(cube_visibility, job_system);
 
-    // assign tasks by chunk of cubes
-    for (unsigned int thread_index = 0; thread_index < total_threads; ++thread_index) {
-        size_t start = thread_index * cube_update_chunk_size;
-        size_t end = std::min(start + cube_update_chunk_size, cubes.size());
+    Object::_CullOccluded(camera_view_projection_matrix, camera_position);
+
+    //// PARALLEL UPDATE
+    // every worker only writes to its own slots, nothing shared is touched until the reduction
+    size_t total_blocks = (cubes.size() + UPDATE_BLOCK_SIZE - 1) / UPDATE_BLOCK_SIZE;
+    block_program_masks.assign(total_blocks, 0);
+
+    Object::_ParallelFor(total_blocks, 1, [&](size_t start_block, size_t end_block) {
+        for (size_t block = start_block; block < end_block; block++) {
+            size_t start_index = block * UPDATE_BLOCK_SIZE;
+            size_t end_index = std::min(start_index + UPDATE_BLOCK_SIZE, cubes.size());
+            Uint64 program_mask = 0;
+
+            for (size_t index = start_index; index < end_index; ++index) {
+                if (cube_visibility[index]) {
+                    program_mask |= Object::_GetShaderProgramBit(cube_templates[cubes[index].template_index].shader_program);
+                }
+            }
+
+            block_program_masks[block] = program_mask;
+        }
+    });
 
-        tasks.push_back(std::async(std::launch::async, ProcessCubesInRange, this, start, end, camera_view_projection_matrix, camera_position, lights));
+    //// REDUCTION
+    Uint64 program_mask = 0;
+    for (const auto& block_mask : block_program_masks) {
+        program_mask |= block_mask;
     }
 
-    // complete all tasks
-    for (auto& task : tasks) {
-        task.get();
+    for (size_t bit = 0; bit < shader_program_bits.size(); bit++) {
+        if (program_mask & (Uint64(1) << std::min(bit, size_t(63)))) shader_programs_need_update[shader_program_bits[bit]] = true;
     }
 
-    // render on main thread
-    for (auto& cube : cubes) {
-        if (cube.IsVisible(camera_view_projection_matrix)) {
-            Object::Render(cube, camera_position, lights, true);
+    //// VOXELS
+    // only the chunks edited since the last frame are remeshed
+    voxels.Remesh(job_system);
+    if (voxels.GetTotalCells() > 0) shader_programs_need_update[lattice_shader_program] = true;
+}
+
+void Object::RenderAll(glm::vec3 camera_position, const std::vector<std::shared_ptr<TotalFrame::Light>>& lights) {
+    TF_PROFILE_SCOPE("Object::RenderAll");
+    GLDispatch::Subsystem gl_subsystem("Object");
+    // render on main thread, using the visibility found in UpdateAll()
+    render_stats = {};
+    if (cube_visibility.size() != cubes.size()) return;
+
+    if (!lines_vertex_array) Object::_BuildLines();
+    if (!records_buffer) Object::_BuildRecords();
+
+    Object::_UploadRecords();
+    Object::_BuildVisibleStream();
+
+    // every cube is stretched the same way, see Cube::UpdateStretch()
+    glm::vec3 stretch = glm::vec3(1.0f, aspect_ratio, 1.0f);
+    glm::mat3 normal_matrix = glm::transpose(glm::inverse(glm::mat3(glm::scale(glm::mat4(1.0f), stretch))));
+
+    Object::_RenderVoxels(camera_position, lights, stretch, normal_matrix);
+    if (visible_stream.empty()) return;
+
+    // last frame's stream is orphaned rather than waited on
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, visible_buffer.Get());
+    GLDispatch::BufferData(GL_ARRAY_BUFFER, visible_stream.size() * sizeof(Uint32), visible_stream.data(), GL_STREAM_DRAW);
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLDispatch::ActiveTexture(GL_TEXTURE0 + RECORDS_TEXTURE_UNIT);
+    GLDispatch::BindTexture(GL_TEXTURE_BUFFER, records_texture.Get());
+    GLDispatch::ActiveTexture(GL_TEXTURE0);
+
+    GLuint current_program = 0;
+    const ProgramUniforms* uniforms = nullptr;
+
+    for (size_t template_index = 0; template_index < cube_templates.size(); template_index++) {
+        size_t first_instance = template_offsets[template_index];
+        size_t total_instances = template_offsets[template_index + 1] - first_instance;
+        if (total_instances == 0) continue;
+
+        CubeTemplate& cube_template = cube_templates[template_index];
+
+        // per program uniforms are only set when the program changes
+        if (cube_template.shader_program != current_program) {
+            current_program = cube_template.shader_program;
+            uniforms = &Object::_GetProgramUniforms(current_program);
+
+            GLDispatch::UseProgram(current_program);
+            GLDispatch::Uniform3fv(uniforms->light_position, 1, glm::value_ptr(lights[0]->position));
+            GLDispatch::Uniform1f(uniforms->light_intensity, lights[0]->intensity);
+            GLDispatch::Uniform3fv(uniforms->view_position, 1, glm::value_ptr(camera_position));
+            GLDispatch::UniformMatrix3fv(uniforms->normal_matrix, 1, GL_FALSE, glm::value_ptr(normal_matrix));
+            GLDispatch::Uniform1i(uniforms->instanced, GL_TRUE);
+            GLDispatch::Uniform1i(uniforms->cube_records, RECORDS_TEXTURE_UNIT);
+            GLDispatch::Uniform3fv(uniforms->stretch, 1, glm::value_ptr(stretch));
+        }
+
+        // triangles, the vertices are quantized so their scale is undone here. voxels already drew theirs
+        if (template_instanced_counts[template_index] > 0) {
+            GLDispatch::Uniform1f(uniforms->vertex_scale, cube_template.position_scale / TotalFrame::POSITION_QUANTIZATION);
+            cube_template.RenderInstanced(visible_buffer.Get(), first_instance, template_instanced_counts[template_index]);
+            render_stats.draw_calls++;
+            render_stats.triangles += cube_template.GetTotalTriangles() * template_instanced_counts[template_index];
         }
+
+        // outlines, voxels included
+        GLDispatch::Uniform1f(uniforms->vertex_scale, cube_template.size * 0.5f);
+        Object::_RenderLinesInstanced(first_instance, total_instances);
+        render_stats.draw_calls++;
     }
 }
 
-void Object::UpdateAndRender(Cube cube, glm::mat4 camera_view_projection_matrix, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights) {
+void Object::UpdateAndRender(Cube& cube, glm::mat4 camera_view_projection_matrix, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights) {
+    TF_PROFILE_SCOPE("Object::UpdateAndRender");
     if (cube.IsVisible(camera_view_projection_matrix)) {
         Object::UpdateSP(cube, true);
         Object::UpdateCubeCameraScale(cube, camera_position, true);
@@ -57,54 +149,169 @@ void Object::UpdateAndRender(Cube cube, glm::mat4 camera_view_projection_matrix,
 }
 
 std::string Object::GetData() {
+    TF_PROFILE_SCOPE("Object::GetData");
     std::string temp_data = "";
-    for (auto& cube : cubes) {
-        temp_data += cube.GetData();
+    for (const auto& cube : cubes) {
+        const CubeTemplate& cube_template = cube_templates[cube.template_index];
+        glm::vec3 color = Object::_UnpackColor(cube.color);
+
+        // get posiiton
+        for (int i = 0; i < 3; i++) {
+            temp_data += std::to_string(cube.position[i]);
+            temp_data += ' ';
+        }
+        temp_data.pop_back();
+        temp_data += '\n';
+
+        // get vertices data
+        for (size_t triangle = 0; triangle < cube_template.GetTotalTriangles(); triangle++) {
+            for (const auto& vertice : cube_template.GetTriangleVertices(triangle, color)) {
+                temp_data += std::to_string(vertice);
+                temp_data += ' ';
+            }
+            temp_data.pop_back();
+            temp_data += '\n';
+        }
     }
     return temp_data;
 }
 
+bool Object::SaveLatticeIndex(const std::string& object_path) const {
+    TF_PROFILE_SCOPE("Object::SaveLatticeIndex");
+    std::ofstream index_file(object_path + LATTICE_INDEX_EXTENSION, std::ios::binary | std::ios::trunc);
+    if (!index_file) {
+        TF_LOG_ERROR("FAILED TO OPEN LATTICE INDEX FILE", "Object::SaveLatticeIndex");
+        return false;
+    }
+
+    // header: magic, total cubes. little endian, then the serialized tree
+    Uint8 header[8];
+    Uint32 header_values[2] = {LATTICE_INDEX_MAGIC, Uint32(cubes.size())};
+    for (int value = 0; value < 2; value++) {
+        for (int byte = 0; byte < 4; byte++) {
+            header[value * 4 + byte] = Uint8(header_values[value] >> (byte * 8));
+        }
+    }
+
+    std::vector<Uint8> tree_data = lattice_tree.Serialize();
+    index_file.write(reinterpret_cast<const char*>(header), sizeof(header));
+    index_file.write(reinterpret_cast<const char*>(tree_data.data()), std::streamsize(tree_data.size()));
+    return bool(index_file);
+}
+
+bool Object::CheckLatticeIndex() {
+    std::vector<Uint8> tree_data = lattice_tree.Serialize();
+    VoxelOctree read_tree;
+    if (!read_tree.Deserialize(tree_data.data(), tree_data.size())) return false;
+
+    std::vector<VoxelOctree::Entry> entries = {};
+    std::vector<VoxelOctree::Entry> read_entries = {};
+    lattice_tree.ForEach([&entries](glm::ivec3 cell, Uint32& value) { entries.push_back({cell, value}); });
+    read_tree.ForEach([&read_entries](glm::ivec3 cell, Uint32& value) { read_entries.push_back({cell, value}); });
+
+    // both walk the same layout, so the cells come out in the same order
+    if (entries.size() != read_entries.size() || read_tree.GetTotalCells() != lattice_tree.GetTotalCells()) return false;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].cell != read_entries[i].cell || entries[i].value != read_entries[i].value) return false;
+    }
+    return true;
+}
+
 //=============================
 // EXPORTATION FUNCTIONS
 //=============================
 
 std::string Object::GetExportData() {
-    // for every cube
-    for (int i = 0; i < cubes.size(); i++) {
-        std::vector<std::array<TotalFrame::Ray, 14>> all_corners_rays = cubes[i].GetCornersRays();
-        std::vector<bool> cubes_collision = {};
-        std::vector<glm::vec3> not_visible_corners = {};
-        // for each set of corner rays from the starting cube, get a list of bools if each corner ray collides with a cube
-        for (auto& corner_rays : all_corners_rays) {
-            // for each individual corner ray from the starting cube
-            for (int j = 0; j < corner_rays.size(); j++) {
-                bool collides_with_cube = false;
-                // compare to each cube to see if it collides
-                for (int k = 0; k < cubes.size(); k++) {
-                    if (k == i) continue; // skip self
-                    if (cubes[k].RayCollidesWithCorners(corner_rays[j], corner_rays[j].origin)) {
-                        collides_with_cube = true;
-                        break;
+    TF_PROFILE_SCOPE("Object::GetExportData");
+    std::vector<glm::vec3> directions = {
+        // Axis-aligned directions (±1, 0, 0), (0, ±1, 0), (0, 0, ±1)
+        glm::vec3(1, 0, 0), glm::vec3(-1, 0, 0),
+        glm::vec3(0, 1, 0), glm::vec3(0, -1, 0),
+        glm::vec3(0, 0, 1), glm::vec3(0, 0, -1),
+
+        // Corner diagonals (±1, ±1, ±1)
+        glm::vec3(1, 1, 1), glm::vec3(-1, 1, 1), glm::vec3(1, -1, 1), glm::vec3(1, 1, -1),
+        glm::vec3(-1, -1, 1), glm::vec3(-1, 1, -1), glm::vec3(1, -1, -1), glm::vec3(-1, -1, -1)
+    };
+    for (auto& direction : directions) {
+        direction = glm::normalize(direction);
+    }
+
+    // for every cube, find the corners hidden by other cubes, then the triangles it keeps. only reads shared data, so cubes are independent
+    std::vector<CubeTemplate> trimmed_templates(cubes.size());
+    std::vector<glm::vec3> trimmed_colors(cubes.size(), glm::vec3(1.0f));
+    std::vector<Uint8> trimmed(cubes.size(), 0);
+
+    Object::_ParallelFor(cubes.size(), 16, [&](size_t start_index, size_t end_index) {
+        for (size_t i = start_index; i < end_index; i++) {
+            const CubeTemplate& cube_template = cube_templates[cubes[i].template_index];
+            glm::vec3 center = cubes[i].position;
+            float half_size = cube_template.size * 0.5f;
+
+            std::vector<glm::vec3> not_visible_corners = {};
+
+            // a corner is not visible if all 14 of its rays are blocked by another cube
+            for (int x = -1; x <= 1; x += 2) {
+                for (int y = -1; y <= 1; y += 2) {
+                    for (int z = -1; z <= 1; z += 2) {
+                        glm::vec3 corner = center + glm::vec3(x, y, z) * half_size;
+
+                        bool all_rays_blocked = true;
+                        for (const auto& direction : directions) {
+                            TotalFrame::Ray corner_ray;
+                            corner_ray.origin = corner;
+                            corner_ray.direction = direction;
+
+                            bool collides_with_cube = false;
+                            for (size_t k = 0; k < cubes.size(); k++) {
+                                if (k == i) continue; // skip self
+                                if (Object::_RayCollidesWithCorners(corner_ray, cubes[k].position, cube_templates[cubes[k].template_index].size, corner)) {
+                                    collides_with_cube = true;
+                                    break;
+                                }
+                            }
+
+                            if (!collides_with_cube) {
+                                all_rays_blocked = false;
+                                break;
+                            }
+                        }
+
+                        if (all_rays_blocked) not_visible_corners.push_back(corner);
                     }
                 }
-                // push back all cube collision states from the corner rays
-                cubes_collision.push_back(collides_with_cube);
             }
-        }
 
-        // each corner has 6 rays; mark the corner not visible if all 14 rays are blocked
-        for (int c = 0; c < all_corners_rays.size(); c++) {
-            int base_index = c * 14;
-            bool all_rays_blocked = std::all_of(cubes_collision.begin() + base_index, cubes_collision.begin() + base_index + 14,
-                                                [](bool blocked) { return blocked; });
+            if (not_visible_corners.empty()) continue;
 
-            if (all_rays_blocked) {
-                not_visible_corners.push_back(all_corners_rays[c][0].origin);
+            // keep the triangles that do not touch a hidden corner
+            TotalFrame::CubeData temp_data;
+            for (size_t triangle = 0; triangle < cube_template.GetTotalTriangles(); triangle++) {
+                bool touches_hidden_corner = false;
+                for (const auto& vertex : cube_template.GetTrianglePositions(triangle)) {
+                    for (const auto& corner : not_visible_corners) {
+                        // gives 0.001 error margin
+                        if (glm::all(glm::epsilonEqual(vertex + center, corner, 0.001f))) touches_hidden_corner = true;
+                    }
+                }
+                if (!touches_hidden_corner) temp_data.triangles_vertices.push_back(cube_template.GetTriangleVertices(triangle, glm::vec3(1.0f)));
             }
+
+            trimmed_templates[i].Load(temp_data.triangles_vertices, cube_template.size, cube_template.shader_program, trimmed_colors[i]);
+            trimmed[i] = 1;
         }
+    });
+
+    // swap in the trimmed templates on this thread, identical ones are still shared
+    for (size_t i = 0; i < cubes.size(); i++) {
+        if (!trimmed[i]) continue;
 
-        if (not_visible_corners.size() > 0) cubes[i].RemoveTrianglesByCorners(not_visible_corners);
+        cubes[i].template_index = Object::_AddTemplate(trimmed_templates[i]);
+        cubes[i].color = Object::_PackColor(Object::_UnpackColor(cubes[i].color) * trimmed_colors[i]);
     }
+    records_dirty = true;
+    // trimmed cubes are no longer boxes
+    Object::_RebuildLattice();
 
     return Object::GetData();
 }
@@ -114,12 +321,14 @@ std::string Object::GetExportData() {
 //=============================
 
 void Object::Create(std::string name, glm::vec3 position, float size, std::string obj_path, GLuint shader_program, std::string object_data_str) {
-    Cube temp_object(name, position, size, obj_path, shader_program, aspect_ratio, object_data_str);
-    cubes.push_back(temp_object);
-    shader_program_groups[cubes.back().shader_program].push_back(cubes.back());
-    shader_programs_need_update[cubes.back().shader_program] = true;
+    TF_PROFILE_SCOPE("Object::Create");
+    // if there is no data already read, read the file
+    if (object_data_str == "") object_data_str = Object::_ReadData(obj_path);
 
-    cube_update_chunk_size = (cubes.size() + total_threads - 1) / total_threads;
+    TotalFrame::CubeData data;
+    if (!Cube::Parse(object_data_str, data)) return;
+
+    Object::_AddCube(data, position, size, shader_program);
 }
 
 void Object::CreateLight(std::shared_ptr<TotalFrame::Light> p_light, std::string name, glm::vec3 position, float size, std::string obj_path, GLuint shader_program, std::string object_data_str) {
@@ -128,36 +337,361 @@ void Object::CreateLight(std::shared_ptr<TotalFrame::Light> p_light, std::string
 }
 
 void Object::ClearAndCreate(std::string name, glm::vec3 position, float size, std::string obj_path, GLuint shader_program) {
+    TF_PROFILE_SCOPE("Object::ClearAndCreate");
     cubes.clear();
+    for (auto& cube_template : cube_templates) {
+        cube_template.FreeAll();
+    }
+    cube_templates.clear();
+    template_generation = Object::_NewTemplateGeneration();
+    template_lookup.clear();
+    white_templates.clear();
+    box_templates.clear();
+    bounds_dirty = true;
+    records_dirty = true;
+
+    // every temporary of the load lives in this arena and is released in one shot when it goes out of scope
+    Arena load_arena;
+
+    size_t text_size = 0;
+    const char* text = Object::_ReadData(obj_path, load_arena, text_size);
+    if (text == nullptr) {
+        Object::_RebuildLattice();
+        return;
+    }
+
+    size_t total_cubes = 0;
+    CubeSlice* slices = Object::_SplitByCube(text, text_size, load_arena, total_cubes);
+
+    // parse and pack every cube on the workers into its own part of the arena, templates are then shared here on the main thread
+    TotalFrame::PackedVertex* parsed_vertices = load_arena.AllocateArray<TotalFrame::PackedVertex>(total_cubes == 0 ? 0 : slices[total_cubes - 1].first_vertex + slices[total_cubes - 1].max_triangles * 3);
+    TotalFrame::CubeRecord* parsed_cubes = load_arena.AllocateArray<TotalFrame::CubeRecord>(total_cubes);
+    Uint32* parsed_total_vertices = load_arena.AllocateArray<Uint32>(total_cubes);
+    float* parsed_sizes = load_arena.AllocateArray<float>(total_cubes);
+    float* parsed_position_scales = load_arena.AllocateArray<float>(total_cubes);
+    Uint64* parsed_hashes = load_arena.AllocateArray<Uint64>(total_cubes);
+    Uint8* parsed = load_arena.AllocateArray<Uint8>(total_cubes);
+
+    Object::_ParallelFor(total_cubes, 64, [&](size_t start_index, size_t end_index) {
+        // reused by every cube of the range
+        std::vector<GLfloat> triangles_values = {};
+
+        for (size_t i = start_index; i < end_index; i++) {
+            const CubeSlice& slice = slices[i];
+            TotalFrame::PackedVertex* vertices = parsed_vertices + slice.first_vertex;
+
+            glm::vec3 read_position = glm::vec3(0.0f);
+            size_t total_triangles = 0;
+            parsed[i] = Object::_ParseCube(text + slice.start, text + slice.end, read_position, triangles_values, total_triangles);
+            if (!parsed[i]) continue;
+
+            // same packing as CubeTemplate::Load()
+            float position_scale = 0.0f;
+            float low_extent = std::numeric_limits<float>::max();
+            float high_extent = -std::numeric_limits<float>::max();
+            for (size_t value = 0; value < total_triangles * 18; value += 6) {
+                position_scale = std::max({position_scale, std::fabs(triangles_values[value]), std::fabs(triangles_values[value + 1]), std::fabs(triangles_values[value + 2])});
+                low_extent = std::min(low_extent, triangles_values[value]);
+                high_extent = std::max(high_extent, triangles_values[value]);
+            }
+            if (position_scale <= 0.0f) position_scale = 1.0f;
+
+            for (size_t triangle = 0; triangle < total_triangles; triangle++) {
+                Triangle::PackVertices(&triangles_values[triangle * 18], position_scale, vertices + triangle * 3);
+            }
 
-    std::vector<std::string> cubes_data = Object::_SplitByCube(Object::_ReadData(obj_path));
+            glm::vec3 color = CubeTemplate::ExtractUniformColor(vertices, total_triangles * 3);
 
-    for (const auto& object_data : cubes_data) {
-        Object::Create(name, position, size, obj_path, shader_program, object_data);
+            parsed_total_vertices[i] = Uint32(total_triangles * 3);
+            parsed_position_scales[i] = position_scale;
+            if (size == TotalFrame::READ_SIZE_FROM_FILE) parsed_sizes[i] = total_triangles == 0 ? 0.0f : high_extent - low_extent;
+            else parsed_sizes[i] = size;
+            parsed_hashes[i] = CubeTemplate::Hash(vertices, parsed_total_vertices[i], parsed_sizes[i], position_scale, shader_program);
+
+            parsed_cubes[i].position = position == TotalFrame::READ_POS_FROM_FILE ? read_position : position;
+            parsed_cubes[i].color = Object::_PackColor(color);
+        }
+    });
+
+    cubes.reserve(total_cubes);
+    for (size_t i = 0; i < total_cubes; i++) {
+        if (!parsed[i]) continue;
+
+        // only the first cube of each distinct template copies its vertices out of the arena
+        const TotalFrame::PackedVertex* vertices = parsed_vertices + slices[i].first_vertex;
+        Uint32 template_index = Object::_FindTemplate(parsed_hashes[i], vertices, parsed_total_vertices[i], parsed_sizes[i], parsed_position_scales[i], shader_program);
+        if (template_index == UINT32_MAX) {
+            CubeTemplate cube_template;
+            cube_template.LoadPacked(vertices, parsed_total_vertices[i], parsed_sizes[i], parsed_position_scales[i], shader_program);
+            template_index = Object::_AddTemplate(cube_template);
+        }
+
+        parsed_cubes[i].template_index = template_index;
+        cubes.push_back(parsed_cubes[i]);
     }
+
+    Object::_RebuildLattice(Object::_LoadLatticeIndex(obj_path));
+    if (hollow_on_load) Object::Hollow();
 }
 
-void Object::Add(Cube cube) {
-    cubes.push_back(cube);
-    shader_program_groups[cube.shader_program].push_back(cube);
-    shader_programs_need_update[cube.shader_program] = true;
+void Object::Add(Cube& cube) {
+    TF_PROFILE_SCOPE("Object::Add");
+    TotalFrame::CubeData data;
+    if (!Cube::Parse(cube.GetData(), data)) return;
+
+    Object::_AddCube(data, TotalFrame::READ_POS_FROM_FILE, cube.size[0], cube.shader_program);
+}
+
+//=============================
+// CUBE ACCESS FUNCTIONS
+//=============================
+
+size_t Object::GetTotalCubes() const {
+    return cubes.size();
+}
+
+const TotalFrame::CubeRecord& Object::GetCube(size_t index) const {
+    return cubes[index];
+}
+
+glm::vec3 Object::GetCubePosition(size_t index) const {
+    if (index >= cubes.size()) return glm::vec3(0.0f);
+    return cubes[index].position;
+}
+
+glm::vec3 Object::GetCubeColor(size_t index) const {
+    if (index >= cubes.size()) return glm::vec3(-1000.0f);
+    return cube_templates[cubes[index].template_index].GetColor() * Object::_UnpackColor(cubes[index].color);
+}
+
+float Object::GetCubeSize(size_t index) const {
+    if (index >= cubes.size()) return 0.0f;
+    return cube_templates[cubes[index].template_index].size;
+}
+
+Uint8 Object::GetCubeNeighbors(size_t index) const {
+    glm::ivec3 cell = glm::ivec3(0);
+    if (index >= cubes.size() || !(cube_lattice_flags[index] & LATTICE_CUBE) || !Object::_GetLatticeCell(cubes[index], cell)) return 0;
+    return lattice_occupancy.GetNeighborMask(cell);
+}
+
+//=============================
+// CUBE COLORING FUNCTIONS
+//=============================
 
-    cube_update_chunk_size = (cubes.size() + total_threads - 1) / total_threads;
+void Object::SetCubeColor(size_t index, glm::vec3 color) {
+    Object::SetCubesColor({index}, color);
+}
+
+void Object::SetCubesColor(const std::vector<size_t>& indices, glm::vec3 color) {
+    TF_PROFILE_SCOPE("Object::SetCubesColor");
+    Uint32 packed_color = Object::_PackColor(color);
+
+    for (size_t index : indices) {
+        if (index >= cubes.size()) continue;
+
+        // a recolored cube is one color, like Cube::SetColor(), so it moves to the white version of its template
+        TotalFrame::CubeRecord& cube = cubes[index];
+        Uint32 template_index = Object::_GetWhiteTemplate(cube.template_index);
+        if (cube.color == packed_color && cube.template_index == template_index) continue;
+
+        cube.color = packed_color;
+        cube.template_index = template_index;
+        dirty_records.push_back(Uint32(index));
+
+        // a voxel only recolors its cell, a cube that just became a white box may become a voxel
+        Object::_SetLatticeCube(index);
+    }
 }
 
 //=============================
 // DESTRUCTION FUNCTIONS
 //=============================
 
-void Object::Destory(Cube* p_cube) {
-    for (int i = 0; i < cubes.size(); i++) {
-        if (&cubes[i] == p_cube) {
-            cubes[i].FreeAll();
-            cubes.erase(cubes.begin() + i);
-            break;
+void Object::Destory(size_t index) {
+    TF_PROFILE_SCOPE("Object::Destory");
+    if (index >= cubes.size()) return;
+
+    glm::ivec3 cell = glm::ivec3(0);
+    bool was_on_lattice = (cube_lattice_flags[index] & LATTICE_CUBE) && Object::_GetLatticeCell(cubes[index], cell);
+
+    // the template stays, other cubes may share it
+    cubes.erase(cubes.begin() + index);
+    cube_lattice_flags.erase(cube_lattice_flags.begin() + index);
+
+    // every index past the erased one moved down, Destory() is already linear so the tree is walked once
+    lattice_tree.ForEach([&](glm::ivec3 tree_cell, Uint32& value) {
+        if (value > index) value--;
+    });
+
+    if (was_on_lattice) {
+        lattice_tree.Remove(cell);
+        lattice_occupancy.Set(cell, false);
+        voxels.Clear(cell);
+
+        // duplicates in the same cell keep it filled
+        glm::ivec3 other_cell = glm::ivec3(0);
+        for (size_t i = 0; i < cubes.size(); i++) {
+            if ((cube_lattice_flags[i] & LATTICE_CUBE) && Object::_GetLatticeCell(cubes[i], other_cell) && other_cell == cell) Object::_SetLatticeCube(i);
         }
     }
-    cube_update_chunk_size = (cubes.size() + total_threads - 1) / total_threads;
+    loose_cubes_dirty = true;
+
+    bounds_dirty = true;
+    records_dirty = true;
+}
+
+//=============================
+// BULK EDITING FUNCTIONS
+//=============================
+
+size_t Object::FillBox(glm::vec3 corner_a, glm::vec3 corner_b, Cube& cube) {
+    return Object::_FillBox(corner_a, corner_b, cube, false);
+}
+
+size_t Object::HollowBox(glm::vec3 corner_a, glm::vec3 corner_b, Cube& cube) {
+    return Object::_FillBox(corner_a, corner_b, cube, true);
+}
+
+size_t Object::EraseBox(glm::vec3 corner_a, glm::vec3 corner_b) {
+    TF_PROFILE_SCOPE("Object::EraseBox");
+    glm::ivec3 min_cell = glm::ivec3(0);
+    glm::ivec3 max_cell = glm::ivec3(0);
+    if (!Object::_GetBulkBox(corner_a, corner_b, min_cell, max_cell)) return 0;
+
+    // every cube in a cell goes, duplicates included, so the cells end up empty
+    std::vector<Uint8> remove(cubes.size(), 0);
+    Object::_ParallelFor(cubes.size(), 1024, [&](size_t start_index, size_t end_index) {
+        glm::ivec3 cell = glm::ivec3(0);
+        for (size_t i = start_index; i < end_index; i++) {
+            if (!(cube_lattice_flags[i] & LATTICE_CUBE) || !Object::_GetLatticeCell(cubes[i], cell)) continue;
+            remove[i] = glm::all(glm::greaterThanEqual(cell, min_cell)) && glm::all(glm::lessThanEqual(cell, max_cell));
+        }
+    });
+
+    return Object::_RemoveCubes(remove);
+}
+
+Object::Clipboard Object::CopyRegion(glm::vec3 corner_a, glm::vec3 corner_b) const {
+    TF_PROFILE_SCOPE("Object::CopyRegion");
+    Clipboard clipboard;
+    clipboard.template_generation = template_generation;
+
+    glm::ivec3 min_cell = glm::ivec3(0);
+    glm::ivec3 max_cell = glm::ivec3(0);
+    if (!Object::_GetBulkBox(corner_a, corner_b, min_cell, max_cell)) return clipboard;
+
+    // the tree only walks the occupied branches of the box, one cube per cell
+    std::vector<VoxelOctree::Entry> entries = {};
+    lattice_tree.QueryRegion(min_cell, max_cell, entries);
+
+    clipboard.cells.reserve(entries.size());
+    clipboard.template_indices.reserve(entries.size());
+    clipboard.colors.reserve(entries.size());
+    for (const auto& entry : entries) {
+        const TotalFrame::CubeRecord& cube = cubes[entry.value];
+        clipboard.cells.push_back(entry.cell - min_cell);
+        clipboard.template_indices.push_back(cube.template_index);
+        clipboard.colors.push_back(cube.color);
+    }
+
+    return clipboard;
+}
+
+size_t Object::PasteRegion(const Clipboard& clipboard, glm::vec3 p_position) {
+    TF_PROFILE_SCOPE("Object::PasteRegion");
+    if (clipboard.cells.empty()) return 0;
+    if (clipboard.template_generation != template_generation) {
+        TF_LOG_ERROR("CLIPBOARD IS FROM ANOTHER OR A CLEARED OBJECT", "Object::PasteRegion");
+        return 0;
+    }
+    if (clipboard.template_indices.size() != clipboard.cells.size() || clipboard.colors.size() != clipboard.cells.size()) {
+        TF_LOG_ERROR("INVALID CLIPBOARD", "Object::PasteRegion");
+        return 0;
+    }
+    for (Uint32 template_index : clipboard.template_indices) {
+        if (template_index >= cube_templates.size()) {
+            TF_LOG_ERROR("CLIPBOARD TEMPLATE OUT OF RANGE", "Object::PasteRegion");
+            return 0;
+        }
+    }
+
+    glm::ivec3 base_cell = glm::ivec3(0);
+    if (!Object::_GetNearestLatticeCell(p_position, base_cell)) return 0;
+
+    std::vector<LatticeCube> new_cubes(clipboard.cells.size());
+    Object::_ParallelFor(new_cubes.size(), 4096, [&](size_t start_index, size_t end_index) {
+        for (size_t i = start_index; i < end_index; i++) {
+            new_cubes[i].cell = base_cell + clipboard.cells[i];
+            new_cubes[i].template_index = clipboard.template_indices[i];
+            new_cubes[i].color = clipboard.colors[i];
+        }
+    });
+
+    // cells pushed past the lattice's reach are dropped
+    new_cubes.erase(std::remove_if(new_cubes.begin(), new_cubes.end(), [](const LatticeCube& new_cube) {
+        return glm::any(glm::greaterThan(glm::abs(new_cube.cell), glm::ivec3(LATTICE_MAX_CELL)));
+    }), new_cubes.end());
+
+    return Object::_AddLatticeCubes(new_cubes);
+}
+
+size_t Object::FloodFill(size_t index, glm::vec3 color) {
+    TF_PROFILE_SCOPE("Object::FloodFill");
+    glm::ivec3 start_cell = glm::ivec3(0);
+    if (index >= cubes.size() || !(cube_lattice_flags[index] & LATTICE_CUBE) || !Object::_GetLatticeCell(cubes[index], start_cell)) return 0;
+
+    // colors are compared as drawn, the template's color times the record's
+    Uint32 fill_color = Object::_PackColor(Object::GetCubeColor(index));
+
+    // visited cells are kept bit-packed, the occupancy bits are checked before the tree is searched
+    OccupancyGrid visited;
+    std::vector<glm::ivec3> open_cells = {start_cell};
+    std::vector<size_t> filled = {};
+    visited.Set(start_cell, true);
+
+    const glm::ivec3 steps[6] = {glm::ivec3(0, 0, 1), glm::ivec3(0, 0, -1), glm::ivec3(1, 0, 0), glm::ivec3(-1, 0, 0), glm::ivec3(0, 1, 0), glm::ivec3(0, -1, 0)};
+
+    while (!open_cells.empty()) {
+        glm::ivec3 cell = open_cells.back();
+        open_cells.pop_back();
+
+        Uint32 cell_index = 0;
+        if (!lattice_tree.Find(cell, cell_index) || Object::_PackColor(Object::GetCubeColor(cell_index)) != fill_color) continue;
+        filled.push_back(cell_index);
+
+        for (const auto& step : steps) {
+            glm::ivec3 next_cell = cell + step;
+            if (!lattice_occupancy.IsOccupied(next_cell) || visited.IsOccupied(next_cell)) continue;
+            visited.Set(next_cell, true);
+            open_cells.push_back(next_cell);
+        }
+    }
+
+    // one batch of dirty records, merged into a few uploads
+    Object::SetCubesColor(filled, color);
+    return filled.size();
+}
+
+//=============================
+// HOLLOWING FUNCTIONS
+//=============================
+
+size_t Object::Hollow() {
+    TF_PROFILE_SCOPE("Object::Hollow");
+    OccupancyGrid enclosed = lattice_occupancy.GetEnclosed(job_system);
+    if (enclosed.GetTotalCells() == 0) return 0;
+
+    // duplicates go with their cell, cubes off the lattice are never removed
+    std::vector<Uint8> remove(cubes.size(), 0);
+    Object::_ParallelFor(cubes.size(), 1024, [&](size_t start_index, size_t end_index) {
+        glm::ivec3 cell = glm::ivec3(0);
+        for (size_t i = start_index; i < end_index; i++) {
+            remove[i] = (cube_lattice_flags[i] & LATTICE_CUBE) && Object::_GetLatticeCell(cubes[i], cell) && enclosed.IsOccupied(cell);
+        }
+    });
+
+    return Object::_RemoveCubes(remove);
 }
 
 //=============================
@@ -165,13 +699,19 @@ void Object::Destory(Cube* p_cube) {
 //=============================
 
 void Object::Translate(glm::vec3 translation) {
+    TF_PROFILE_SCOPE("Object::Translate");
     position += translation;
     for (auto& cube : cubes) {
-        cube.Translate(translation);
+        cube.position += translation;
     }
+    // lattice cubes move with their lattice, their cells and meshes stay the same
+    lattice_origin += translation;
+    bounds_dirty = true;
+    records_dirty = true;
 }
 
 void Object::Rotate(glm::vec3 rotation, glm::vec3 camera_position) {
+    TF_PROFILE_SCOPE("Object::Rotate");
     for (auto& cube : cubes) {
         //cube.Rotate(rotation, camera_position);
     }
@@ -181,7 +721,7 @@ void Object::Rotate(glm::vec3 rotation, glm::vec3 camera_position) {
 // SHADER PROGRAM FUNCTIONS
 //=============================
 
-void Object::UpdateSP(Cube cube, bool is_visible) {
+void Object::UpdateSP(const Cube& cube, bool is_visible) {
     // update map
     if (is_visible) shader_programs_need_update[cube.shader_program] = true;
 }
@@ -201,7 +741,7 @@ std::vector<GLuint> Object::GetShaderProgramsUpdates() {
 // CAMEAR SCALING FUNCTIONS
 //=============================
 
-void Object::UpdateCubeCameraScale(Cube cube, glm::vec3 camera_position, bool is_visible) {
+void Object::UpdateCubeCameraScale(Cube& cube, glm::vec3 camera_position, bool is_visible) {
     cube.UpdatePosition(camera_position);
 }
 
@@ -209,120 +749,1063 @@ void Object::UpdateCubeCameraScale(Cube cube, glm::vec3 camera_position, bool is
 // RAY FUNCTIONS
 //=============================
 
-Cube Object::GetRayCollidingCube(TotalFrame::Ray ray) {
-    // set closest_cube to the farthest possible
-    float closest_distance = std::numeric_limits<float>::max();
+size_t Object::GetRayCollidingCube(TotalFrame::Ray ray) {
+    glm::vec3 face_hit_normal = glm::vec3(-1000.0f);
+    return Object::_GetClosestRayHit(ray, false, face_hit_normal);
+}
 
-    Cube closest_cube;
+size_t Object::GetRayCollidingCubeWithFace(TotalFrame::Ray ray, glm::vec3& face_hit_normal_out) {
+    return Object::_GetClosestRayHit(ray, true, face_hit_normal_out);
+}
 
-    for (auto& cube : cubes) {
+std::vector<size_t> Object::GetRayCollidingCubes(TotalFrame::Ray ray) {
+    std::vector<size_t> intersecting_cubes = {};
+    for (size_t i = 0; i < cubes.size(); i++) {
         float distance;
-        // if the cube collides with the ray
-        if (cube.RayCollides(ray, distance)) {
-            // if the cube is closer than the others
-            if (distance < closest_distance) {
-                closest_distance = distance;
-                closest_cube = cube;
+        glm::vec3 face_hit_normal;
+        if (Object::_RayCollides(cubes[i], ray, false, distance, face_hit_normal)) {
+            intersecting_cubes.push_back(i);
+        }
+    }
+    return intersecting_cubes;
+}
+
+double Object::GetLastPickTime() const {
+    return last_pick_time;
+}
+
+//=============================
+// LIGHTING FUNCTIONS
+//=============================
+
+void Object::AttachLight(std::shared_ptr<TotalFrame::Light> p_light) {
+    light = p_light;
+    light->position = position;
+}
+
+//=============================
+// RENDERING FUNCTIONS
+//=============================
+
+void Object::Render(Cube& cube, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights, bool is_visible) {
+    TF_PROFILE_SCOPE("Object::Render");
+    // if visible, render
+    if (is_visible){
+        cube.Render(camera_position, lights);
+    }
+}
+
+TotalFrame::RenderStats Object::GetRenderStats() const {
+    return render_stats;
+}
+
+//=============================
+// CULLING
+//=============================
+
+Object::CullStats Object::GetCullStats() const {
+    return cull_stats;
+}
+
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
+
+void Object::_RebuildBounds() {
+    TF_PROFILE_SCOPE("Object::_RebuildBounds");
+    cube_centers.resize(cubes.size());
+    cube_extents.resize(cubes.size());
+
+    Object::_ParallelFor(cubes.size(), 1024, [&](size_t start_index, size_t end_index) {
+        for (size_t i = start_index; i < end_index; i++) {
+            Object::_GetCubeBounds(cubes[i], cube_centers[i], cube_extents[i]);
+        }
+    });
+
+    culler.Build(cube_centers, cube_extents);
+    Object::_RebuildOccluders();
+    bounds_dirty = false;
+}
+
+void Object::_RebuildOccluders() {
+    TF_PROFILE_SCOPE("Object::_RebuildOccluders");
+    merged_occluder_centers.clear();
+    merged_occluder_extents.clear();
+
+    struct Box {
+        glm::ivec3 low_cell;
+        glm::ivec3 high_cell;
+        glm::vec3 low;
+        glm::vec3 high;
+    };
+
+    //// ROWS
+    // solid lattice cubes fill their cell exactly, touching ones along x become one box
+    std::vector<Box> cells = {};
+    glm::ivec3 cell = glm::ivec3(0);
+    for (size_t i = 0; i < cubes.size() && i < cube_lattice_flags.size(); i++) {
+        if (!(cube_lattice_flags[i] & LATTICE_CUBE) || !Object::_IsSolidTemplate(cubes[i].template_index) || !Object::_GetLatticeCell(cubes[i], cell)) continue;
+        cells.push_back({cell, cell, cube_centers[i] - cube_extents[i], cube_centers[i] + cube_extents[i]});
+    }
+
+    std::sort(cells.begin(), cells.end(), [](const Box& a, const Box& b) {
+        if (a.low_cell.z != b.low_cell.z) return a.low_cell.z < b.low_cell.z;
+        if (a.low_cell.y != b.low_cell.y) return a.low_cell.y < b.low_cell.y;
+        return a.low_cell.x < b.low_cell.x;
+    });
+
+    std::vector<Box> rows = {};
+    for (const auto& cell_box : cells) {
+        // cells holding more than one cube repeat
+        if (!rows.empty()) {
+            Box& row = rows.back();
+            if (row.high_cell.y == cell_box.low_cell.y && row.high_cell.z == cell_box.low_cell.z && cell_box.low_cell.x - row.high_cell.x <= 1) {
+                row.high_cell.x = cell_box.low_cell.x;
+                row.low = glm::min(row.low, cell_box.low);
+                row.high = glm::max(row.high, cell_box.high);
+                continue;
             }
         }
+        rows.push_back(cell_box);
     }
 
-    return closest_cube;
+    //// SLABS
+    // rows covering the same cells along x stack along y
+    std::sort(rows.begin(), rows.end(), [](const Box& a, const Box& b) {
+        if (a.low_cell.z != b.low_cell.z) return a.low_cell.z < b.low_cell.z;
+        if (a.low_cell.x != b.low_cell.x) return a.low_cell.x < b.low_cell.x;
+        if (a.high_cell.x != b.high_cell.x) return a.high_cell.x < b.high_cell.x;
+        return a.low_cell.y < b.low_cell.y;
+    });
+
+    Box slab = {};
+    for (size_t i = 0; i < rows.size(); i++) {
+        const Box& row = rows[i];
+        bool stacks = i > 0 && slab.low_cell.z == row.low_cell.z && slab.low_cell.x == row.low_cell.x && slab.high_cell.x == row.high_cell.x && row.low_cell.y == slab.high_cell.y + 1;
+
+        if (stacks) {
+            slab.high_cell.y = row.high_cell.y;
+            slab.low = glm::min(slab.low, row.low);
+            slab.high = glm::max(slab.high, row.high);
+        } else {
+            if (i > 0) {
+                merged_occluder_centers.push_back((slab.low + slab.high) * 0.5f);
+                merged_occluder_extents.push_back((slab.high - slab.low) * 0.5f);
+            }
+            slab = row;
+        }
+    }
+    if (!rows.empty()) {
+        merged_occluder_centers.push_back((slab.low + slab.high) * 0.5f);
+        merged_occluder_extents.push_back((slab.high - slab.low) * 0.5f);
+    }
 }
 
-Cube Object::GetRayCollidingCubeWithFace(TotalFrame::Ray ray, glm::vec3& face_hit_normal_out) {
-    // set closest_cube to the farthest possible
-    float closest_distance = std::numeric_limits<float>::max();
+void Object::_CullOccluded(const glm::mat4& camera_view_projection_matrix, glm::vec3 camera_position) {
+    TF_PROFILE_SCOPE("Object::_CullOccluded");
+    visible_indices.clear();
+    for (size_t i = 0; i < cube_visibility.size(); i++) {
+        if (cube_visibility[i]) visible_indices.push_back(i);
+    }
+
+    cull_stats.total_cubes = cubes.size();
+    cull_stats.frustum_visible_cubes = visible_indices.size();
+    cull_stats.occlusion_visible_cubes = visible_indices.size();
+
+    if (!occlusion_culling_enabled || visible_indices.size() < OCCLUSION_MIN_CUBES) return;
+
+    //// OCCLUDER SELECTION
+    // merged boxes in the frustum, and the visible cubes that aren't part of one
+    std::vector<glm::vec3> candidate_centers = {};
+    std::vector<glm::vec3> candidate_extents = {};
+    const Culler::Frustum& frustum = culler.GetFrustum();
+    for (size_t i = 0; i < merged_occluder_centers.size(); i++) {
+        if (!frustum.IsBoxVisible(merged_occluder_centers[i], merged_occluder_extents[i])) continue;
+        candidate_centers.push_back(merged_occluder_centers[i]);
+        candidate_extents.push_back(merged_occluder_extents[i]);
+    }
+    for (size_t index : visible_indices) {
+        if (index < cube_lattice_flags.size() && (cube_lattice_flags[index] & LATTICE_CUBE) && Object::_IsSolidTemplate(cubes[index].template_index)) continue;
+        candidate_centers.push_back(cube_centers[index]);
+        candidate_extents.push_back(cube_extents[index]);
+    }
+
+    // the boxes covering the most screen are roughly the largest and nearest ones
+    auto OccluderScore = [&](size_t candidate) {
+        float distance = std::max(glm::length(candidate_centers[candidate] - camera_position), 0.001f);
+        return glm::max(glm::max(candidate_extents[candidate].x, candidate_extents[candidate].y), candidate_extents[candidate].z) / distance;
+    };
+
+    std::vector<size_t> occluder_indices(candidate_centers.size());
+    for (size_t i = 0; i < occluder_indices.size(); i++) {
+        occluder_indices[i] = i;
+    }
+    if (occluder_indices.size() > OCCLUDER_BUDGET) {
+        std::nth_element(occluder_indices.begin(), occluder_indices.begin() + OCCLUDER_BUDGET, occluder_indices.end(), [&](size_t a, size_t b) {
+            return OccluderScore(a) > OccluderScore(b);
+        });
+        occluder_indices.resize(OCCLUDER_BUDGET);
+    }
+
+    std::vector<glm::vec3> occluder_centers(occluder_indices.size());
+    std::vector<glm::vec3> occluder_extents(occluder_indices.size());
+    for (size_t i = 0; i < occluder_indices.size(); i++) {
+        occluder_centers[i] = candidate_centers[occluder_indices[i]];
+        occluder_extents[i] = candidate_extents[occluder_indices[i]];
+    }
+
+    //// RASTERIZATION
+    occlusion_culler.Clear();
+    occlusion_culler.SetViewProjection(camera_view_projection_matrix);
+    occlusion_culler.RasterizeOccluders(occluder_centers, occluder_extents, job_system);
+
+    //// TESTING
+    // each cube only clears its own visibility byte
+    Object::_ParallelFor(visible_indices.size(), 256, [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) {
+            size_t index = visible_indices[i];
+            if (occlusion_culler.IsBoxOccluded(cube_centers[index], cube_extents[index])) cube_visibility[index] = 0;
+        }
+    });
 
-    Cube closest_cube;
+    cull_stats.occlusion_visible_cubes = 0;
+    for (size_t index : visible_indices) {
+        cull_stats.occlusion_visible_cubes += cube_visibility[index];
+    }
+}
 
+size_t Object::_GetClosestRayHit(TotalFrame::Ray ray, bool with_face, glm::vec3& face_hit_normal_out) {
+    TF_PROFILE_SCOPE("Object::_GetClosestRayHit");
+    Uint64 start_time = SDL_GetPerformanceCounter();
+
+    // set closest to the farthest possible
+    float closest_distance = std::numeric_limits<float>::max();
+    size_t closest_index = SIZE_MAX;
     glm::vec3 closest_face_hit_normal = glm::vec3(-1000.0f);
+    std::mutex closest_mutex;
+
+    //// LATTICE CUBES
+    if (lattice_tree.GetTotalCells() > 0) {
+        // into cell space, where cell c covers [c, c + 1). the mapping is linear so t is the same as along the world ray
+        glm::vec3 stretch = glm::vec3(1.0f, aspect_ratio, 1.0f);
+        glm::vec3 cell_origin = (ray.origin / stretch - lattice_origin) / lattice_cell_size + 0.5f;
+        glm::vec3 cell_direction = ray.direction / stretch / lattice_cell_size;
+
+        VoxelOctree::RayHit hit;
+        if (lattice_tree.RayCast(cell_origin, cell_direction, hit)) {
+            closest_distance = hit.t;
+            closest_index = hit.value;
+
+            // entering through the low side of the axis means the ray travels up it, same normal as _RayCollides()
+            if (with_face) {
+                closest_face_hit_normal = glm::vec3(0.0f);
+                closest_face_hit_normal[hit.axis] = cell_direction[hit.axis] > 0.0f ? -0.5f : 0.5f;
+            }
+        }
+    }
+
+    //// LOOSE CUBES
+    if (loose_cubes_dirty) {
+        loose_cubes.clear();
+        for (size_t i = 0; i < cubes.size(); i++) {
+            if (!(cube_lattice_flags[i] & LATTICE_CUBE)) loose_cubes.push_back(Uint32(i));
+        }
+        loose_cubes_dirty = false;
+    }
+
+    // each range finds its own closest cube, then merges it into the overall closest
+    Object::_ParallelFor(loose_cubes.size(), 512, [&](size_t start_loose, size_t end_loose) {
+        float range_distance = std::numeric_limits<float>::max();
+        size_t range_index = SIZE_MAX;
+        glm::vec3 range_face_hit_normal = glm::vec3(-1000.0f);
+
+        for (size_t loose = start_loose; loose < end_loose; loose++) {
+            size_t i = loose_cubes[loose];
+            float distance;
+            glm::vec3 face_hit_normal = glm::vec3(-1000.0f);
+
+            // if the cube collides with the ray
+            bool collides = Object::_RayCollides(cubes[i], ray, with_face, distance, face_hit_normal);
 
-    for (auto& cube : cubes) {
-        float distance;
-        glm::vec3 face_hit_normal;
-        // if the cube collides with the ray
-        if (cube.RayCollidesWithFace(ray, distance, face_hit_normal)) {
             // if the cube is closer than the others
-            if (distance < closest_distance) {
-                closest_distance = distance;
-                closest_cube = cube;
-                closest_face_hit_normal = face_hit_normal;
+            if (collides && distance < range_distance) {
+                range_distance = distance;
+                range_index = i;
+                range_face_hit_normal = face_hit_normal;
             }
         }
-    }
-    
+
+        if (range_index == SIZE_MAX) return;
+
+        std::lock_guard<std::mutex> lock(closest_mutex);
+        // ties go to the earlier cube, same as a serial scan
+        if (range_distance < closest_distance || (range_distance == closest_distance && range_index < closest_index)) {
+            closest_distance = range_distance;
+            closest_index = range_index;
+            closest_face_hit_normal = range_face_hit_normal;
+        }
+    });
+
     face_hit_normal_out = closest_face_hit_normal;
 
-    return closest_cube;
+    last_pick_time = Util::GetElapsedMilliseconds(start_time);
+    return closest_index;
 }
 
-Cube* Object::GetRayCollidingCubeWithFacePtr(TotalFrame::Ray ray, glm::vec3& face_hit_normal_out) {
-    // set closest_cube to the farthest possible
-    float closest_distance = std::numeric_limits<float>::max();
+bool Object::_RayCollides(const TotalFrame::CubeRecord& cube, TotalFrame::Ray ray, bool with_face, float& tmin_out, glm::vec3& face_hit_normal_out) const {
+    float tmin = -std::numeric_limits<float>::infinity();
+    float tmax = std::numeric_limits<float>::max();
 
-    Cube* closest_cube = nullptr;
+    // same box as Cube::RayCollides(), the cube's axes are half length and stretched by the aspect ratio
+    glm::vec3 stretch = glm::vec3(1.0f, aspect_ratio, 1.0f);
+    glm::vec3 half_size = cube_templates[cube.template_index].size * 0.5f * stretch;
+    glm::vec3 axis_scale = 0.5f * stretch;
 
-    glm::vec3 closest_face_hit_normal = glm::vec3(-1000.0f);
+    // ray direction from ray origin to cube position (center)
+    glm::vec3 ray_to_pos = cube.position * stretch - ray.origin;
 
-    for (auto& cube : cubes) {  // Iterate by reference
-        float distance;
-        glm::vec3 face_hit_normal;
-        
-        // If the cube collides with the ray
-        if (cube.RayCollidesWithFace(ray, distance, face_hit_normal)) {
-            // If the cube is closer than the others
-            if (distance < closest_distance) {
-                closest_distance = distance;
-                closest_cube = &cube;  // Correctly get the address of the object
-                closest_face_hit_normal = face_hit_normal;
+    face_hit_normal_out = glm::vec3(-1000.0f);
+
+    // for each axes
+    for (int i = 0; i < 3; i++) {
+        float axis_projection = ray.direction[i];
+        float distance = ray_to_pos[i];
+
+        // if the ray is not parallel to this axis
+        if (std::fabs(axis_projection * axis_scale[i]) > 1e-6) {
+            // calculate where the ray enters and exits the along this axis
+            float t1 = (distance - half_size[i]) / axis_projection;
+            float t2 = (distance + half_size[i]) / axis_projection;
+
+            bool entering_negative = t1 < t2;
+            if (!entering_negative) std::swap(t1, t2);
+
+            if (t1 > tmin) {
+                tmin = t1;
+                // if entering negative, -axes[i], otherwise axes[i]
+                glm::vec3 axis = glm::vec3(0.0f);
+                axis[i] = 0.5f;
+                if (with_face) face_hit_normal_out = entering_negative ? -axis : axis;
             }
+            tmax = glm::min(tmax, t2);
+
+            // if tmin > tmax, there is no overlap between the ray and cube
+            if (tmin > tmax) return false;
+
+        // if the distance is too far from the half_size, there is no overlap
+        } else if (-distance > half_size[i] || distance > half_size[i]) {
+            return false;
         }
     }
-    
-    face_hit_normal_out = closest_face_hit_normal;
 
-    return closest_cube;
+    // tmin output for determining the first cube hit
+    tmin_out = tmin;
+
+    return true;
 }
 
-std::vector<std::shared_ptr<Cube>> Object::GetRayCollidingCubes(TotalFrame::Ray ray) {
-    std::vector<std::shared_ptr<Cube>> intersecting_cubes = {};
-    for (auto& cube : cubes) {
-        if (cube.RayCollides(ray)) {
-            intersecting_cubes.push_back(std::make_shared<Cube>(cube));
+bool Object::_RayCollidesWithCorners(TotalFrame::Ray ray, glm::vec3 center, float size, glm::vec3 ignore_point) {
+    float half_size = size * 0.5f;
+
+    for (int x = -1; x <= 1; x += 2) {
+        for (int y = -1; y <= 1; y += 2) {
+            for (int z = -1; z <= 1; z += 2) {
+                glm::vec3 corner = center + glm::vec3(x, y, z) * half_size;
+
+                if (glm::all(glm::epsilonEqual(corner, ignore_point, 0.001f))) continue;
+
+                glm::vec3 to_corner = corner - ray.origin;
+                float t = glm::dot(to_corner, ray.direction); // projection of corner onto ray direction
+
+                if (t < 0.0f) continue; // corner is behind ray origin
+
+                glm::vec3 closest_point = ray.origin + t * ray.direction;
+                if (glm::distance(closest_point, corner) < 0.01f) return true;
+            }
         }
     }
-    return intersecting_cubes;
+
+    return false;
 }
 
-//=============================
-// LIGHTING FUNCTIONS
-//=============================
+Uint32 Object::_AddTemplate(CubeTemplate& cube_template) {
+    Uint64 hash = cube_template.GetHash();
 
-void Object::AttachLight(std::shared_ptr<TotalFrame::Light> p_light) {
-    light = p_light;
-    light->position = position;
+    auto [start, end] = template_lookup.equal_range(hash);
+    for (auto found = start; found != end; ++found) {
+        if (cube_templates[found->second].Matches(cube_template)) return found->second;
+    }
+
+    Uint32 template_index = Uint32(cube_templates.size());
+    cube_templates.push_back(std::move(cube_template));
+    template_lookup.emplace(hash, template_index);
+
+    shader_programs_need_update[cube_templates.back().shader_program] = true;
+    Object::_RegisterShaderProgram(cube_templates.back().shader_program);
+
+    return template_index;
 }
 
-//=============================
-// RENDERING FUNCTIONS
-//=============================
+Uint32 Object::_FindTemplate(Uint64 hash, const TotalFrame::PackedVertex* vertices, size_t total_vertices, float size, float position_scale, GLuint shader_program) const {
+    auto [start, end] = template_lookup.equal_range(hash);
+    for (auto found = start; found != end; ++found) {
+        if (cube_templates[found->second].Matches(vertices, total_vertices, size, position_scale, shader_program)) return found->second;
+    }
+    return UINT32_MAX;
+}
 
-void Object::Render(Cube cube, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights, bool is_visible) {
-    // if visible, render
-    if (is_visible){
-        cube.Render(camera_position, lights);
+void Object::_AddCube(const TotalFrame::CubeData& data, glm::vec3 p_position, float size, GLuint shader_program) {
+    TotalFrame::CubeRecord cube;
+    // if position is being read from file, use the read position, otherwise the defined position
+    cube.position = p_position == TotalFrame::READ_POS_FROM_FILE ? data.position : p_position;
+    cube.template_index = Object::_AddCubeTemplate(data, size, shader_program, cube.color);
+
+    cubes.push_back(cube);
+    cube_lattice_flags.push_back(0);
+    Object::_SetLatticeCube(cubes.size() - 1);
+
+    bounds_dirty = true;
+    records_dirty = true;
+}
+
+Uint32 Object::_AddCubeTemplate(const TotalFrame::CubeData& data, float size, GLuint shader_program, Uint32& color_out) {
+    CubeTemplate cube_template;
+    glm::vec3 color = glm::vec3(1.0f);
+    cube_template.Load(data.triangles_vertices, size, shader_program, color);
+
+    color_out = Object::_PackColor(color);
+    return Object::_AddTemplate(cube_template);
+}
+
+void Object::_GetCubeBounds(const TotalFrame::CubeRecord& cube, glm::vec3& center_out, glm::vec3& extent_out) const {
+    // same box as Cube::GetBounds()
+    glm::vec3 stretch = glm::vec3(1.0f, aspect_ratio, 1.0f);
+    center_out = cube.position * stretch;
+    extent_out = cube_templates[cube.template_index].size * 0.5f * stretch;
+}
+
+Uint32 Object::_PackColor(glm::vec3 color) {
+    return Uint32(Triangle::QuantizeColor(color.r)) | (Uint32(Triangle::QuantizeColor(color.g)) << 8) | (Uint32(Triangle::QuantizeColor(color.b)) << 16) | (Uint32(255) << 24);
+}
+
+glm::vec3 Object::_UnpackColor(Uint32 color) {
+    return glm::vec3(color & 0xFF, (color >> 8) & 0xFF, (color >> 16) & 0xFF) / 255.0f;
+}
+
+const Object::ProgramUniforms& Object::_GetProgramUniforms(GLuint shader_program) {
+    auto found = program_uniforms.find(shader_program);
+    if (found != program_uniforms.end()) return found->second;
+
+    // look the locations up once per program instead of once per cube
+    ProgramUniforms uniforms;
+    uniforms.model_matrix = GLDispatch::GetUniformLocation(shader_program, "model_matrix");
+    uniforms.cube_color = GLDispatch::GetUniformLocation(shader_program, "cube_color");
+    uniforms.normal_matrix = GLDispatch::GetUniformLocation(shader_program, "normal_matrix");
+    uniforms.instanced = GLDispatch::GetUniformLocation(shader_program, "instanced");
+    uniforms.cube_records = GLDispatch::GetUniformLocation(shader_program, "cube_records");
+    uniforms.vertex_scale = GLDispatch::GetUniformLocation(shader_program, "vertex_scale");
+    uniforms.stretch = GLDispatch::GetUniformLocation(shader_program, "stretch");
+    uniforms.light_position = GLDispatch::GetUniformLocation(shader_program, "light_position");
+    uniforms.light_intensity = GLDispatch::GetUniformLocation(shader_program, "light_intensity");
+    uniforms.view_position = GLDispatch::GetUniformLocation(shader_program, "view_position");
+
+    return program_uniforms.emplace(shader_program, uniforms).first->second;
+}
+
+void Object::_BuildLines() {
+    // the 12 edges of a cube with corners at +-1, in the same order as Cube::UpdatePosition()
+    glm::vec3 corners[8] = {
+        glm::vec3(-1, -1, -1), glm::vec3( 1, -1, -1), glm::vec3( 1,  1, -1), glm::vec3(-1,  1, -1),
+        glm::vec3(-1, -1,  1), glm::vec3( 1, -1,  1), glm::vec3( 1,  1,  1), glm::vec3(-1,  1,  1)
+    };
+    int edges[TOTAL_LINE_VERTICES] = {0, 1, 1, 2, 2, 3, 3, 0, 4, 5, 5, 6, 6, 7, 7, 4, 0, 4, 1, 5, 2, 6, 3, 7};
+
+    std::vector<glm::vec3> lines_vertices = {};
+    for (int corner : edges) {
+        lines_vertices.push_back(corners[corner]);
     }
+
+    lines_vertex_array.Create();
+    lines_vertex_buffer.Create();
+
+    GLDispatch::BindVertexArray(lines_vertex_array.Get());
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, lines_vertex_buffer.Get());
+    GLDispatch::BufferData(GL_ARRAY_BUFFER, sizeof(glm::vec3) * lines_vertices.size(), lines_vertices.data(), GL_STATIC_DRAW);
+
+    GLDispatch::VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(GLfloat), (GLvoid*)0);
+    GLDispatch::EnableVertexAttribArray(0);
+    GLDispatch::BindVertexArray(0);
 }
 
-//=============================
-// PRIVATE FUNCTIONS
-//=============================
+void Object::_RenderLinesInstanced(size_t first_instance, size_t total_instances) {
+    GLDispatch::BindVertexArray(lines_vertex_array.Get());
+
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, visible_buffer.Get());
+    GLDispatch::VertexAttribIPointer(2, 1, GL_UNSIGNED_INT, sizeof(Uint32), (GLvoid*)(first_instance * sizeof(Uint32)));
+    GLDispatch::EnableVertexAttribArray(2);
+    GLDispatch::VertexAttribDivisor(2, 1);
+
+    GLDispatch::DrawArraysInstanced(GL_LINES, 0, TOTAL_LINE_VERTICES, total_instances);
+
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLDispatch::BindVertexArray(0);
+}
+
+void Object::_BuildRecords() {
+    TF_PROFILE_SCOPE("Object::_BuildRecords");
+    records_buffer.Create();
+    records_texture.Create();
+    visible_buffer.Create();
+
+    // one uint per texel, cube.vert reads CUBE_RECORD_UINTS of them per cube
+    GLDispatch::BindBuffer(GL_TEXTURE_BUFFER, records_buffer.Get());
+    GLDispatch::BufferData(GL_TEXTURE_BUFFER, sizeof(TotalFrame::CubeRecord), nullptr, GL_DYNAMIC_DRAW);
+    records_capacity = 1;
+
+    GLDispatch::BindTexture(GL_TEXTURE_BUFFER, records_texture.Get());
+    GLDispatch::TexBuffer(GL_TEXTURE_BUFFER, GL_R32UI, records_buffer.Get());
+
+    GLDispatch::BindTexture(GL_TEXTURE_BUFFER, 0);
+    GLDispatch::BindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    records_dirty = true;
+}
+
+void Object::_UploadRecords() {
+    TF_PROFILE_SCOPE("Object::_UploadRecords");
+    if (!records_dirty && dirty_records.empty()) return;
+
+    GLDispatch::BindBuffer(GL_TEXTURE_BUFFER, records_buffer.Get());
+
+    if (records_dirty) {
+        // storage only grows, and by doubling, so steady editing does not reallocate
+        if (cubes.size() > records_capacity) {
+            records_capacity = std::max(cubes.size(), records_capacity * 2);
+            GLDispatch::BufferData(GL_TEXTURE_BUFFER, records_capacity * sizeof(TotalFrame::CubeRecord), nullptr, GL_DYNAMIC_DRAW);
+        }
+        if (!cubes.empty()) GLDispatch::BufferSubData(GL_TEXTURE_BUFFER, 0, cubes.size() * sizeof(TotalFrame::CubeRecord), cubes.data());
+    } else {
+        // only the changed records, nearby ones merged into one range
+        std::sort(dirty_records.begin(), dirty_records.end());
+        dirty_records.erase(std::unique(dirty_records.begin(), dirty_records.end()), dirty_records.end());
+
+        size_t range_start = 0;
+        for (size_t i = 1; i <= dirty_records.size(); i++) {
+            if (i < dirty_records.size() && dirty_records[i] - dirty_records[i - 1] <= RECORD_MERGE_GAP) continue;
+
+            size_t first_record = dirty_records[range_start];
+            size_t end_record = std::min(size_t(dirty_records[i - 1]) + 1, cubes.size());
+            if (first_record < end_record) {
+                GLDispatch::BufferSubData(GL_TEXTURE_BUFFER, first_record * sizeof(TotalFrame::CubeRecord), (end_record - first_record) * sizeof(TotalFrame::CubeRecord), &cubes[first_record]);
+            }
+            range_start = i;
+        }
+    }
+
+    GLDispatch::BindBuffer(GL_TEXTURE_BUFFER, 0);
+
+    records_dirty = false;
+    dirty_records.clear();
+}
+
+void Object::_BuildVisibleStream() {
+    TF_PROFILE_SCOPE("Object::_BuildVisibleStream");
+    // counting sort by template, every template then draws its visible cubes with one call
+    template_offsets.assign(cube_templates.size() + 1, 0);
+    for (size_t index = 0; index < cubes.size(); index++) {
+        if (cube_visibility[index]) template_offsets[cubes[index].template_index + 1]++;
+    }
+    for (size_t template_index = 0; template_index < cube_templates.size(); template_index++) {
+        template_offsets[template_index + 1] += template_offsets[template_index];
+    }
+
+    visible_stream.resize(template_offsets.back());
+    // instanced cubes fill each template's part from the front, voxels (outlines only) from the back
+    std::vector<Uint32> template_cursors(template_offsets.begin(), template_offsets.end() - 1);
+    std::vector<Uint32> template_back_cursors(template_offsets.begin() + 1, template_offsets.end());
+    for (size_t index = 0; index < cubes.size(); index++) {
+        if (!cube_visibility[index]) continue;
+
+        Uint32 template_index = cubes[index].template_index;
+        if (cube_lattice_flags[index] & VOXEL_CUBE) visible_stream[--template_back_cursors[template_index]] = Uint32(index);
+        else visible_stream[template_cursors[template_index]++] = Uint32(index);
+    }
+
+    template_instanced_counts.resize(cube_templates.size());
+    for (size_t template_index = 0; template_index < cube_templates.size(); template_index++) {
+        template_instanced_counts[template_index] = template_cursors[template_index] - template_offsets[template_index];
+    }
+}
+
+Uint32 Object::_GetWhiteTemplate(Uint32 template_index) {
+    if (white_templates.size() < cube_templates.size()) white_templates.resize(cube_templates.size(), UINT32_MAX);
+    if (white_templates[template_index] != UINT32_MAX) return white_templates[template_index];
+
+    // same triangles with every vertex white. a template that already is one color gets itself back from the lookup
+    std::vector<std::vector<GLfloat>> triangles_vertices = cube_templates[template_index].GetTrianglesVertices();
+    for (auto& triangle_vertices : triangles_vertices) {
+        for (size_t i = 3; i < triangle_vertices.size(); i += 6) {
+            triangle_vertices[i + 0] = 1.0f;
+            triangle_vertices[i + 1] = 1.0f;
+            triangle_vertices[i + 2] = 1.0f;
+        }
+    }
+
+    CubeTemplate white_template;
+    glm::vec3 color = glm::vec3(1.0f);
+    white_template.Load(triangles_vertices, cube_templates[template_index].size, cube_templates[template_index].shader_program, color);
+
+    Uint32 white_index = Object::_AddTemplate(white_template);
+    white_templates.resize(cube_templates.size(), UINT32_MAX);
+    white_templates[template_index] = white_index;
+    white_templates[white_index] = white_index;
+
+    return white_index;
+}
+
+Uint32 Object::_NewTemplateGeneration() {
+    // starts at 1, default clipboards are 0
+    return total_template_generations.fetch_add(1, std::memory_order_relaxed) + 1;
+}
+
+bool Object::_IsBoxTemplate(Uint32 template_index) {
+    Object::_CheckBoxTemplate(template_index);
+    return box_templates[template_index] == 1;
+}
+
+bool Object::_IsSolidTemplate(Uint32 template_index) {
+    Object::_CheckBoxTemplate(template_index);
+    return box_templates[template_index] == 1 || box_templates[template_index] == 2;
+}
+
+void Object::_CheckBoxTemplate(Uint32 template_index) {
+    if (box_templates.size() < cube_templates.size()) box_templates.resize(cube_templates.size(), 0);
+    if (box_templates[template_index] != 0) return;
+
+    if (cube_templates[template_index].IsWhiteBox()) box_templates[template_index] = 1;
+    else box_templates[template_index] = cube_templates[template_index].IsBox() ? 2 : 3;
+}
+
+void Object::_SetLattice(glm::vec3 origin, float cell_size, GLuint shader_program) {
+    if (cell_size <= 0.0f) return;
+
+    lattice_set = true;
+    lattice_origin = origin;
+    lattice_cell_size = cell_size;
+    lattice_shader_program = shader_program;
+}
+
+bool Object::_GetLatticeCell(const TotalFrame::CubeRecord& cube, glm::ivec3& cell_out) const {
+    if (!lattice_set || cube_templates[cube.template_index].size != lattice_cell_size) return false;
+
+    // the cube has to sit on a cell center, give or take float error
+    glm::vec3 cell = (cube.position - lattice_origin) / lattice_cell_size;
+    glm::vec3 rounded_cell = glm::round(cell);
+    if (glm::any(glm::greaterThan(glm::abs(cell - rounded_cell), glm::vec3(0.001f)))) return false;
+    if (glm::any(glm::greaterThan(glm::abs(rounded_cell), glm::vec3(float(LATTICE_MAX_CELL))))) return false;
+
+    cell_out = glm::ivec3(rounded_cell);
+    return true;
+}
+
+void Object::_SetLatticeCube(size_t index) {
+    const TotalFrame::CubeRecord& cube = cubes[index];
+
+    // the first cube sets the lattice
+    if (!lattice_set) Object::_SetLattice(cube.position, cube_templates[cube.template_index].size, cube_templates[cube.template_index].shader_program);
+
+    glm::ivec3 cell = glm::ivec3(0);
+    if (!Object::_GetLatticeCell(cube, cell)) return;
+
+    // ties in picking go to the lowest index, same as testing every cube in order
+    Uint32 held_index = 0;
+    if (!lattice_tree.Find(cell, held_index) || held_index > index) lattice_tree.Insert(cell, Uint32(index));
+    lattice_occupancy.Set(cell, true);
+
+    Uint8 flags = LATTICE_CUBE;
+    if (Object::_IsBoxTemplate(cube.template_index) && cube_templates[cube.template_index].shader_program == lattice_shader_program) {
+        voxels.Set(cell, cube.color);
+        flags |= VOXEL_CUBE;
+    }
+
+    if (cube_lattice_flags[index] != flags) loose_cubes_dirty = true;
+    cube_lattice_flags[index] = flags;
+}
+
+void Object::_RebuildLattice(bool keep_tree) {
+    TF_PROFILE_SCOPE("Object::_RebuildLattice");
+    voxels.ClearAll();
+    if (!keep_tree) lattice_tree.Clear();
+    lattice_occupancy.Clear();
+    lattice_set = false;
+    cube_lattice_flags.assign(cubes.size(), 0);
+    loose_cubes_dirty = true;
+
+    // with a kept tree, cells it already holds are only looked up
+    for (size_t index = 0; index < cubes.size(); index++) {
+        Object::_SetLatticeCube(index);
+    }
+
+    if (keep_tree && !Object::_LatticeTreeMatches()) {
+        TF_LOG_WARNING("LATTICE INDEX DOES NOT MATCH THE CUBES, REBUILDING IT", "Object::_RebuildLattice");
+        Object::_RebuildLattice();
+    }
+}
+
+bool Object::_LoadLatticeIndex(const std::string& object_path) {
+    TF_PROFILE_SCOPE("Object::_LoadLatticeIndex");
+    std::string index_path = object_path + LATTICE_INDEX_EXTENSION;
+    // objects saved before there were index files, or by other tools
+    if (!std::filesystem::is_regular_file(index_path)) return false;
+
+    std::ifstream index_file(index_path, std::ios::binary);
+    std::vector<Uint8> data((std::istreambuf_iterator<char>(index_file)), std::istreambuf_iterator<char>());
+
+    Uint32 header_values[2] = {0, 0};
+    if (data.size() < 8) return false;
+    for (int value = 0; value < 2; value++) {
+        for (int byte = 0; byte < 4; byte++) {
+            header_values[value] |= Uint32(data[value * 4 + byte]) << (byte * 8);
+        }
+    }
+    // saved for another version of the object, nothing to log
+    if (header_values[0] != LATTICE_INDEX_MAGIC || header_values[1] != Uint32(cubes.size())) return false;
+
+    return lattice_tree.Deserialize(data.data() + 8, data.size() - 8);
+}
+
+bool Object::_LatticeTreeMatches() {
+    if (lattice_tree.GetTotalCells() != lattice_occupancy.GetTotalCells()) return false;
+
+    bool matches = true;
+    lattice_tree.ForEach([&](glm::ivec3 cell, Uint32& value) {
+        glm::ivec3 cube_cell = glm::ivec3(0);
+        if (value >= cubes.size() || !(cube_lattice_flags[value] & LATTICE_CUBE) || !Object::_GetLatticeCell(cubes[value], cube_cell) || cube_cell != cell) matches = false;
+    });
+    return matches;
+}
+
+bool Object::_GetNearestLatticeCell(glm::vec3 p_position, glm::ivec3& cell_out) const {
+    if (!lattice_set) return false;
+
+    glm::vec3 rounded_cell = glm::round((p_position - lattice_origin) / lattice_cell_size);
+    if (glm::any(glm::greaterThan(glm::abs(rounded_cell), glm::vec3(float(LATTICE_MAX_CELL))))) return false;
+
+    cell_out = glm::ivec3(rounded_cell);
+    return true;
+}
+
+bool Object::_PrepareBulkTemplate(glm::vec3 corner, const CubeTemplate& cube_template) {
+    // an empty object takes its lattice from the first corner, like the first cube created
+    if (!lattice_set) Object::_SetLattice(corner, cube_template.size, cube_template.shader_program);
+
+    if (!lattice_set || cube_template.size != lattice_cell_size) {
+        TF_LOG_ERROR("CUBE SIZE DOES NOT MATCH THE LATTICE", "Object::_PrepareBulkTemplate");
+        return false;
+    }
+    return true;
+}
+
+bool Object::_GetBulkBox(glm::vec3 corner_a, glm::vec3 corner_b, glm::ivec3& min_cell_out, glm::ivec3& max_cell_out) const {
+    glm::ivec3 cell_a = glm::ivec3(0);
+    glm::ivec3 cell_b = glm::ivec3(0);
+    if (!Object::_GetNearestLatticeCell(corner_a, cell_a) || !Object::_GetNearestLatticeCell(corner_b, cell_b)) return false;
+
+    min_cell_out = glm::min(cell_a, cell_b);
+    max_cell_out = glm::max(cell_a, cell_b);
+
+    glm::u64vec3 extent = glm::u64vec3(max_cell_out - min_cell_out) + glm::u64vec3(1);
+    if (extent.x * extent.y * extent.z > BULK_MAX_CELLS) {
+        TF_LOG_ERROR("BULK EDIT IS TOO LARGE", "Object::_GetBulkBox");
+        return false;
+    }
+    return true;
+}
+
+size_t Object::_FillBox(glm::vec3 corner_a, glm::vec3 corner_b, Cube& cube, bool hollow) {
+    TF_PROFILE_SCOPE("Object::_FillBox");
+    // the cube is parsed and its template built once for the whole box
+    TotalFrame::CubeData data;
+    if (!Cube::Parse(cube.GetData(), data)) return 0;
+
+    // only added with the cubes, so a rejected or already filled box leaves no template behind
+    CubeTemplate cube_template;
+    glm::vec3 template_color = glm::vec3(1.0f);
+    cube_template.Load(data.triangles_vertices, cube.size[0], cube.shader_program, template_color);
+    Uint32 color = Object::_PackColor(template_color);
+
+    bool had_lattice = lattice_set;
+    if (!Object::_PrepareBulkTemplate(corner_a, cube_template)) return 0;
+
+    glm::ivec3 min_cell = glm::ivec3(0);
+    glm::ivec3 max_cell = glm::ivec3(0);
+    if (!Object::_GetBulkBox(corner_a, corner_b, min_cell, max_cell)) {
+        // an empty object keeps no lattice from a box that was never filled
+        lattice_set = had_lattice;
+        return 0;
+    }
+
+    // cells are written chunk by chunk so _AddLatticeCubes() gets whole chunks at a time. each chunk's cells are counted first, then every chunk is written in parallel
+    glm::ivec3 min_chunk = OccupancyGrid::GetChunkCoordinate(min_cell);
+    glm::ivec3 chunk_extent = OccupancyGrid::GetChunkCoordinate(max_cell) - min_chunk + glm::ivec3(1);
+    size_t total_chunks = size_t(chunk_extent.x) * size_t(chunk_extent.y) * size_t(chunk_extent.z);
+
+    auto get_chunk_box = [&](size_t chunk, glm::ivec3& chunk_min_out, glm::ivec3& chunk_max_out) {
+        glm::ivec3 chunk_coordinate = min_chunk + glm::ivec3(int(chunk % size_t(chunk_extent.x)), int((chunk / size_t(chunk_extent.x)) % size_t(chunk_extent.y)), int(chunk / (size_t(chunk_extent.x) * size_t(chunk_extent.y))));
+        chunk_min_out = glm::max(min_cell, chunk_coordinate * OccupancyGrid::CHUNK_SIZE);
+        chunk_max_out = glm::min(max_cell, chunk_coordinate * OccupancyGrid::CHUNK_SIZE + glm::ivec3(OccupancyGrid::CHUNK_SIZE - 1));
+    };
+    // a hollow box skips the cells strictly inside it
+    auto is_inside = [&](glm::ivec3 cell) {
+        return hollow && glm::all(glm::greaterThan(cell, min_cell)) && glm::all(glm::lessThan(cell, max_cell));
+    };
+
+    std::vector<size_t> chunk_offsets(total_chunks + 1, 0);
+    Object::_ParallelFor(total_chunks, 16, [&](size_t start_index, size_t end_index) {
+        for (size_t chunk = start_index; chunk < end_index; chunk++) {
+            glm::ivec3 chunk_min = glm::ivec3(0);
+            glm::ivec3 chunk_max = glm::ivec3(0);
+            get_chunk_box(chunk, chunk_min, chunk_max);
+
+            glm::ivec3 chunk_size = chunk_max - chunk_min + glm::ivec3(1);
+            size_t total_cells = size_t(chunk_size.x) * size_t(chunk_size.y) * size_t(chunk_size.z);
+            if (hollow) {
+                glm::ivec3 inside_size = glm::max(glm::min(chunk_max, max_cell - glm::ivec3(1)) - glm::max(chunk_min, min_cell + glm::ivec3(1)) + glm::ivec3(1), glm::ivec3(0));
+                total_cells -= size_t(inside_size.x) * size_t(inside_size.y) * size_t(inside_size.z);
+            }
+            chunk_offsets[chunk + 1] = total_cells;
+        }
+    });
+    for (size_t chunk = 0; chunk < total_chunks; chunk++) {
+        chunk_offsets[chunk + 1] += chunk_offsets[chunk];
+    }
+
+    std::vector<LatticeCube> new_cubes(chunk_offsets[total_chunks]);
+    Object::_ParallelFor(total_chunks, 1, [&](size_t start_index, size_t end_index) {
+        for (size_t chunk = start_index; chunk < end_index; chunk++) {
+            glm::ivec3 chunk_min = glm::ivec3(0);
+            glm::ivec3 chunk_max = glm::ivec3(0);
+            get_chunk_box(chunk, chunk_min, chunk_max);
+
+            size_t next = chunk_offsets[chunk];
+            glm::ivec3 cell = glm::ivec3(0);
+            for (cell.z = chunk_min.z; cell.z <= chunk_max.z; cell.z++) {
+                for (cell.y = chunk_min.y; cell.y <= chunk_max.y; cell.y++) {
+                    for (cell.x = chunk_min.x; cell.x <= chunk_max.x; cell.x++) {
+                        if (is_inside(cell)) continue;
+                        new_cubes[next].cell = cell;
+                        new_cubes[next].color = color;
+                        next++;
+                    }
+                }
+            }
+        }
+    });
+
+    return Object::_AddLatticeCubes(new_cubes, &cube_template);
+}
+
+size_t Object::_AddLatticeCubes(const std::vector<LatticeCube>& new_cubes, CubeTemplate* new_template) {
+    TF_PROFILE_SCOPE("Object::_AddLatticeCubes");
+    // consecutive cubes in one chunk make a run, each run looks its chunks up once instead of once per cube
+    std::vector<Uint8> run_starts(new_cubes.size(), 0);
+    Object::_ParallelFor(new_cubes.size(), 4096, [&](size_t start_index, size_t end_index) {
+        for (size_t i = start_index; i < end_index; i++) {
+            run_starts[i] = i == 0 || OccupancyGrid::GetChunkCoordinate(new_cubes[i].cell) != OccupancyGrid::GetChunkCoordinate(new_cubes[i - 1].cell);
+        }
+    });
+    std::vector<Uint32> runs = {};
+    for (size_t i = 0; i < new_cubes.size(); i++) {
+        if (run_starts[i]) runs.push_back(Uint32(i));
+    }
+    runs.push_back(Uint32(new_cubes.size()));
+
+    // filled cells are skipped, the check only reads the occupancy bits so it runs on the workers
+    std::vector<Uint8> keep(new_cubes.size(), 0);
+    Object::_ParallelFor(runs.size() - 1, 4, [&](size_t start_index, size_t end_index) {
+        for (size_t run = start_index; run < end_index; run++) {
+            glm::ivec3 chunk_coordinate = OccupancyGrid::GetChunkCoordinate(new_cubes[runs[run]].cell);
+            const OccupancyGrid::Chunk* chunk = lattice_occupancy.FindChunk(chunk_coordinate);
+            for (size_t i = runs[run]; i < runs[run + 1]; i++) {
+                keep[i] = chunk == nullptr || !chunk->Get(OccupancyGrid::GetLocalCell(new_cubes[i].cell, chunk_coordinate));
+            }
+        }
+    });
+
+    // new index of every kept cube, minus first_index
+    std::vector<Uint32> new_indices(new_cubes.size(), UINT32_MAX);
+    size_t total_added = 0;
+    for (size_t i = 0; i < new_cubes.size(); i++) {
+        if (keep[i]) new_indices[i] = Uint32(total_added++);
+    }
+    if (total_added == 0) return 0;
+
+    Uint32 new_template_index = new_template == nullptr ? UINT32_MAX : Object::_AddTemplate(*new_template);
+
+    // records and tree entries are written straight into their slots
+    size_t first_index = cubes.size();
+    cubes.resize(first_index + total_added);
+    cube_lattice_flags.resize(first_index + total_added, 0);
+    std::vector<VoxelOctree::Entry> tree_entries(total_added);
+    Object::_ParallelFor(new_cubes.size(), 4096, [&](size_t start_index, size_t end_index) {
+        for (size_t i = start_index; i < end_index; i++) {
+            if (!keep[i]) continue;
+
+            const LatticeCube& new_cube = new_cubes[i];
+            TotalFrame::CubeRecord& cube = cubes[first_index + new_indices[i]];
+            cube.position = lattice_origin + glm::vec3(new_cube.cell) * lattice_cell_size;
+            cube.color = new_cube.color;
+            cube.template_index = new_template_index == UINT32_MAX ? new_cube.template_index : new_template_index;
+
+            // the cells were empty, so each new cube is the only one in its cell
+            tree_entries[new_indices[i]].cell = new_cube.cell;
+            tree_entries[new_indices[i]].value = Uint32(first_index + new_indices[i]);
+        }
+    });
+    lattice_tree.InsertMany(tree_entries.data(), tree_entries.size());
+
+    // template -> whether its cubes are drawn from voxels, checked once per template
+    std::vector<Uint8> voxel_templates(cube_templates.size(), 2);
+
+    // the occupancy grid and voxels are not thread safe, they are filled here a run at a time
+    OccupancyGrid::Chunk run_cells;
+    OccupancyGrid::Chunk run_voxels;
+    std::array<Uint32, VoxelChunks::CHUNK_CELLS> run_colors = {};
+
+    for (size_t run = 0; run + 1 < runs.size(); run++) {
+        glm::ivec3 chunk_coordinate = OccupancyGrid::GetChunkCoordinate(new_cubes[runs[run]].cell);
+        run_cells = {};
+        run_voxels = {};
+
+        for (size_t i = runs[run]; i < runs[run + 1]; i++) {
+            if (!keep[i]) continue;
+
+            const LatticeCube& new_cube = new_cubes[i];
+            size_t index = first_index + new_indices[i];
+            glm::ivec3 local_cell = OccupancyGrid::GetLocalCell(new_cube.cell, chunk_coordinate);
+
+            run_cells.Set(local_cell, true);
+            cube_lattice_flags[index] = LATTICE_CUBE;
+
+            Uint8& is_voxel = voxel_templates[new_cube.template_index];
+            if (is_voxel == 2) is_voxel = Object::_IsBoxTemplate(new_cube.template_index) && cube_templates[new_cube.template_index].shader_program == lattice_shader_program;
+            if (is_voxel) {
+                run_voxels.Set(local_cell, true);
+                run_colors[(local_cell.z * OccupancyGrid::CHUNK_SIZE + local_cell.y) * OccupancyGrid::CHUNK_SIZE + local_cell.x] = new_cube.color;
+                cube_lattice_flags[index] |= VOXEL_CUBE;
+            }
+        }
+
+        lattice_occupancy.SetChunk(chunk_coordinate, run_cells);
+        voxels.SetChunk(chunk_coordinate, run_voxels, run_colors);
+    }
+
+    bounds_dirty = true;
+    records_dirty = true;
+    return total_added;
+}
+
+size_t Object::_RemoveCubes(const std::vector<Uint8>& remove) {
+    TF_PROFILE_SCOPE("Object::_RemoveCubes");
+    // new index of every kept cube, UINT32_MAX for the removed ones
+    std::vector<Uint32> new_indices(cubes.size(), UINT32_MAX);
+    OccupancyGrid removed_cells;
+    size_t total_kept = 0;
+
+    for (size_t i = 0; i < cubes.size(); i++) {
+        if (!remove[i]) {
+            new_indices[i] = Uint32(total_kept++);
+            continue;
+        }
+
+        glm::ivec3 cell = glm::ivec3(0);
+        if ((cube_lattice_flags[i] & LATTICE_CUBE) && Object::_GetLatticeCell(cubes[i], cell) && !removed_cells.IsOccupied(cell)) {
+            removed_cells.Set(cell, true);
+            lattice_tree.Remove(cell);
+            lattice_occupancy.Set(cell, false);
+            voxels.Clear(cell);
+        }
+    }
+
+    size_t total_removed = cubes.size() - total_kept;
+    if (total_removed == 0) return 0;
+
+    // one stable compaction pass for the whole batch
+    for (size_t i = 0; i < cubes.size(); i++) {
+        if (new_indices[i] == UINT32_MAX) continue;
+        cubes[new_indices[i]] = cubes[i];
+        cube_lattice_flags[new_indices[i]] = cube_lattice_flags[i];
+    }
+    cubes.resize(total_kept);
+    cube_lattice_flags.resize(total_kept);
+
+    lattice_tree.ForEach([&](glm::ivec3 tree_cell, Uint32& value) {
+        value = new_indices[value];
+    });
+
+    // kept duplicates of a removed cube fill its cell back in
+    std::vector<Uint8> refill(cubes.size(), 0);
+    Object::_ParallelFor(cubes.size(), 1024, [&](size_t start_index, size_t end_index) {
+        glm::ivec3 cell = glm::ivec3(0);
+        for (size_t i = start_index; i < end_index; i++) {
+            refill[i] = (cube_lattice_flags[i] & LATTICE_CUBE) && Object::_GetLatticeCell(cubes[i], cell) && removed_cells.IsOccupied(cell);
+        }
+    });
+    for (size_t i = 0; i < cubes.size(); i++) {
+        if (refill[i]) Object::_SetLatticeCube(i);
+    }
+    loose_cubes_dirty = true;
+
+    bounds_dirty = true;
+    records_dirty = true;
+    return total_removed;
+}
+
+void Object::_RenderVoxels(glm::vec3 camera_position, const std::vector<std::shared_ptr<TotalFrame::Light>>& lights, glm::vec3 stretch, const glm::mat3& normal_matrix) {
+    TF_PROFILE_SCOPE("Object::_RenderVoxels");
+    if (voxels.GetTotalCells() == 0) return;
+
+    const ProgramUniforms& uniforms = Object::_GetProgramUniforms(lattice_shader_program);
+
+    // chunk meshes carry their colors, they go through the model matrix path like a standalone Cube
+    GLDispatch::UseProgram(lattice_shader_program);
+    GLDispatch::Uniform3fv(uniforms.light_position, 1, glm::value_ptr(lights[0]->position));
+    GLDispatch::Uniform1f(uniforms.light_intensity, lights[0]->intensity);
+    GLDispatch::Uniform3fv(uniforms.view_position, 1, glm::value_ptr(camera_position));
+    GLDispatch::UniformMatrix3fv(uniforms.normal_matrix, 1, GL_FALSE, glm::value_ptr(normal_matrix));
+    GLDispatch::Uniform1i(uniforms.instanced, GL_FALSE);
+    GLDispatch::Uniform4f(uniforms.cube_color, 1.0f, 1.0f, 1.0f, 1.0f);
+
+    voxels.Render(culler.GetFrustum(), lattice_origin, lattice_cell_size, stretch, uniforms.model_matrix, render_stats);
+}
+
+void Object::_RegisterShaderProgram(GLuint shader_program) {
+    if (std::find(shader_program_bits.begin(), shader_program_bits.end(), shader_program) == shader_program_bits.end()) {
+        shader_program_bits.push_back(shader_program);
+    }
+}
+
+Uint64 Object::_GetShaderProgramBit(GLuint shader_program) const {
+    // only a handful of programs exist, a linear search beats hashing. programs past the 64th share the last bit
+    for (size_t bit = 0; bit < shader_program_bits.size(); bit++) {
+        if (shader_program_bits[bit] == shader_program) return Uint64(1) << std::min(bit, size_t(63));
+    }
+    return 0;
+}
+
+void Object::_ParallelFor(size_t count, size_t min_grain_size, const JobSystem::RangeFunction& function) {
+    if (job_system == nullptr) {
+        function(0, count);
+        return;
+    }
+
+    job_system->ParallelFor(count, job_system->DefaultGrainSize(count, min_grain_size), function);
+}
 
 std::string Object::_ReadData(std::string path) {
     // return and throw error if path doesn't exist
     if (!std::filesystem::exists(path)) {
-        Util::ThrowError("INVALID OBJECT PATH", "Object::_ReadData");
+        TF_LOG_ERROR("INVALID OBJECT PATH", "Object::_ReadData");
         return {};
     }
 
@@ -333,34 +1816,124 @@ std::string Object::_ReadData(std::string path) {
     return object_data;
 }
 
-std::vector<std::string> Object::_SplitByCube(std::string object_data) {
-    std::vector<std::string> cubes_data = {};
-    std::string temp_object_data = "";
-    std::istringstream stream(object_data);
-    std::string line = "";
-    bool first_line = true;
+const char* Object::_ReadData(std::string path, Arena& arena, size_t& size_out) {
+    size_out = 0;
+
+    // return and throw error if path doesn't exist
+    if (!std::filesystem::exists(path)) {
+        TF_LOG_ERROR("INVALID OBJECT PATH", "Object::_ReadData");
+        return nullptr;
+    }
 
-    while (std::getline(stream, line)) {
+    //// read the whole file into the arena, null terminated
+    size_t file_size = size_t(std::filesystem::file_size(path));
+    char* object_data = arena.AllocateArray<char>(file_size + 1);
+
+    std::ifstream obj_file(path, std::ios::binary);
+    obj_file.read(object_data, file_size);
+    size_out = size_t(obj_file.gcount());
+    object_data[size_out] = '\0';
+
+    return object_data;
+}
+
+Object::CubeSlice* Object::_SplitByCube(const char* object_data, size_t object_data_size, Arena& arena, size_t& total_cubes_out) {
+    const char* end = object_data + object_data_size;
+
+    // if there are only 2 spaces, then that is a position vertice, and the next object can be started
+    auto IsPositionLine = [](const char* line, const char* line_end) {
         int spaces = 0;
-        for (const auto& letter : line) {
-            if (letter == ' ') spaces++;
+        for (const char* letter = line; letter < line_end; letter++) {
+            if (*letter == ' ') spaces++;
         }
+        return spaces == 2;
+    };
+    auto LineEnd = [&](const char* line) {
+        const char* line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        return line_end == nullptr ? end : line_end;
+    };
 
-        // if there are only 2 spaces, then that is a position vertice, and the next object can be started 
-        if (spaces == 2 && !first_line) {
-            cubes_data.push_back(temp_object_data);
-            temp_object_data.clear();
+    //// COUNTING
+    total_cubes_out = 1;
+    for (const char* line = object_data; line < end; line = LineEnd(line) + 1) {
+        if (line != object_data && IsPositionLine(line, LineEnd(line))) total_cubes_out++;
+    }
+
+    //// SPLITTING
+    CubeSlice* slices = arena.AllocateArray<CubeSlice>(total_cubes_out);
+    size_t cube = 0;
+    for (const char* line = object_data; line < end; line = LineEnd(line) + 1) {
+        const char* line_end = LineEnd(line);
+
+        if (line != object_data && IsPositionLine(line, line_end)) {
+            slices[cube].end = line - object_data;
+            cube++;
+            slices[cube].start = line - object_data;
         }
 
-        temp_object_data += line + '\n';
+        // every non empty line past the first may be a triangle
+        if (line_end > line && line != object_data + slices[cube].start) slices[cube].max_triangles++;
+    }
+    slices[cube].end = object_data_size;
 
-        first_line = false;
+    // vertices of each cube are packed one after another
+    for (size_t i = 1; i < total_cubes_out; i++) {
+        slices[i].first_vertex = slices[i - 1].first_vertex + slices[i - 1].max_triangles * 3;
     }
 
-    // push the last object
-    cubes_data.push_back(temp_object_data);
+    return slices;
+}
+
+bool Object::_ParseCube(const char* start, const char* end, glm::vec3& position_out, std::vector<GLfloat>& triangles_values_out, size_t& total_triangles_out) {
+    // same rules as Cube::Parse(), but without a string per line or number
+    total_triangles_out = 0;
+    triangles_values_out.clear();
 
-    return cubes_data;
+    bool first_line = true;
+    GLfloat values[18];
+
+    const char* line = start;
+    while (line < end) {
+        const char* line_end = static_cast<const char*>(std::memchr(line, '\n', end - line));
+        if (line_end == nullptr) line_end = end;
+
+        // read through each number of the line. strtof skips newlines, so spaces are skipped here and it never starts at the line end
+        size_t total_values = 0;
+        const char* read = line;
+        while (read < line_end) {
+            if (*read == ' ' || *read == '\r' || *read == '\t') {
+                read++;
+                continue;
+            }
+
+            char* number_end = nullptr;
+            float value = std::strtof(read, &number_end);
+            if (number_end == read) break;
+
+            if (total_values < 18) values[total_values] = value;
+            total_values++;
+            read = number_end;
+        }
+
+        if (line_end > line) {
+            // first line is the position, every other line is a set of vertices (triangle data)
+            if (first_line) {
+                if (total_values < 3) {
+                    TF_LOG_ERROR("INVALID CUBE POSITION", "Object::_ParseCube");
+                    return false;
+                }
+                position_out = glm::vec3(values[0], values[1], values[2]);
+                first_line = false;
+            } else if (total_values == 18) {
+                triangles_values_out.insert(triangles_values_out.end(), values, values + 18);
+                total_triangles_out++;
+            }
+        }
+
+        line = line_end + 1;
+    }
+
+    return !first_line;
 }
 
 //=============================
@@ -368,7 +1941,23 @@ std::vector<std::string> Object::_SplitByCube(std::string object_data) {
 //=============================
 
 void Object::FreeAll() {
-    for (auto& object : cubes) {
-        object.FreeAll();
+    GLDispatch::Subsystem gl_subsystem("Object");
+    for (auto& cube_template : cube_templates) {
+        cube_template.FreeAll();
     }
+
+    // free lines
+    lines_vertex_array.Reset();
+    lines_vertex_buffer.Reset();
+
+    // free instancing
+    records_texture.Reset();
+    records_buffer.Reset();
+    visible_buffer.Reset();
+    records_capacity = 0;
+
+    // free voxel meshes
+    voxels.FreeAll();
+    records_dirty = true;
+    dirty_records.clear();
 }
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include "OcclusionCuller.h"
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TF_OCCLUSION_SSE
+#endif
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+OcclusionCuller::OcclusionCuller(int p_width, int p_height) {
+    // round up to whole tiles
+    width = std::max(TILE_SIZE, (p_width + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE);
+    height = std::max(TILE_SIZE, (p_height + TILE_SIZE - 1) / TILE_SIZE * TILE_SIZE);
+    blocks_x = width / BLOCK_SIZE;
+    blocks_y = height / BLOCK_SIZE;
+
+    depth_buffer.assign(width * height, 1.0f);
+    block_max_depth.assign(blocks_x * blocks_y, 1.0f);
+}
+
+//=============================
+// BASIC FUNCTIONS
+//=============================
+
+void OcclusionCuller::Clear() {
+    std::fill(depth_buffer.begin(), depth_buffer.end(), 1.0f);
+    std::fill(block_max_depth.begin(), block_max_depth.end(), 1.0f);
+    occluders.clear();
+}
+
+void OcclusionCuller::SetViewProjection(const glm::mat4& p_view_projection_matrix) {
+    view_projection_matrix = p_view_projection_matrix;
+}
+
+//=============================
+// RASTERIZATION
+//=============================
+
+void OcclusionCuller::RasterizeOccluders(const std::vector<glm::vec3>& centers, const std::vector<glm::vec3>& extents, JobSystem* job_system) {
+    size_t total_occluders = std::min(centers.size(), extents.size());
+
+    //// SETUP
+    // project every occluder into its own slot so workers never share one
+    std::vector<ScreenOccluder> screen_occluders(total_occluders);
+    std::vector<Uint8> valid(total_occluders, 0);
+
+    auto SetupOccluders = [&](size_t start, size_t end) {
+        for (size_t i = start; i < end; i++) {
+            std::array<glm::vec3, 8> screen;
+            if (!OcclusionCuller::_ProjectBox(centers[i], extents[i], screen)) continue;
+            valid[i] = OcclusionCuller::_SetupOccluder(screen, screen_occluders[i]);
+        }
+    };
+
+    if (job_system) job_system->ParallelFor(total_occluders, job_system->DefaultGrainSize(total_occluders, 32), SetupOccluders);
+    else SetupOccluders(0, total_occluders);
+
+    for (size_t i = 0; i < total_occluders; i++) {
+        if (valid[i]) occluders.push_back(screen_occluders[i]);
+    }
+
+    //// RASTERIZATION
+    // one tile per job, tiles never share pixels so no locking is needed
+    int tiles_x = width / TILE_SIZE;
+    int tiles_y = height / TILE_SIZE;
+    size_t total_tiles = size_t(tiles_x * tiles_y);
+
+    auto RasterizeTiles = [&](size_t start, size_t end) {
+        for (size_t tile = start; tile < end; tile++) {
+            OcclusionCuller::_RasterizeTile(int(tile) % tiles_x, int(tile) / tiles_x);
+        }
+    };
+
+    if (job_system) job_system->ParallelFor(total_tiles, 1, RasterizeTiles);
+    else RasterizeTiles(0, total_tiles);
+}
+
+//=============================
+// TESTING
+//=============================
+
+bool OcclusionCuller::IsBoxOccluded(glm::vec3 center, glm::vec3 extent) const {
+    std::array<glm::vec3, 8> screen;
+    if (!OcclusionCuller::_ProjectBox(center, extent, screen)) return false;
+
+    glm::vec3 low = screen[0];
+    glm::vec3 high = screen[0];
+    for (const auto& corner : screen) {
+        low = glm::min(low, corner);
+        high = glm::max(high, corner);
+    }
+
+    // off screen entirely, leave it to the frustum culler
+    if (high.x < 0.0f || high.y < 0.0f || low.x >= float(width) || low.y >= float(height)) return false;
+
+    int low_x = std::max(0, int(std::floor(low.x)));
+    int low_y = std::max(0, int(std::floor(low.y)));
+    int high_x = std::min(width - 1, int(std::floor(high.x)));
+    int high_y = std::min(height - 1, int(std::floor(high.y)));
+
+    // a pixel only hides the box if it is in front of the box's nearest point
+    float threshold = low.z - DEPTH_BIAS;
+
+    for (int block_y = low_y / BLOCK_SIZE; block_y <= high_y / BLOCK_SIZE; block_y++) {
+        for (int block_x = low_x / BLOCK_SIZE; block_x <= high_x / BLOCK_SIZE; block_x++) {
+            // every pixel in this block is in front of the box
+            if (block_max_depth[block_y * blocks_x + block_x] < threshold) continue;
+
+            int start_x = std::max(low_x, block_x * BLOCK_SIZE);
+            int end_x = std::min(high_x, block_x * BLOCK_SIZE + BLOCK_SIZE - 1);
+            int start_y = std::max(low_y, block_y * BLOCK_SIZE);
+            int end_y = std::min(high_y, block_y * BLOCK_SIZE + BLOCK_SIZE - 1);
+
+            for (int y = start_y; y <= end_y; y++) {
+                const float* row = &depth_buffer[y * width];
+                int x = start_x;
+#if defined(TF_OCCLUSION_SSE)
+                __m128 threshold_4 = _mm_set1_ps(threshold);
+                for (; x + 4 <= end_x + 1; x += 4) {
+                    if (_mm_movemask_ps(_mm_cmpge_ps(_mm_loadu_ps(row + x), threshold_4)) != 0) return false;
+                }
+#endif
+                for (; x <= end_x; x++) {
+                    if (row[x] >= threshold) return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+//=============================
+// GETTERS
+//=============================
+
+int OcclusionCuller::GetWidth() const {
+    return width;
+}
+
+int OcclusionCuller::GetHeight() const {
+    return height;
+}
+
+const std::vector<float>& OcclusionCuller::GetDepthBuffer() const {
+    return depth_buffer;
+}
+
+size_t OcclusionCuller::GetTotalOccluders() const {
+    return occluders.size();
+}
+
+//=============================
+// PROJECTION FUNCTIONS
+//=============================
+
+bool OcclusionCuller::_ProjectBox(glm::vec3 center, glm::vec3 extent, std::array<glm::vec3, 8>& screen_out) const {
+    for (int corner = 0; corner < 8; corner++) {
+        glm::vec3 sign = glm::vec3((corner & 1) ? 1.0f : -1.0f, (corner & 2) ? 1.0f : -1.0f, (corner & 4) ? 1.0f : -1.0f);
+        glm::vec4 clip = view_projection_matrix * glm::vec4(center + sign * extent, 1.0f);
+
+        // no near plane clipping, boxes touching it are simply left out
+        if (clip.w <= NEAR_W) return false;
+
+        glm::vec3 ndc = glm::vec3(clip) / clip.w;
+        screen_out[corner] = glm::vec3((ndc.x * 0.5f + 0.5f) * width, (ndc.y * 0.5f + 0.5f) * height, ndc.z * 0.5f + 0.5f);
+    }
+    return true;
+}
+
+bool OcclusionCuller::_SetupOccluder(const std::array<glm::vec3, 8>& screen, ScreenOccluder& occluder_out) const {
+    // outward facing, counter clockwise quads of a box. corner index bits: 1 = +x, 2 = +y, 4 = +z
+    static constexpr int FACES[6][4] = {
+        {1, 3, 7, 5}, // +X
+        {0, 4, 6, 2}, // -X
+        {2, 6, 7, 3}, // +Y
+        {0, 1, 5, 4}, // -Y
+        {4, 5, 7, 6}, // +Z
+        {0, 2, 3, 1}  // -Z
+    };
+
+    //// DEPTH PLANES
+    // inside the silhouette the box's surface is the farthest of its front face planes, so each plane is kept whole
+    occluder_out.total_planes = 0;
+    for (int face = 0; face < 6 && occluder_out.total_planes < 3; face++) {
+        const glm::vec3& v0 = screen[FACES[face][0]];
+        const glm::vec3& v1 = screen[FACES[face][1]];
+        const glm::vec3& v2 = screen[FACES[face][2]];
+
+        // back facing or degenerate
+        float area = (v1.x - v0.x) * (v2.y - v0.y) - (v2.x - v0.x) * (v1.y - v0.y);
+        if (area <= 0.0f) continue;
+
+        float z_x = ((v1.z - v0.z) * (v2.y - v0.y) - (v2.z - v0.z) * (v1.y - v0.y)) / area;
+        float z_y = ((v2.z - v0.z) * (v1.x - v0.x) - (v1.z - v0.z) * (v2.x - v0.x)) / area;
+        float z_c = v0.z - z_x * v0.x - z_y * v0.y;
+
+        // the farthest the plane gets within half a pixel of the center
+        occluder_out.planes[occluder_out.total_planes++] = glm::vec3(z_x, z_y, z_c + 0.5f * (std::abs(z_x) + std::abs(z_y)));
+    }
+    if (occluder_out.total_planes == 0) return false;
+
+    //// SILHOUETTE
+    // counter clockwise convex hull of the corners (monotone chain)
+    std::array<glm::vec2, 8> points;
+    for (int corner = 0; corner < 8; corner++) {
+        points[corner] = glm::vec2(screen[corner]);
+    }
+    std::sort(points.begin(), points.end(), [](const glm::vec2& a, const glm::vec2& b) {
+        return a.x < b.x || (a.x == b.x && a.y < b.y);
+    });
+
+    auto Cross = [](const glm::vec2& o, const glm::vec2& a, const glm::vec2& b) {
+        return (a.x - o.x) * (b.y - o.y) - (a.y - o.y) * (b.x - o.x);
+    };
+
+    std::array<glm::vec2, 16> hull;
+    int total_hull = 0;
+    for (int i = 0; i < 8; i++) {
+        while (total_hull >= 2 && Cross(hull[total_hull - 2], hull[total_hull - 1], points[i]) <= 0.0f) total_hull--;
+        hull[total_hull++] = points[i];
+    }
+    for (int i = 6, lower_size = total_hull + 1; i >= 0; i--) {
+        while (total_hull >= lower_size && Cross(hull[total_hull - 2], hull[total_hull - 1], points[i]) <= 0.0f) total_hull--;
+        hull[total_hull++] = points[i];
+    }
+    // the last point repeats the first
+    total_hull--;
+
+    // a box's silhouette has at most 6 corners
+    if (total_hull < 3 || total_hull > 6) return false;
+
+    occluder_out.total_edges = total_hull;
+    for (int i = 0; i < total_hull; i++) {
+        const glm::vec2& p0 = hull[i];
+        const glm::vec2& p1 = hull[(i + 1) % total_hull];
+
+        // edge function E(x, y) = a * x + b * y + c, positive inside. lowered by its smallest value over half a pixel around the center
+        float a = p0.y - p1.y;
+        float b = p1.x - p0.x;
+        float c = -(a * p0.x + b * p0.y);
+        occluder_out.edges[i] = glm::vec3(a, b, c - 0.5f * (std::abs(a) + std::abs(b)));
+    }
+
+    glm::vec2 low = points[0];
+    glm::vec2 high = points[0];
+    for (const auto& point : points) {
+        low = glm::min(low, point);
+        high = glm::max(high, point);
+    }
+
+    occluder_out.low_x = std::max(0, int(std::floor(low.x)));
+    occluder_out.low_y = std::max(0, int(std::floor(low.y)));
+    occluder_out.high_x = std::min(width - 1, int(std::floor(high.x)));
+    occluder_out.high_y = std::min(height - 1, int(std::floor(high.y)));
+
+    return occluder_out.low_x <= occluder_out.high_x && occluder_out.low_y <= occluder_out.high_y;
+}
+
+//=============================
+// RASTERIZATION FUNCTIONS
+//=============================
+
+void OcclusionCuller::_RasterizeTile(int tile_x, int tile_y) {
+    int tile_low_x = tile_x * TILE_SIZE;
+    int tile_low_y = tile_y * TILE_SIZE;
+    int tile_high_x = tile_low_x + TILE_SIZE - 1;
+    int tile_high_y = tile_low_y + TILE_SIZE - 1;
+
+    for (const auto& occluder : occluders) {
+        // clip the occluder bounds to this tile
+        int low_x = std::max(occluder.low_x, tile_low_x);
+        int low_y = std::max(occluder.low_y, tile_low_y);
+        int high_x = std::min(occluder.high_x, tile_high_x);
+        int high_y = std::min(occluder.high_y, tile_high_y);
+
+        if (low_x > high_x || low_y > high_y) continue;
+
+        OcclusionCuller::_RasterizeOccluder(occluder, low_x, low_y, high_x, high_y);
+    }
+
+    OcclusionCuller::_UpdateBlocks(tile_low_x, tile_low_y, tile_high_x, tile_high_y);
+}
+
+void OcclusionCuller::_RasterizeOccluder(const ScreenOccluder& occluder, int low_x, int low_y, int high_x, int high_y) {
+    int total_edges = occluder.total_edges;
+    int total_planes = occluder.total_planes;
+
+    for (int y = low_y; y <= high_y; y++) {
+        float pixel_y = float(y) + 0.5f;
+        float* row = &depth_buffer[y * width];
+        int x = low_x;
+
+        // the y part of every edge and plane is the same along the row
+        std::array<float, 6> row_edges;
+        std::array<float, 3> row_planes;
+        for (int edge = 0; edge < total_edges; edge++) row_edges[edge] = occluder.edges[edge].y * pixel_y + occluder.edges[edge].z;
+        for (int plane = 0; plane < total_planes; plane++) row_planes[plane] = occluder.planes[plane].y * pixel_y + occluder.planes[plane].z;
+
+#if defined(TF_OCCLUSION_SSE)
+        // 4 pixels at a time. tiles start on multiples of 4, so aligning down never leaves the tile
+        x = low_x & ~3;
+        __m128 lane_offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        __m128 zero = _mm_setzero_ps();
+
+        for (; x <= high_x; x += 4) {
+            __m128 pixel_x = _mm_add_ps(_mm_set1_ps(float(x)), lane_offsets);
+
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (int edge = 0; edge < total_edges; edge++) {
+                __m128 e = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(occluder.edges[edge].x), pixel_x), _mm_set1_ps(row_edges[edge]));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(e, zero));
+            }
+            if (_mm_movemask_ps(inside) == 0) continue;
+
+            __m128 depth = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(occluder.planes[0].x), pixel_x), _mm_set1_ps(row_planes[0]));
+            for (int plane = 1; plane < total_planes; plane++) {
+                depth = _mm_max_ps(depth, _mm_add_ps(_mm_mul_ps(_mm_set1_ps(occluder.planes[plane].x), pixel_x), _mm_set1_ps(row_planes[plane])));
+            }
+
+            __m128 current = _mm_loadu_ps(row + x);
+            __m128 nearest = _mm_min_ps(current, depth);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+        }
+#endif
+
+        // scalar path for builds without SSE
+        for (; x <= high_x; x++) {
+            float pixel_x = float(x) + 0.5f;
+
+            bool inside = true;
+            for (int edge = 0; edge < total_edges && inside; edge++) {
+                inside = occluder.edges[edge].x * pixel_x + row_edges[edge] >= 0.0f;
+            }
+            if (!inside) continue;
+
+            float depth = occluder.planes[0].x * pixel_x + row_planes[0];
+            for (int plane = 1; plane < total_planes; plane++) {
+                depth = std::max(depth, occluder.planes[plane].x * pixel_x + row_planes[plane]);
+            }
+            if (depth < row[x]) row[x] = depth;
+        }
+    }
+}
+
+void OcclusionCuller::_UpdateBlocks(int low_x, int low_y, int high_x, int high_y) {
+    for (int block_y = low_y / BLOCK_SIZE; block_y <= high_y / BLOCK_SIZE; block_y++) {
+        for (int block_x = low_x / BLOCK_SIZE; block_x <= high_x / BLOCK_SIZE; block_x++) {
+            float max_depth = 0.0f;
+
+            for (int y = block_y * BLOCK_SIZE; y < (block_y + 1) * BLOCK_SIZE; y++) {
+                const float* row = &depth_buffer[y * width + block_x * BLOCK_SIZE];
+                for (int x = 0; x < BLOCK_SIZE; x++) {
+                    max_depth = std::max(max_depth, row[x]);
+                }
+            }
+
+            block_max_depth[block_y * blocks_x + block_x] = max_depth;
+        }
+    }
+}
@@ -0,0 +1,543 @@
+#include "OccupancyGrid.h"
+
+#include <unordered_set>
+#include <cstring>
+#include <atomic>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TF_OCCUPANCY_SSE
+#endif
+
+namespace {
+    // rows are processed a block at a time, 8 rows per SSE register or 1 row per Uint16 without SSE
+#if defined(TF_OCCUPANCY_SSE)
+    using RowBlock = __m128i;
+    constexpr int BLOCK_ROWS = 8;
+
+    inline RowBlock LoadRows(const Uint16* rows) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(rows)); }
+    inline void StoreRows(Uint16* rows, RowBlock block) { _mm_storeu_si128(reinterpret_cast<__m128i*>(rows), block); }
+    inline RowBlock And(RowBlock a, RowBlock b) { return _mm_and_si128(a, b); }
+    inline RowBlock Or(RowBlock a, RowBlock b) { return _mm_or_si128(a, b); }
+    // a & ~b
+    inline RowBlock AndNot(RowBlock a, RowBlock b) { return _mm_andnot_si128(b, a); }
+    // x + 1 moved down to x, bit 15 taken from the next chunk's bit 0
+    inline RowBlock NextAlongX(RowBlock self, RowBlock next) { return _mm_or_si128(_mm_srli_epi16(self, 1), _mm_slli_epi16(next, 15)); }
+    // x - 1 moved up to x, bit 0 taken from the previous chunk's bit 15
+    inline RowBlock PreviousAlongX(RowBlock self, RowBlock previous) { return _mm_or_si128(_mm_slli_epi16(self, 1), _mm_srli_epi16(previous, 15)); }
+#else
+    using RowBlock = Uint16;
+    constexpr int BLOCK_ROWS = 1;
+
+    inline RowBlock LoadRows(const Uint16* rows) { return *rows; }
+    inline void StoreRows(Uint16* rows, RowBlock block) { *rows = block; }
+    inline RowBlock And(RowBlock a, RowBlock b) { return a & b; }
+    inline RowBlock Or(RowBlock a, RowBlock b) { return a | b; }
+    inline RowBlock AndNot(RowBlock a, RowBlock b) { return a & Uint16(~b); }
+    inline RowBlock NextAlongX(RowBlock self, RowBlock next) { return Uint16((self >> 1) | (next << 15)); }
+    inline RowBlock PreviousAlongX(RowBlock self, RowBlock previous) { return Uint16((self << 1) | (previous >> 15)); }
+#endif
+
+    constexpr int SIZE = OccupancyGrid::CHUNK_SIZE;
+    constexpr int HALO_SIZE = SIZE + 2;
+
+    // the chunk's rows with a one row border taken from the y and z neighbors, plus the whole x neighbors
+    struct Halo {
+        // rows[(z + 1) * HALO_SIZE + y + 1]
+        alignas(16) Uint16 rows[HALO_SIZE * HALO_SIZE];
+        alignas(16) Uint16 next_x[OccupancyGrid::CHUNK_ROWS];
+        alignas(16) Uint16 previous_x[OccupancyGrid::CHUNK_ROWS];
+    };
+
+    void BuildHalo(const OccupancyGrid::Chunk& chunk, const OccupancyGrid::Neighbors& neighbors, Halo& halo) {
+        std::memset(&halo, 0, sizeof(Halo));
+
+        for (int z = 0; z < SIZE; z++) {
+            std::memcpy(&halo.rows[(z + 1) * HALO_SIZE + 1], &chunk.rows[z * SIZE], SIZE * sizeof(Uint16));
+        }
+
+        const OccupancyGrid::Chunk* positive_y = neighbors[TotalFrame::FACE_POSITIVE_Y];
+        const OccupancyGrid::Chunk* negative_y = neighbors[TotalFrame::FACE_NEGATIVE_Y];
+        for (int z = 0; z < SIZE; z++) {
+            if (positive_y) halo.rows[(z + 1) * HALO_SIZE + SIZE + 1] = positive_y->rows[z * SIZE];
+            if (negative_y) halo.rows[(z + 1) * HALO_SIZE] = negative_y->rows[z * SIZE + SIZE - 1];
+        }
+
+        const OccupancyGrid::Chunk* positive_z = neighbors[TotalFrame::FACE_POSITIVE_Z];
+        const OccupancyGrid::Chunk* negative_z = neighbors[TotalFrame::FACE_NEGATIVE_Z];
+        if (positive_z) std::memcpy(&halo.rows[(SIZE + 1) * HALO_SIZE + 1], &positive_z->rows[0], SIZE * sizeof(Uint16));
+        if (negative_z) std::memcpy(&halo.rows[1], &negative_z->rows[(SIZE - 1) * SIZE], SIZE * sizeof(Uint16));
+
+        if (neighbors[TotalFrame::FACE_POSITIVE_X]) std::memcpy(halo.next_x, neighbors[TotalFrame::FACE_POSITIVE_X]->rows, sizeof(halo.next_x));
+        if (neighbors[TotalFrame::FACE_NEGATIVE_X]) std::memcpy(halo.previous_x, neighbors[TotalFrame::FACE_NEGATIVE_X]->rows, sizeof(halo.previous_x));
+    }
+
+    // calls function(row, self, neighbors in TotalFrame::FACE order) for every block of rows of the chunk
+    template <typename BlockFunction>
+    void ForEachBlock(const Halo& halo, const BlockFunction& function) {
+        for (int z = 0; z < SIZE; z++) {
+            for (int y = 0; y < SIZE; y += BLOCK_ROWS) {
+                int row = z * SIZE + y;
+                int center = (z + 1) * HALO_SIZE + y + 1;
+
+                RowBlock self = LoadRows(&halo.rows[center]);
+                RowBlock neighbor_blocks[6] = {
+                    NextAlongX(self, LoadRows(&halo.next_x[row])),
+                    PreviousAlongX(self, LoadRows(&halo.previous_x[row])),
+                    LoadRows(&halo.rows[center + 1]),
+                    LoadRows(&halo.rows[center - 1]),
+                    LoadRows(&halo.rows[center + HALO_SIZE]),
+                    LoadRows(&halo.rows[center - HALO_SIZE])
+                };
+                function(row, self, neighbor_blocks);
+            }
+        }
+    }
+
+    int CountBits(Uint16 bits) {
+        return __builtin_popcount(bits);
+    }
+}
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+OccupancyGrid::OccupancyGrid() {
+    ;
+}
+
+//=============================
+// CHUNK FUNCTIONS
+//=============================
+
+bool OccupancyGrid::Chunk::Get(glm::ivec3 local_cell) const {
+    return (rows[local_cell.z * CHUNK_SIZE + local_cell.y] >> local_cell.x) & 1;
+}
+
+void OccupancyGrid::Chunk::Set(glm::ivec3 local_cell, bool occupied) {
+    Uint16& row = rows[local_cell.z * CHUNK_SIZE + local_cell.y];
+    if (occupied) row |= Uint16(1 << local_cell.x);
+    else row &= Uint16(~(1 << local_cell.x));
+}
+
+size_t OccupancyGrid::Chunk::Count() const {
+    size_t count = 0;
+    for (Uint16 row : rows) {
+        count += CountBits(row);
+    }
+    return count;
+}
+
+bool OccupancyGrid::Chunk::IsEmpty() const {
+    for (Uint16 row : rows) {
+        if (row != 0) return false;
+    }
+    return true;
+}
+
+//=============================
+// CHUNK KERNELS
+//=============================
+
+void OccupancyGrid::GetExposedFaces(const Chunk& chunk, const Neighbors& neighbors, std::array<Chunk, 6>& faces_out) {
+    Halo halo;
+    BuildHalo(chunk, neighbors, halo);
+
+    ForEachBlock(halo, [&](int row, RowBlock self, const RowBlock* neighbor_blocks) {
+        for (int face = 0; face < 6; face++) {
+            StoreRows(&faces_out[face].rows[row], AndNot(self, neighbor_blocks[face]));
+        }
+    });
+}
+
+void OccupancyGrid::Erode(const Chunk& chunk, const Neighbors& neighbors, Chunk& chunk_out) {
+    Halo halo;
+    BuildHalo(chunk, neighbors, halo);
+
+    ForEachBlock(halo, [&](int row, RowBlock self, const RowBlock* neighbor_blocks) {
+        RowBlock eroded = self;
+        for (int face = 0; face < 6; face++) {
+            eroded = And(eroded, neighbor_blocks[face]);
+        }
+        StoreRows(&chunk_out.rows[row], eroded);
+    });
+}
+
+void OccupancyGrid::Dilate(const Chunk& chunk, const Neighbors& neighbors, Chunk& chunk_out) {
+    Halo halo;
+    BuildHalo(chunk, neighbors, halo);
+
+    ForEachBlock(halo, [&](int row, RowBlock self, const RowBlock* neighbor_blocks) {
+        RowBlock dilated = self;
+        for (int face = 0; face < 6; face++) {
+            dilated = Or(dilated, neighbor_blocks[face]);
+        }
+        StoreRows(&chunk_out.rows[row], dilated);
+    });
+}
+
+//=============================
+// CELL FUNCTIONS
+//=============================
+
+void OccupancyGrid::Set(glm::ivec3 cell, bool occupied) {
+    glm::ivec3 chunk_coordinate = OccupancyGrid::GetChunkCoordinate(cell);
+    glm::ivec3 local_cell = OccupancyGrid::GetLocalCell(cell, chunk_coordinate);
+    Uint64 key = OccupancyGrid::GetKey(chunk_coordinate);
+
+    auto found = chunks.find(key);
+    if (found == chunks.end()) {
+        if (!occupied) return;
+        found = chunks.emplace(key, std::make_unique<Chunk>()).first;
+    }
+
+    Chunk& chunk = *found->second;
+    if (chunk.Get(local_cell) == occupied) return;
+
+    chunk.Set(local_cell, occupied);
+    if (occupied) {
+        total_cells++;
+    } else {
+        total_cells--;
+        if (chunk.IsEmpty()) chunks.erase(found);
+    }
+}
+
+void OccupancyGrid::SetChunk(glm::ivec3 chunk_coordinate, const Chunk& cells) {
+    if (cells.IsEmpty()) return;
+
+    std::unique_ptr<Chunk>& chunk = chunks[OccupancyGrid::GetKey(chunk_coordinate)];
+    if (chunk == nullptr) chunk = std::make_unique<Chunk>();
+
+    for (int row = 0; row < CHUNK_ROWS; row++) {
+        total_cells += CountBits(cells.rows[row] & Uint16(~chunk->rows[row]));
+        chunk->rows[row] |= cells.rows[row];
+    }
+}
+
+bool OccupancyGrid::IsOccupied(glm::ivec3 cell) const {
+    glm::ivec3 chunk_coordinate = OccupancyGrid::GetChunkCoordinate(cell);
+    const Chunk* chunk = OccupancyGrid::FindChunk(chunk_coordinate);
+    return chunk != nullptr && chunk->Get(OccupancyGrid::GetLocalCell(cell, chunk_coordinate));
+}
+
+Uint8 OccupancyGrid::GetNeighborMask(glm::ivec3 cell) const {
+    Uint8 mask = 0;
+    for (int face = 0; face < 6; face++) {
+        if (OccupancyGrid::IsOccupied(cell + glm::ivec3(TotalFrame::FACE_NORMALS[face]))) mask |= Uint8(1 << face);
+    }
+    return mask;
+}
+
+void OccupancyGrid::Clear() {
+    chunks.clear();
+    total_cells = 0;
+}
+
+//=============================
+// GRID OPERATIONS
+//=============================
+
+OccupancyGrid OccupancyGrid::Dilated(JobSystem* job_system) const {
+    // dilation spills into the empty chunks around the occupied ones
+    std::unordered_set<Uint64> keys = {};
+    std::vector<glm::ivec3> coordinates = {};
+    for (const auto& [key, chunk] : chunks) {
+        glm::ivec3 chunk_coordinate = OccupancyGrid::_GetChunkCoordinate(key);
+        for (int face = -1; face < 6; face++) {
+            glm::ivec3 coordinate = face < 0 ? chunk_coordinate : chunk_coordinate + glm::ivec3(TotalFrame::FACE_NORMALS[face]);
+            if (keys.insert(OccupancyGrid::GetKey(coordinate)).second) coordinates.push_back(coordinate);
+        }
+    }
+
+    return OccupancyGrid::_Apply(coordinates, job_system, [](const Chunk& chunk, const Neighbors& neighbors, Chunk& chunk_out) {
+        OccupancyGrid::Dilate(chunk, neighbors, chunk_out);
+    });
+}
+
+OccupancyGrid OccupancyGrid::Eroded(JobSystem* job_system) const {
+    return OccupancyGrid::_Apply(OccupancyGrid::GetChunkCoordinates(), job_system, [](const Chunk& chunk, const Neighbors& neighbors, Chunk& chunk_out) {
+        OccupancyGrid::Erode(chunk, neighbors, chunk_out);
+    });
+}
+
+OccupancyGrid OccupancyGrid::GetShell(JobSystem* job_system) const {
+    return OccupancyGrid::_Apply(OccupancyGrid::GetChunkCoordinates(), job_system, [](const Chunk& chunk, const Neighbors& neighbors, Chunk& chunk_out) {
+        Chunk eroded;
+        OccupancyGrid::Erode(chunk, neighbors, eroded);
+        for (int row = 0; row < CHUNK_ROWS; row += BLOCK_ROWS) {
+            StoreRows(&chunk_out.rows[row], AndNot(LoadRows(&chunk.rows[row]), LoadRows(&eroded.rows[row])));
+        }
+    });
+}
+
+OccupancyGrid OccupancyGrid::GetEnclosed(JobSystem* job_system) const {
+    OccupancyGrid enclosed;
+    if (chunks.empty()) return enclosed;
+
+    // chunk bounds around the grid with an empty layer on every side, the outside starts from that layer
+    glm::ivec3 min_chunk = glm::ivec3(std::numeric_limits<int>::max());
+    glm::ivec3 max_chunk = glm::ivec3(std::numeric_limits<int>::min());
+    for (const auto& [key, chunk] : chunks) {
+        glm::ivec3 chunk_coordinate = OccupancyGrid::_GetChunkCoordinate(key);
+        min_chunk = glm::min(min_chunk, chunk_coordinate);
+        max_chunk = glm::max(max_chunk, chunk_coordinate);
+    }
+    min_chunk -= glm::ivec3(1);
+    max_chunk += glm::ivec3(1);
+
+    glm::ivec3 bounds = max_chunk - min_chunk + glm::ivec3(1);
+    size_t total_bound_chunks = size_t(bounds.x) * size_t(bounds.y) * size_t(bounds.z);
+    if (total_bound_chunks > ENCLOSED_MAX_CHUNKS) {
+        TF_LOG_ERROR("GRID IS TOO SPREAD OUT TO FIND ENCLOSED CELLS", "OccupancyGrid::GetEnclosed");
+        return enclosed;
+    }
+
+    auto GetBoundIndex = [&](glm::ivec3 chunk_coordinate) {
+        glm::ivec3 offset = chunk_coordinate - min_chunk;
+        return (size_t(offset.z) * size_t(bounds.y) + size_t(offset.y)) * size_t(bounds.x) + size_t(offset.x);
+    };
+
+    // empty chunks reached from the bounds through other empty chunks are outside as a whole
+    std::vector<Uint8> outside_chunks(total_bound_chunks, 0);
+    std::vector<glm::ivec3> open_chunks = {};
+    glm::ivec3 chunk_coordinate = glm::ivec3(0);
+    for (chunk_coordinate.z = min_chunk.z; chunk_coordinate.z <= max_chunk.z; chunk_coordinate.z++) {
+        for (chunk_coordinate.y = min_chunk.y; chunk_coordinate.y <= max_chunk.y; chunk_coordinate.y++) {
+            for (chunk_coordinate.x = min_chunk.x; chunk_coordinate.x <= max_chunk.x; chunk_coordinate.x++) {
+                if (glm::all(glm::greaterThan(chunk_coordinate, min_chunk)) && glm::all(glm::lessThan(chunk_coordinate, max_chunk))) continue;
+                outside_chunks[GetBoundIndex(chunk_coordinate)] = 1;
+                open_chunks.push_back(chunk_coordinate);
+            }
+        }
+    }
+    while (!open_chunks.empty()) {
+        glm::ivec3 open_chunk = open_chunks.back();
+        open_chunks.pop_back();
+
+        for (int face = 0; face < 6; face++) {
+            glm::ivec3 next_chunk = open_chunk + glm::ivec3(TotalFrame::FACE_NORMALS[face]);
+            if (glm::any(glm::lessThan(next_chunk, min_chunk)) || glm::any(glm::greaterThan(next_chunk, max_chunk))) continue;
+
+            size_t bound_index = GetBoundIndex(next_chunk);
+            if (outside_chunks[bound_index] || OccupancyGrid::FindChunk(next_chunk) != nullptr) continue;
+            outside_chunks[bound_index] = 1;
+            open_chunks.push_back(next_chunk);
+        }
+    }
+
+    // the occupied chunks and any empty pockets between them are flooded cell by cell. they never touch the bounds, so all their neighbors are in here or outside
+    std::vector<glm::ivec3> coordinates = {};
+    std::vector<Uint32> slots(total_bound_chunks, UINT32_MAX);
+    for (size_t bound_index = 0; bound_index < total_bound_chunks; bound_index++) {
+        if (outside_chunks[bound_index]) continue;
+        slots[bound_index] = Uint32(coordinates.size());
+        coordinates.push_back(min_chunk + glm::ivec3(int(bound_index % size_t(bounds.x)), int((bound_index / size_t(bounds.x)) % size_t(bounds.y)), int(bound_index / (size_t(bounds.x) * size_t(bounds.y)))));
+    }
+
+    Chunk full_chunk;
+    std::memset(full_chunk.rows, 0xFF, sizeof(full_chunk.rows));
+    const Chunk empty_chunk;
+
+    // every pass reads the last pass's outside cells and writes its own, so the chunks are flooded in parallel
+    std::vector<Chunk> outside(coordinates.size());
+    std::vector<Chunk> next_outside(coordinates.size());
+
+    auto GetOutsideNeighbors = [&](size_t i) {
+        Neighbors neighbors;
+        for (int face = 0; face < 6; face++) {
+            size_t bound_index = GetBoundIndex(coordinates[i] + glm::ivec3(TotalFrame::FACE_NORMALS[face]));
+            neighbors[face] = outside_chunks[bound_index] ? &full_chunk : &outside[slots[bound_index]];
+        }
+        return neighbors;
+    };
+
+    bool changed = true;
+    while (changed) {
+        std::atomic<bool> any_changed = false;
+
+        auto FloodRange = [&](size_t start_index, size_t end_index) {
+            for (size_t i = start_index; i < end_index; i++) {
+                const Chunk* occupied = OccupancyGrid::FindChunk(coordinates[i]);
+                if (occupied == nullptr) occupied = &empty_chunk;
+                Neighbors neighbors = GetOutsideNeighbors(i);
+
+                // grows to a fixed point within the chunk, cells on the neighbors' side are the seeds
+                Chunk current = outside[i];
+                Chunk grown;
+                while (true) {
+                    OccupancyGrid::Dilate(current, neighbors, grown);
+                    for (int row = 0; row < CHUNK_ROWS; row += BLOCK_ROWS) {
+                        StoreRows(&grown.rows[row], AndNot(LoadRows(&grown.rows[row]), LoadRows(&occupied->rows[row])));
+                    }
+                    if (std::memcmp(grown.rows, current.rows, sizeof(current.rows)) == 0) break;
+                    current = grown;
+                }
+
+                if (std::memcmp(current.rows, outside[i].rows, sizeof(current.rows)) != 0) any_changed = true;
+                next_outside[i] = current;
+            }
+        };
+
+        if (job_system == nullptr) FloodRange(0, coordinates.size());
+        else job_system->ParallelFor(coordinates.size(), job_system->DefaultGrainSize(coordinates.size(), 4), FloodRange);
+
+        std::swap(outside, next_outside);
+        changed = any_changed;
+    }
+
+    // occupied cells touching none of the outside are enclosed
+    for (size_t i = 0; i < coordinates.size(); i++) {
+        const Chunk* occupied = OccupancyGrid::FindChunk(coordinates[i]);
+        if (occupied == nullptr) continue;
+
+        Chunk touched;
+        OccupancyGrid::Dilate(outside[i], GetOutsideNeighbors(i), touched);
+
+        Chunk enclosed_chunk;
+        for (int row = 0; row < CHUNK_ROWS; row += BLOCK_ROWS) {
+            StoreRows(&enclosed_chunk.rows[row], AndNot(LoadRows(&occupied->rows[row]), LoadRows(&touched.rows[row])));
+        }
+
+        size_t count = enclosed_chunk.Count();
+        if (count == 0) continue;
+        enclosed.chunks.emplace(OccupancyGrid::GetKey(coordinates[i]), std::make_unique<Chunk>(enclosed_chunk));
+        enclosed.total_cells += count;
+    }
+
+    return enclosed;
+}
+
+size_t OccupancyGrid::CountExposedFaces(JobSystem* job_system) const {
+    std::vector<glm::ivec3> coordinates = OccupancyGrid::GetChunkCoordinates();
+    std::atomic<size_t> total_faces = 0;
+
+    auto CountRange = [&](size_t start_index, size_t end_index) {
+        size_t range_faces = 0;
+        std::array<Chunk, 6> faces;
+        for (size_t i = start_index; i < end_index; i++) {
+            OccupancyGrid::GetExposedFaces(*OccupancyGrid::FindChunk(coordinates[i]), OccupancyGrid::GetNeighbors(coordinates[i]), faces);
+            for (const auto& face : faces) {
+                range_faces += face.Count();
+            }
+        }
+        total_faces += range_faces;
+    };
+
+    if (job_system == nullptr) CountRange(0, coordinates.size());
+    else job_system->ParallelFor(coordinates.size(), job_system->DefaultGrainSize(coordinates.size(), 4), CountRange);
+
+    return total_faces;
+}
+
+void OccupancyGrid::GetCells(std::vector<glm::ivec3>& cells_out) const {
+    for (const auto& [key, chunk] : chunks) {
+        glm::ivec3 chunk_origin = OccupancyGrid::_GetChunkCoordinate(key) * CHUNK_SIZE;
+        for (int row = 0; row < CHUNK_ROWS; row++) {
+            for (Uint16 bits = chunk->rows[row]; bits != 0; bits &= Uint16(bits - 1)) {
+                cells_out.push_back(chunk_origin + glm::ivec3(__builtin_ctz(bits), row % CHUNK_SIZE, row / CHUNK_SIZE));
+            }
+        }
+    }
+}
+
+//=============================
+// CHUNK ACCESS
+//=============================
+
+const OccupancyGrid::Chunk* OccupancyGrid::FindChunk(glm::ivec3 chunk_coordinate) const {
+    auto found = chunks.find(OccupancyGrid::GetKey(chunk_coordinate));
+    return found == chunks.end() ? nullptr : found->second.get();
+}
+
+OccupancyGrid::Neighbors OccupancyGrid::GetNeighbors(glm::ivec3 chunk_coordinate) const {
+    Neighbors neighbors;
+    for (int face = 0; face < 6; face++) {
+        neighbors[face] = OccupancyGrid::FindChunk(chunk_coordinate + glm::ivec3(TotalFrame::FACE_NORMALS[face]));
+    }
+    return neighbors;
+}
+
+std::vector<glm::ivec3> OccupancyGrid::GetChunkCoordinates() const {
+    std::vector<glm::ivec3> coordinates = {};
+    coordinates.reserve(chunks.size());
+    for (const auto& [key, chunk] : chunks) {
+        coordinates.push_back(OccupancyGrid::_GetChunkCoordinate(key));
+    }
+    return coordinates;
+}
+
+//=============================
+// GETTERS
+//=============================
+
+size_t OccupancyGrid::GetTotalCells() const {
+    return total_cells;
+}
+
+size_t OccupancyGrid::GetTotalChunks() const {
+    return chunks.size();
+}
+
+//=============================
+// COORDINATE FUNCTIONS
+//=============================
+
+Uint64 OccupancyGrid::GetKey(glm::ivec3 chunk_coordinate) {
+    // 21 bits per axis
+    return (Uint64(Uint32(chunk_coordinate.x) & 0x1FFFFF)) | (Uint64(Uint32(chunk_coordinate.y) & 0x1FFFFF) << 21) | (Uint64(Uint32(chunk_coordinate.z) & 0x1FFFFF) << 42);
+}
+
+glm::ivec3 OccupancyGrid::GetChunkCoordinate(glm::ivec3 cell) {
+    glm::ivec3 chunk_coordinate;
+    for (int i = 0; i < 3; i++) {
+        chunk_coordinate[i] = cell[i] >= 0 ? cell[i] / CHUNK_SIZE : -((-cell[i] + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    }
+    return chunk_coordinate;
+}
+
+glm::ivec3 OccupancyGrid::GetLocalCell(glm::ivec3 cell, glm::ivec3 chunk_coordinate) {
+    return cell - chunk_coordinate * CHUNK_SIZE;
+}
+
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
+
+glm::ivec3 OccupancyGrid::_GetChunkCoordinate(Uint64 key) {
+    // sign extends each 21 bit axis back
+    auto Axis = [&](int shift) {
+        Sint32 value = Sint32((key >> shift) & 0x1FFFFF);
+        return value >= (1 << 20) ? value - (1 << 21) : value;
+    };
+    return glm::ivec3(Axis(0), Axis(21), Axis(42));
+}
+
+template <typename Kernel>
+OccupancyGrid OccupancyGrid::_Apply(const std::vector<glm::ivec3>& coordinates, JobSystem* job_system, const Kernel& kernel) const {
+    // every chunk writes its own result, the grid is only read
+    std::vector<Chunk> results(coordinates.size());
+    const Chunk empty_chunk;
+
+    auto ApplyRange = [&](size_t start_index, size_t end_index) {
+        for (size_t i = start_index; i < end_index; i++) {
+            const Chunk* chunk = OccupancyGrid::FindChunk(coordinates[i]);
+            kernel(chunk == nullptr ? empty_chunk : *chunk, OccupancyGrid::GetNeighbors(coordinates[i]), results[i]);
+        }
+    };
+
+    if (job_system == nullptr) ApplyRange(0, coordinates.size());
+    else job_system->ParallelFor(coordinates.size(), job_system->DefaultGrainSize(coordinates.size(), 4), ApplyRange);
+
+    OccupancyGrid grid;
+    for (size_t i = 0; i < coordinates.size(); i++) {
+        size_t count = results[i].Count();
+        if (count == 0) continue;
+
+        grid.chunks.emplace(OccupancyGrid::GetKey(coordinates[i]), std::make_unique<Chunk>(results[i]));
+        grid.total_cells += count;
+    }
+    return grid;
+}
@@ -0,0 +1,157 @@
+#include "Profiler.h"
+
+#include <fstream>
+#include <algorithm>
+
+std::mutex Profiler::registry_mutex;
+std::vector<std::unique_ptr<Profiler::ThreadBuffer>> Profiler::registry = {};
+thread_local Profiler::ThreadBuffer* Profiler::thread_buffer = nullptr;
+
+namespace {
+    void AppendEscaped(std::string& out, const std::string& text) {
+        for (char character : text) {
+            if (character == '"' || character == '\\') out += '\\';
+            out += character;
+        }
+    }
+}
+
+//=============================
+// SCOPE TIMER
+//=============================
+
+Profiler::Scope::Scope(const char* p_name) : name(p_name), start(SDL_GetPerformanceCounter()) {}
+
+Profiler::Scope::~Scope() {
+    Profiler::_Record(name, start, SDL_GetPerformanceCounter());
+}
+
+//=============================
+// THREADS
+//=============================
+
+void Profiler::SetThreadName(const std::string& name) {
+    ThreadBuffer& buffer = Profiler::_GetThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    buffer.name = name;
+}
+
+//=============================
+// OUTPUT
+//=============================
+
+bool Profiler::WriteTrace(const std::string& path) {
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 first_tick = UINT64_MAX;
+
+    struct ThreadEvents {
+        Uint32 thread_index = 0;
+        std::string name = "";
+        std::vector<Event> events = {};
+    };
+    std::vector<ThreadEvents> threads = {};
+
+    {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        for (const auto& buffer : registry) {
+            ThreadEvents thread;
+            thread.thread_index = buffer->thread_index;
+            thread.name = buffer->name;
+
+            // copy the last BUFFER_EVENTS events, skipping slots that no longer (or not yet) hold the event expected there
+            Uint64 end = buffer->total_written.load(std::memory_order_acquire);
+            Uint64 start = end > BUFFER_EVENTS ? end - BUFFER_EVENTS : 0;
+            thread.events.reserve(size_t(end - start));
+            for (Uint64 i = start; i < end; i++) {
+                const Slot& slot = buffer->slots[size_t(i & (BUFFER_EVENTS - 1))];
+                if (slot.sequence.load(std::memory_order_acquire) != i + 1) continue;
+
+                Event event;
+                event.name = slot.name.load(std::memory_order_relaxed);
+                event.start = slot.start.load(std::memory_order_relaxed);
+                event.end = slot.end.load(std::memory_order_relaxed);
+
+                // the thread started rewriting the slot while it was read
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (slot.sequence.load(std::memory_order_relaxed) != i + 1) continue;
+
+                thread.events.push_back(event);
+            }
+
+            for (const auto& event : thread.events) {
+                first_tick = std::min(first_tick, event.start);
+            }
+            threads.push_back(std::move(thread));
+        }
+    }
+
+    if (first_tick == UINT64_MAX) return false;
+
+    // times are microseconds since the first event
+    auto ToMicroseconds = [&](Uint64 ticks) {
+        return double(ticks) * 1000000.0 / double(frequency);
+    };
+
+    std::string json = "{\"traceEvents\":[\n";
+    bool first_event = true;
+    char number_text[64];
+
+    for (const auto& thread : threads) {
+        std::string name = thread.name.empty() ? "thread " + std::to_string(thread.thread_index) : thread.name;
+
+        if (!first_event) json += ",\n";
+        first_event = false;
+        json += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" + std::to_string(thread.thread_index) + ",\"args\":{\"name\":\"";
+        AppendEscaped(json, name);
+        json += "\"}}";
+
+        for (const auto& event : thread.events) {
+            json += ",\n{\"name\":\"";
+            AppendEscaped(json, event.name);
+            json += "\",\"ph\":\"X\",\"pid\":1,\"tid\":" + std::to_string(thread.thread_index);
+            std::snprintf(number_text, sizeof(number_text), ",\"ts\":%.3f,\"dur\":%.3f}", ToMicroseconds(event.start - first_tick), ToMicroseconds(event.end - event.start));
+            json += number_text;
+        }
+    }
+    json += "\n]}\n";
+
+    std::ofstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        TF_LOG_ERROR("COULD NOT OPEN TRACE FILE", "Profiler::WriteTrace");
+        return false;
+    }
+    file << json;
+    return true;
+}
+
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
+
+Profiler::ThreadBuffer& Profiler::_GetThreadBuffer() {
+    if (thread_buffer != nullptr) return *thread_buffer;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    registry.push_back(std::make_unique<ThreadBuffer>());
+    thread_buffer = registry.back().get();
+    thread_buffer->thread_index = Uint32(registry.size());
+    return *thread_buffer;
+}
+
+void Profiler::_Record(const char* name, Uint64 start, Uint64 end) {
+    ThreadBuffer& buffer = Profiler::_GetThreadBuffer();
+
+    // only this thread writes. the slot is marked as being written before its fields change, and the release stores publish the event to WriteTrace()
+    Uint64 index = buffer.total_written.load(std::memory_order_relaxed);
+    Slot& slot = buffer.slots[size_t(index & (BUFFER_EVENTS - 1))];
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.end.store(end, std::memory_order_relaxed);
+
+    slot.sequence.store(index + 1, std::memory_order_release);
+    buffer.total_written.store(index + 1, std::memory_order_release);
+}
@@ -4,28 +4,68 @@ Renderer::Renderer() {
     ;
 }
 
-void Renderer::Add(const Skybox& item, int layer) {
-    skyboxes.push_back({item, layer});
+//=============================
+// REGISTRATION
+//=============================
+
+Renderer::Handle Renderer::Add(Skybox& item, int layer) {
+    return Renderer::_Insert(SKYBOX_ITEM, &item, layer);
+}
+
+Renderer::Handle Renderer::Add(Object& item, int layer) {
+    return Renderer::_Insert(OBJECT_ITEM, &item, layer);
 }
 
-void Renderer::Add(const Object& item, int layer) {
-    objects.push_back({item, layer});
+Renderer::Handle Renderer::Add(Texture& item, int layer) {
+    return Renderer::_Insert(TEXTURE_ITEM, &item, layer);
 }
 
-void Renderer::Add(const Texture& item, int layer) {
-    textures.push_back({item, layer});
+void Renderer::Remove(Handle handle) {
+    size_t index = Renderer::_Find(handle);
+    if (index == SIZE_MAX) return;
+
+    items.erase(items.begin() + index);
+}
+
+void Renderer::SetLayer(Handle handle, int layer) {
+    size_t index = Renderer::_Find(handle);
+    if (index == SIZE_MAX) return;
+
+    // re-insert so the list stays sorted, the handle is kept
+    Item item = items[index];
+    items.erase(items.begin() + index);
+    item.layer = layer;
+
+    auto position = std::upper_bound(items.begin(), items.end(), layer, [](int p_layer, const Item& other) {
+        return Renderer::_LayerBefore(p_layer, other.layer);
+    });
+    items.insert(position, item);
 }
 
 void Renderer::Clear() {
-    skyboxes.clear();
-    objects.clear();
-    textures.clear();
+    items.clear();
+}
+
+//=============================
+// RENDERING
+//=============================
+
+void Renderer::Update(const glm::mat4& camera_view_matrix, const glm::mat4& camera_projection_matrix, glm::vec3 camera_position) {
+    TF_PROFILE_SCOPE("Renderer::Update");
+    glm::mat4 camera_view_projection_matrix = camera_projection_matrix * camera_view_matrix;
+
+    for (auto& item : items) {
+        if (item.type == OBJECT_ITEM) static_cast<Object*>(item.pointer)->UpdateAll(camera_view_projection_matrix, camera_position);
+    }
 }
 
 std::vector<GLuint> Renderer::GetShaderProgramsUpdates() {
+    TF_PROFILE_SCOPE("Renderer::GetShaderProgramsUpdates");
     std::vector<GLuint> shader_programs = {};
-    for (auto& object : objects) {
-        for (const auto& object_sp : object.first.GetShaderProgramsUpdates()) {
+    for (auto& item : items) {
+        if (item.type != OBJECT_ITEM) continue;
+
+        for (const auto& object_sp : static_cast<Object*>(item.pointer)->GetShaderProgramsUpdates()) {
             shader_programs.push_back(object_sp);
         }
     }
@@ -33,54 +73,70 @@ std::vector<GLuint> Renderer::GetShaderProgramsUpdates() {
 }
 
 void Renderer::RenderAll(glm::mat4 camera_view_matrix, glm::mat4 camera_projection_matrix, glm::vec3 camera_position, std::vector<std::shared_ptr<TotalFrame::Light>> lights) {
-    // clear render queue
-    render_queue.clear();
+    TF_PROFILE_SCOPE("Renderer::RenderAll");
+    render_stats = {};
 
-    // calculate view projeciton matrix for objects
-    glm::mat4 camera_view_projection_matrix = camera_projection_matrix * camera_view_matrix;
+    // items are already in layer order
+    for (auto& item : items) {
+        switch (item.type) {
+            case SKYBOX_ITEM:
+                static_cast<Skybox*>(item.pointer)->Render(camera_view_matrix, camera_projection_matrix);
+                // one draw of the 12 triangle cube
+                render_stats.draw_calls++;
+                render_stats.triangles += 12;
+                break;
+            case OBJECT_ITEM: {
+                Object* object = static_cast<Object*>(item.pointer);
+                object->RenderAll(camera_position, lights);
 
-    // add skyboxes to render queue
-    for (auto& [skybox, layer] : skyboxes) {
-        render_queue.push_back(TotalFrame::RenderItem{
-            layer,
-            [&skybox, camera_view_matrix, camera_projection_matrix]() {
-                skybox.Render(camera_view_matrix, camera_projection_matrix);
+                TotalFrame::RenderStats object_stats = object->GetRenderStats();
+                render_stats.draw_calls += object_stats.draw_calls;
+                render_stats.triangles += object_stats.triangles;
+                break;
             }
-        });
+            case TEXTURE_ITEM:
+                static_cast<Texture*>(item.pointer)->Render();
+                break;
+        }
     }
+}
 
-    // add objects to render queue
-    for (auto& [object, layer] : objects) {
-        render_queue.push_back(TotalFrame::RenderItem{
-            layer,
-            [&object, camera_view_projection_matrix, camera_position, lights]() {
-                object.UpdateAndRenderAll(camera_view_projection_matrix, camera_position, lights);
-            }
-        });
-    }
+TotalFrame::RenderStats Renderer::GetRenderStats() const {
+    return render_stats;
+}
 
-    // add objects to render queue
-    for (auto& [texture, layer] : textures) {
-        render_queue.push_back(TotalFrame::RenderItem{
-            layer,
-            [&texture]() {
-                texture.Render();
-            }
-        });
-    }
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
 
-    // sort by layer
-    std::sort(render_queue.begin(), render_queue.end(), [](const auto& a, const auto& b) {
-        // if -1, then it should be rendered last
-        if (a.layer == -1) return false;
-        if (b.layer == -1) return true;
+Renderer::Handle Renderer::_Insert(ITEM_TYPE type, void* pointer, int layer) {
+    Item item;
+    item.handle = next_handle++;
+    item.type = type;
+    item.layer = layer;
+    item.pointer = pointer;
 
-        // otherwise, sort in ascending order
-        return a.layer < b.layer;
+    // after every item on the same layer, so ties keep the order they were added in
+    auto position = std::upper_bound(items.begin(), items.end(), layer, [](int p_layer, const Item& other) {
+        return Renderer::_LayerBefore(p_layer, other.layer);
     });
+    items.insert(position, item);
+
+    return item.handle;
+}
 
-    // render all items
-    for (const auto& item : render_queue) {
-        item.RenderFunction();
+size_t Renderer::_Find(Handle handle) const {
+    for (size_t i = 0; i < items.size(); i++) {
+        if (items[i].handle == handle) return i;
     }
-}
\ No newline at end of file
+    return SIZE_MAX;
+}
+
+bool Renderer::_LayerBefore(int a, int b) {
+    // -1 is rendered last
+    if (a == -1) return false;
+    if (b == -1) return true;
+
+    // otherwise, ascending order
+    return a < b;
+}
@@ -16,9 +16,12 @@ ShaderHandler::ShaderHandler(SDL_GLContext p_context) : context(p_context) {
 //=============================
 
 GLuint ShaderHandler::CreateShaderProgram(std::string dir_path) {
+    GLDispatch::Subsystem gl_subsystem("ShaderHandler");
     ShaderHandler::_ReadShaderSourceFolder(dir_path);
 
-    GLuint shader_program = glCreateProgram();  
+    GLProgram temp_shader_program;
+    temp_shader_program.Create();
+    GLuint shader_program = temp_shader_program.Get();
     
     // for each type of shader
     for (const auto& shader_type_sources : shaders_sources) {
@@ -26,21 +29,21 @@ GLuint ShaderHandler::CreateShaderProgram(std::string dir_path) {
         for (const auto& [type,content] : *shader_type_sources) {
             GLuint temp_shader = _CompileShader(type, content);
             // attach shader to shader program
-            glAttachShader(shader_program, temp_shader);
-            glDeleteShader(temp_shader);
+            GLDispatch::AttachShader(shader_program, temp_shader);
+            GLDispatch::DeleteShader(temp_shader);
             temp_shader = 0;
         }
     }
 
     // link shader program to gl context
-    glLinkProgram(shader_program);
+    GLDispatch::LinkProgram(shader_program);
 
     // see if successfuly linked, if not return error
     GLint successfully_linked;
-    glGetProgramiv(shader_program, GL_LINK_STATUS, &successfully_linked);
-    if (!successfully_linked) Util::ThrowError("ERROR LINKING SHADER", "ShaderHandler::CreateShaderProgram");
+    GLDispatch::GetProgramiv(shader_program, GL_LINK_STATUS, &successfully_linked);
+    if (!successfully_linked) TF_LOG_ERROR("ERROR LINKING SHADER", "ShaderHandler::CreateShaderProgram");
 
-    shader_programs.push_back(shader_program);
+    shader_programs.push_back(std::move(temp_shader_program));
 
     ShaderHandler::_ClearShaderSources();
 
@@ -66,7 +69,7 @@ void ShaderHandler::_ReadShaderSourceFolder(std::string dir_path) {
                         std::ifstream shader_source_file(shader.path());
                         // if errorw ith the file, continue
                         if (!shader_source_file.is_open()) {
-                            Util::ThrowError("INVALID SHADER SOURCE FILE", "ShaderHandler::readShaderSourceFolder");
+                            TF_LOG_ERROR("INVALID SHADER SOURCE FILE", "ShaderHandler::readShaderSourceFolder");
                             continue;
                         }
                         // gather content from file into string
@@ -85,18 +88,18 @@ void ShaderHandler::_ReadShaderSourceFolder(std::string dir_path) {
 
 GLuint ShaderHandler::_CompileShader(GLenum type, std::string source) {
     // create shader to be compiled
-    GLuint shader = glCreateShader(type);
+    GLuint shader = GLDispatch::CreateShader(type);
     // convert source to char
     const char* source_to_char = source.c_str();
     // add source to shader
-    glShaderSource(shader, 1, &source_to_char, nullptr);
+    GLDispatch::ShaderSource(shader, 1, &source_to_char, nullptr);
     // compile shader
-    glCompileShader(shader);
+    GLDispatch::CompileShader(shader);
 
     // see if successfuly compiled, if not return error
     GLint successfully_compiled;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &successfully_compiled);
-    if (!successfully_compiled) Util::ThrowError("ERROR COMPILING SHADER", "ShaderHandler::CompileShader");
+    GLDispatch::GetShaderiv(shader, GL_COMPILE_STATUS, &successfully_compiled);
+    if (!successfully_compiled) TF_LOG_ERROR("ERROR COMPILING SHADER", "ShaderHandler::CompileShader");
 
     return shader;
 }
@@ -111,8 +114,6 @@ void ShaderHandler::_ClearShaderSources() {
 // MEMORY MANAGEMENT
 //=============================
 
-ShaderHandler::~ShaderHandler() {
-    for (const auto& shader_program : shader_programs) {
-        glDeleteProgram(shader_program);
-    }
+void ShaderHandler::FreeAll() {
+    shader_programs.clear();
 }
\ No newline at end of file
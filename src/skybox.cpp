@@ -18,34 +18,36 @@ Skybox::Skybox(std::string skybox_folder_path, GLuint p_shader_program) : shader
 //=============================
 
 void Skybox::Render(const glm::mat4& view, const glm::mat4& projection) {
-    glDepthFunc(GL_LEQUAL);  // Make sure skybox passes depth test
+    GLDispatch::Subsystem gl_subsystem("Skybox");
+    GLDispatch::DepthFunc(GL_LEQUAL);  // Make sure skybox passes depth test
 
-    glUseProgram(shader_program);
+    GLDispatch::UseProgram(shader_program);
 
     glm::mat4 view_no_translation = glm::mat4(glm::mat3(view));
-    glUniformMatrix4fv(glGetUniformLocation(shader_program, "view"), 1, GL_FALSE, glm::value_ptr(view_no_translation));
-    glUniformMatrix4fv(glGetUniformLocation(shader_program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
+    GLDispatch::UniformMatrix4fv(GLDispatch::GetUniformLocation(shader_program, "view"), 1, GL_FALSE, glm::value_ptr(view_no_translation));
+    GLDispatch::UniformMatrix4fv(GLDispatch::GetUniformLocation(shader_program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
 
-    glBindVertexArray(vertex_array);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap_texture);
+    GLDispatch::BindVertexArray(vertex_array.Get());
+    GLDispatch::BindTexture(GL_TEXTURE_CUBE_MAP, cubemap_texture.Get());
 
-    glDrawArrays(GL_TRIANGLES, 0, 36);
+    GLDispatch::DrawArrays(GL_TRIANGLES, 0, 36);
 
-    glBindVertexArray(0);
-    glDepthFunc(GL_LESS);  // Reset to default
+    GLDispatch::BindVertexArray(0);
+    GLDispatch::DepthFunc(GL_LESS);  // Reset to default
 }
 
 void Skybox::Build() {
+    GLDispatch::Subsystem gl_subsystem("Skybox");
     // generate array and buffer
-    glGenVertexArrays(1, &vertex_array);
-    glGenBuffers(1, &vertex_buffer);
-
-    glBindVertexArray(vertex_array);
-    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
-    glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
-    glBindVertexArray(0);
+    vertex_array.Create();
+    vertex_buffer.Create();
+
+    GLDispatch::BindVertexArray(vertex_array.Get());
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, vertex_buffer.Get());
+    GLDispatch::BufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+    GLDispatch::EnableVertexAttribArray(0);
+    GLDispatch::VertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), (void*)0);
+    GLDispatch::BindVertexArray(0);
 }
 
 //=============================
@@ -53,9 +55,9 @@ void Skybox::Build() {
 //=============================
 
 void Skybox::FreeAll() {
-    glDeleteVertexArrays(1, &vertex_array);
-    glDeleteBuffers(1, &vertex_buffer);
-    glDeleteTextures(1, &cubemap_texture);   
+    vertex_array.Reset();
+    vertex_buffer.Reset();
+    cubemap_texture.Reset();
 }
 
 //=============================
@@ -80,7 +82,7 @@ void Skybox::_LoadPaths(std::string skybox_folder_path) {
 
         // if the full path does not exist, something has gone wrong, return
         if (!std::filesystem::exists(full_path)) {
-            Util::ThrowError("FAILED TO LOAD SKYBOX TEXTURE: " + full_path, "Skybox::_LoadPaths");
+            TF_LOG_ERROR("FAILED TO LOAD SKYBOX TEXTURE: " + full_path, "Skybox::_LoadPaths");
             return;
         }
 
@@ -89,9 +91,10 @@ void Skybox::_LoadPaths(std::string skybox_folder_path) {
 }
 
 void Skybox::_LoadCubeMap() {
+    GLDispatch::Subsystem gl_subsystem("Skybox");
     // generate texture
-    glGenTextures(1, &cubemap_texture);
-    glBindTexture(GL_TEXTURE_CUBE_MAP, cubemap_texture);
+    cubemap_texture.Create();
+    GLDispatch::BindTexture(GL_TEXTURE_CUBE_MAP, cubemap_texture.Get());
 
     int width, height, nrChannels;
     stbi_set_flip_vertically_on_load(false); // don't flip
@@ -102,7 +105,7 @@ void Skybox::_LoadCubeMap() {
 
         // if data is invalid, break and throw error
         if (!data) {
-            Util::ThrowError("FAILED TO LOAD TEXTURE: " + faces_paths[i], "Skybox::_LoadCubeMap");
+            TF_LOG_ERROR("FAILED TO LOAD TEXTURE: " + faces_paths[i], "Skybox::_LoadCubeMap");
             continue;
         }
 
@@ -110,7 +113,7 @@ void Skybox::_LoadCubeMap() {
         GLenum color_format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
 
         // load each texture
-        glTexImage2D(
+        GLDispatch::TexImage2D(
             GL_TEXTURE_CUBE_MAP_POSITIVE_X + i,
             0, GL_RGB, width, height, 0, color_format, GL_UNSIGNED_BYTE, data
         );
@@ -119,11 +122,11 @@ void Skybox::_LoadCubeMap() {
     }
 
     // set paremeters for cube map
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+    GLDispatch::TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    GLDispatch::TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GLDispatch::TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    GLDispatch::TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLDispatch::TexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
 }
 
 void Skybox::_CreateVertices() {
@@ -0,0 +1,351 @@
+#include "StatsHud.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+StatsHud::StatsHud(GLuint p_shader_program, Uint16 screen_width, Uint16 screen_height, float font_size) : shader_program(p_shader_program), screen_size(float(screen_width), float(screen_height)) {
+    std::string font_path = StatsHud::_FindFont();
+    if (font_path.empty()) {
+        TF_LOG_ERROR("NO FONT FOUND, STATS HUD DISABLED", "StatsHud::StatsHud");
+        return;
+    }
+
+    enabled = StatsHud::_BuildAtlas(font_path, font_size);
+    if (enabled) StatsHud::_Build();
+}
+
+//=============================
+// TIMINGS
+//=============================
+
+void StatsHud::AddFrameTime(double milliseconds) {
+    frame_times[total_frame_times % FRAME_SAMPLES] = milliseconds;
+    total_frame_times++;
+}
+
+void StatsHud::SetSaveTime(double milliseconds) {
+    save_time = milliseconds;
+}
+
+//=============================
+// RENDERING
+//=============================
+
+bool StatsHud::IsEnabled() const {
+    return enabled;
+}
+
+void StatsHud::Render(const TotalFrame::RenderStats& render_stats, const Object::CullStats& cull_stats, double pick_time) {
+    GLDispatch::Subsystem gl_subsystem("StatsHud");
+    if (!enabled || !visible) return;
+
+    //// TEXT
+    std::vector<double> sorted_times(frame_times.begin(), frame_times.begin() + std::min(total_frame_times, FRAME_SAMPLES));
+    std::sort(sorted_times.begin(), sorted_times.end());
+
+    char line[160];
+    std::vector<std::string> lines = {};
+
+    if (sorted_times.empty()) {
+        lines.push_back("FRAME   --");
+    } else {
+        std::snprintf(line, sizeof(line), "FRAME   p50 %.2f ms  p95 %.2f ms  p99 %.2f ms  max %.2f ms", Util::GetPercentile(sorted_times, 0.50), Util::GetPercentile(sorted_times, 0.95), Util::GetPercentile(sorted_times, 0.99), sorted_times.back());
+        lines.push_back(line);
+    }
+
+    std::snprintf(line, sizeof(line), "DRAWS   %zu calls  %zu triangles", render_stats.draw_calls, render_stats.triangles);
+    lines.push_back(line);
+    const GLDispatch::FrameStats& gl_stats = GLDispatch::GetLastFrameStats();
+    std::snprintf(line, sizeof(line), "GL      %llu calls  %llu draws  %.1f KB uploaded", (unsigned long long)gl_stats.total_calls, (unsigned long long)gl_stats.draw_calls, gl_stats.bytes_uploaded / 1024.0);
+    lines.push_back(line);
+    for (const auto& gl_subsystem_stats : GLDispatch::GetLastFrameSubsystems()) {
+        std::snprintf(line, sizeof(line), "  %-12s %llu calls  %.1f KB", gl_subsystem_stats.name, (unsigned long long)gl_subsystem_stats.total_calls, gl_subsystem_stats.bytes_uploaded / 1024.0);
+        lines.push_back(line);
+    }
+
+    // the most frequent call types, ties in enum order
+    std::array<GLDispatch::CALL, GLDispatch::TOTAL_CALLS> calls;
+    for (int i = 0; i < GLDispatch::TOTAL_CALLS; i++) {
+        calls[i] = GLDispatch::CALL(i);
+    }
+    const size_t total_top_calls = std::min<size_t>(TOP_GL_CALLS, calls.size());
+    std::partial_sort(calls.begin(), calls.begin() + total_top_calls, calls.end(), [&gl_stats](GLDispatch::CALL a, GLDispatch::CALL b) {
+        return gl_stats.calls[a] > gl_stats.calls[b] || (gl_stats.calls[a] == gl_stats.calls[b] && a < b);
+    });
+    std::string top_text = "  TOP   ";
+    for (size_t i = 0; i < total_top_calls && gl_stats.calls[calls[i]] > 0; i++) {
+        top_text += std::string(" ") + GLDispatch::GetCallName(calls[i]) + " " + std::to_string(gl_stats.calls[calls[i]]);
+    }
+    lines.push_back(top_text);
+    std::snprintf(line, sizeof(line), "CUBES   %zu total  %zu in frustum  %zu drawn", cull_stats.total_cubes, cull_stats.frustum_visible_cubes, cull_stats.occlusion_visible_cubes);
+    lines.push_back(line);
+    std::snprintf(line, sizeof(line), "PICK    %.3f ms", pick_time);
+    lines.push_back(line);
+
+    std::string save_text = save_time < 0.0 ? "--" : std::to_string(int(save_time + 0.5)) + " ms";
+    lines.push_back("SAVE    " + save_text);
+
+    //// QUADS
+    vertices.clear();
+
+    // panel first so the text blends over it
+    const float padding = 8.0f;
+    float panel_width = 0.0f;
+    for (const auto& text : lines) {
+        panel_width = std::max(panel_width, StatsHud::_GetTextWidth(text));
+    }
+    glm::vec2 panel_size = glm::vec2(panel_width, line_height * lines.size()) + 2.0f * padding;
+    StatsHud::_AppendQuad(glm::vec2(0.0f), panel_size, white_uv, white_uv, 0xB0000000);
+
+    // slow frames (under 30 fps at p99) turn the frame line red
+    bool slow = !sorted_times.empty() && Util::GetPercentile(sorted_times, 0.99) > 33.3;
+    for (size_t i = 0; i < lines.size(); i++) {
+        Uint32 color = (i == 0 && slow) ? 0xFF5050FF : 0xFFFFFFFF;
+        StatsHud::_AppendText(lines[i], glm::vec2(padding, padding + line_height * i), color);
+    }
+
+    //// DRAW
+    // last frame's vertices are orphaned rather than waited on
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, vertex_buffer.Get());
+    GLDispatch::BufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(HudVertex), vertices.data(), GL_STREAM_DRAW);
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+
+    GLDispatch::Disable(GL_DEPTH_TEST);
+    GLDispatch::Disable(GL_CULL_FACE);
+
+    GLDispatch::UseProgram(shader_program);
+    GLDispatch::Uniform2fv(GLDispatch::GetUniformLocation(shader_program, "screen_size"), 1, glm::value_ptr(screen_size));
+    GLDispatch::Uniform1i(GLDispatch::GetUniformLocation(shader_program, "atlas"), 0);
+
+    GLDispatch::ActiveTexture(GL_TEXTURE0);
+    GLDispatch::BindTexture(GL_TEXTURE_2D, atlas_texture.Get());
+
+    GLDispatch::BindVertexArray(vertex_array.Get());
+    GLDispatch::DrawArrays(GL_TRIANGLES, 0, vertices.size());
+    GLDispatch::BindVertexArray(0);
+
+    GLDispatch::BindTexture(GL_TEXTURE_2D, 0);
+
+    GLDispatch::Enable(GL_CULL_FACE);
+    GLDispatch::Enable(GL_DEPTH_TEST);
+}
+
+//=============================
+// MEMORY MANAGEMENT
+//=============================
+
+void StatsHud::FreeAll() {
+    atlas_texture.Reset();
+    vertex_buffer.Reset();
+    vertex_array.Reset();
+    enabled = false;
+}
+
+//=============================
+// ATLAS FUNCTIONS
+//=============================
+
+std::string StatsHud::_FindFont() {
+    // bundled fonts win, sorted so the pick does not depend on directory order
+    std::vector<std::string> bundled_fonts = {};
+    std::error_code error;
+    for (const auto& entry : std::filesystem::directory_iterator("res/fonts", error)) {
+        std::string extension = entry.path().extension().string();
+        if (extension == ".ttf" || extension == ".otf") bundled_fonts.push_back(entry.path().string());
+    }
+    std::sort(bundled_fonts.begin(), bundled_fonts.end());
+    if (!bundled_fonts.empty()) return bundled_fonts.front();
+
+    static const std::array<const char*, 7> system_fonts = {
+        "C:/Windows/Fonts/consola.ttf",
+        "C:/Windows/Fonts/cour.ttf",
+        "C:/Windows/Fonts/arial.ttf",
+        "/usr/share/fonts/truetype/dejavu/DejaVuSansMono.ttf",
+        "/usr/share/fonts/TTF/DejaVuSansMono.ttf",
+        "/usr/share/fonts/truetype/liberation/LiberationMono-Regular.ttf",
+        "/System/Library/Fonts/Supplemental/Courier New.ttf"
+    };
+    for (const char* path : system_fonts) {
+        if (std::filesystem::exists(path, error)) return path;
+    }
+    return "";
+}
+
+bool StatsHud::_BuildAtlas(const std::string& font_path, float font_size) {
+    GLDispatch::Subsystem gl_subsystem("StatsHud");
+    TTF_Font* font = TTF_OpenFont(font_path.c_str(), font_size);
+    if (font == nullptr) {
+        TF_LOG_ERROR("FONT COULD NOT BE OPENED, STATS HUD DISABLED", "StatsHud::_BuildAtlas");
+        return false;
+    }
+    line_height = float(TTF_GetFontHeight(font));
+
+    struct GlyphImage {
+        int width = 0;
+        int height = 0;
+        // coverage, one byte per pixel
+        std::vector<Uint8> coverage = {};
+    };
+    std::array<GlyphImage, LAST_GLYPH - FIRST_GLYPH + 1> images = {};
+
+    for (Uint32 character = FIRST_GLYPH; character <= LAST_GLYPH; character++) {
+        GlyphImage& image = images[character - FIRST_GLYPH];
+
+        SDL_Surface* surface = TTF_RenderGlyph_Blended(font, character, {255, 255, 255, 255});
+        SDL_Surface* converted = surface != nullptr ? SDL_ConvertSurface(surface, SDL_PIXELFORMAT_RGBA32) : nullptr;
+        if (surface != nullptr) SDL_DestroySurface(surface);
+
+        // glyphs with nothing to draw (space) still advance
+        if (converted == nullptr) {
+            int min_x, max_x, min_y, max_y, advance = 0;
+            TTF_GetGlyphMetrics(font, character, &min_x, &max_x, &min_y, &max_y, &advance);
+            image.width = advance;
+            image.height = int(line_height);
+            continue;
+        }
+
+        image.width = converted->w;
+        image.height = converted->h;
+        image.coverage.resize(size_t(image.width) * image.height);
+        for (int y = 0; y < image.height; y++) {
+            const Uint8* row = static_cast<const Uint8*>(converted->pixels) + size_t(y) * converted->pitch;
+            for (int x = 0; x < image.width; x++) {
+                image.coverage[size_t(y) * image.width + x] = row[x * 4 + 3];
+            }
+        }
+        SDL_DestroySurface(converted);
+    }
+    TTF_CloseFont(font);
+
+    //// PACKING
+    // shelves left to right, the opaque block takes the first spot
+    const int white_size = 4;
+    int pen_x = white_size + 1;
+    int pen_y = 0;
+    int shelf_height = white_size;
+    std::array<glm::ivec2, LAST_GLYPH - FIRST_GLYPH + 1> origins = {};
+
+    for (size_t i = 0; i < images.size(); i++) {
+        if (images[i].coverage.empty()) continue;
+        if (pen_x + images[i].width > ATLAS_WIDTH) {
+            pen_x = 0;
+            pen_y += shelf_height + 1;
+            shelf_height = 0;
+        }
+        origins[i] = glm::ivec2(pen_x, pen_y);
+        pen_x += images[i].width + 1;
+        shelf_height = std::max(shelf_height, images[i].height);
+    }
+    int atlas_height = pen_y + shelf_height;
+
+    std::vector<Uint8> atlas(size_t(ATLAS_WIDTH) * atlas_height, 0);
+    for (int y = 0; y < white_size; y++) {
+        std::fill_n(atlas.begin() + size_t(y) * ATLAS_WIDTH, white_size, Uint8(255));
+    }
+
+    glm::vec2 atlas_size = glm::vec2(ATLAS_WIDTH, atlas_height);
+    white_uv = glm::vec2(white_size * 0.5f) / atlas_size;
+
+    for (size_t i = 0; i < images.size(); i++) {
+        const GlyphImage& image = images[i];
+        Glyph& glyph = glyphs[i];
+        glyph.size = glm::vec2(image.width, image.height);
+        if (image.coverage.empty()) continue;
+
+        for (int y = 0; y < image.height; y++) {
+            std::copy_n(image.coverage.begin() + size_t(y) * image.width, image.width, atlas.begin() + size_t(origins[i].y + y) * ATLAS_WIDTH + origins[i].x);
+        }
+        glyph.uv_min = glm::vec2(origins[i]) / atlas_size;
+        glyph.uv_max = glm::vec2(origins[i] + glm::ivec2(image.width, image.height)) / atlas_size;
+    }
+
+    //// UPLOAD
+    atlas_texture.Create();
+    GLDispatch::BindTexture(GL_TEXTURE_2D, atlas_texture.Get());
+    GLDispatch::PixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GLDispatch::TexImage2D(GL_TEXTURE_2D, 0, GL_R8, ATLAS_WIDTH, atlas_height, 0, GL_RED, GL_UNSIGNED_BYTE, atlas.data());
+    GLDispatch::PixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // glyphs are drawn at their rasterized size, so no filtering or mipmaps
+    GLDispatch::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    GLDispatch::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    GLDispatch::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    GLDispatch::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    GLDispatch::BindTexture(GL_TEXTURE_2D, 0);
+
+    return true;
+}
+
+void StatsHud::_Build() {
+    GLDispatch::Subsystem gl_subsystem("StatsHud");
+    vertex_array.Create();
+    vertex_buffer.Create();
+
+    GLDispatch::BindVertexArray(vertex_array.Get());
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, vertex_buffer.Get());
+
+    // position (pixels), uv, color
+    GLDispatch::VertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (GLvoid*)offsetof(HudVertex, position));
+    GLDispatch::EnableVertexAttribArray(0);
+    GLDispatch::VertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(HudVertex), (GLvoid*)offsetof(HudVertex, uv));
+    GLDispatch::EnableVertexAttribArray(1);
+    GLDispatch::VertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(HudVertex), (GLvoid*)offsetof(HudVertex, color));
+    GLDispatch::EnableVertexAttribArray(2);
+
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLDispatch::BindVertexArray(0);
+}
+
+//=============================
+// TEXT FUNCTIONS
+//=============================
+
+void StatsHud::_AppendQuad(glm::vec2 position, glm::vec2 size, glm::vec2 uv_min, glm::vec2 uv_max, Uint32 color) {
+    HudVertex corners[4];
+    corners[0].position = position;
+    corners[0].uv = uv_min;
+    corners[1].position = glm::vec2(position.x + size.x, position.y);
+    corners[1].uv = glm::vec2(uv_max.x, uv_min.y);
+    corners[2].position = position + size;
+    corners[2].uv = uv_max;
+    corners[3].position = glm::vec2(position.x, position.y + size.y);
+    corners[3].uv = glm::vec2(uv_min.x, uv_max.y);
+
+    for (auto& corner : corners) {
+        for (int channel = 0; channel < 4; channel++) {
+            corner.color[channel] = GLubyte((color >> (channel * 8)) & 0xFF);
+        }
+    }
+
+    for (int corner : {0, 1, 2, 0, 2, 3}) {
+        vertices.push_back(corners[corner]);
+    }
+}
+
+float StatsHud::_AppendText(const std::string& text, glm::vec2 position, Uint32 color) {
+    float pen_x = position.x;
+    for (char character : text) {
+        Uint32 code = Uint32(Uint8(character));
+        if (code < FIRST_GLYPH || code > LAST_GLYPH) code = '?';
+
+        const Glyph& glyph = glyphs[code - FIRST_GLYPH];
+        if (glyph.uv_max != glyph.uv_min) StatsHud::_AppendQuad(glm::vec2(pen_x, position.y), glyph.size, glyph.uv_min, glyph.uv_max, color);
+        pen_x += glyph.size.x;
+    }
+    return pen_x - position.x;
+}
+
+float StatsHud::_GetTextWidth(const std::string& text) const {
+    float width = 0.0f;
+    for (char character : text) {
+        Uint32 code = Uint32(Uint8(character));
+        if (code < FIRST_GLYPH || code > LAST_GLYPH) code = '?';
+        width += glyphs[code - FIRST_GLYPH].size.x;
+    }
+    return width;
+}
@@ -7,37 +7,34 @@ Texture::Texture(std::string path) {
     Texture::Build(path);
 }
 
-Texture::~Texture() {
-    glDeleteTextures(1, &id);
-}
-
 void Texture::Build(std::string path) {
+    GLDispatch::Subsystem gl_subsystem("Texture");
     // generate id of texture
-    glGenTextures(1, &id);
-    glBindTexture(GL_TEXTURE_2D, id);
+    id.Create();
+    GLDispatch::BindTexture(GL_TEXTURE_2D, id.Get());
 
     // set filtering style
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    GLDispatch::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    GLDispatch::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
     // set wrapping style
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    GLDispatch::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    GLDispatch::TexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
 
     // load image
     stbi_set_flip_vertically_on_load(true);
     unsigned char* data = stbi_load(path.c_str(), &width, &height, &channels, 0);
 
     // load data
-    if (!data) Util::ThrowError("INCORRECT PATH PROVIDED", "Texture::Build");
+    if (!data) TF_LOG_ERROR("INCORRECT PATH PROVIDED", "Texture::Build");
     else {
         GLenum format = channels == 4 ? GL_RGBA : GL_RGB;
-        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
-        glGenerateMipmap(GL_TEXTURE_2D);
+        GLDispatch::TexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, data);
+        GLDispatch::GenerateMipmap(GL_TEXTURE_2D);
     } 
 
     // free data and init bind texture
     stbi_image_free(data);
-    glBindTexture(GL_TEXTURE_2D, 0);
+    GLDispatch::BindTexture(GL_TEXTURE_2D, 0);
 }
 
 void Texture::Render() {
@@ -45,6 +42,7 @@ void Texture::Render() {
 }
 
 void Texture::Bind(int unit) {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D, id);
+    GLDispatch::Subsystem gl_subsystem("Texture");
+    GLDispatch::ActiveTexture(GL_TEXTURE0 + unit);
+    GLDispatch::BindTexture(GL_TEXTURE_2D, id.Get());
 }
\ No newline at end of file
@@ -4,9 +4,9 @@
 // DEFAULT CONSTRUCTOR
 //=============================
 
-Triangle::Triangle(std::vector<GLfloat> p_vertices) {
-    Triangle::LoadVertices(p_vertices);
-    Triangle::Build();
+Triangle::Triangle(std::vector<GLfloat> p_vertices, float p_position_scale) {
+    // GL work waits for the first Render(), so triangles can be made without a context
+    Triangle::LoadVertices(p_vertices, p_position_scale);
 }
 
 //=============================
@@ -14,66 +14,80 @@ Triangle::Triangle(std::vector<GLfloat> p_vertices) {
 //=============================
 
 bool Triangle::Verify() {
-    if (vertex_array == 0 || vertex_buffer == 0) return false;
+    if (!vertex_array || !vertex_buffer) return false;
     return true;
 }
 
-void Triangle::LoadVertices(std::vector<GLfloat> p_vertices) {
-    vertices = std::make_shared<TF_TRIANGLE_VERTICES>();
-    full_vertices = std::make_shared<TF_TRIANGLE_VERTICES_WITH_NORMAL>();
-    normal = glm::vec3(0.0f);
+void Triangle::LoadVertices(std::vector<GLfloat> p_vertices, float p_position_scale) {
+    vertices = {};
+    if (p_vertices.size() != 18) return;
 
-    if (p_vertices.size() == 18) {
-        std::copy(p_vertices.begin(), p_vertices.end(), vertices->begin());
-        Triangle::UpdateFullVertices();
-    }
+    // no scale given, fit the scale to this triangle
+    if (p_position_scale <= 0.0f) p_position_scale = Triangle::GetPositionScale({p_vertices});
+
+    position_scale = p_position_scale;
+    Triangle::PackVertices(p_vertices.data(), position_scale, vertices.data());
+    upload_needed = true;
 }
 
 void Triangle::Build() {
-    glGenVertexArrays(1, &vertex_array);
-    glGenBuffers(1, &vertex_buffer);
+    GLDispatch::Subsystem gl_subsystem("Triangle");
+    upload_needed = false;
+
+    // already built, just upload the new vertices
+    if (vertex_buffer) {
+        GLDispatch::BindBuffer(GL_ARRAY_BUFFER, vertex_buffer.Get());
+        GLDispatch::BufferSubData(GL_ARRAY_BUFFER, 0, sizeof(vertices), vertices.data());
+        GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+
+    vertex_array.Create();
+    vertex_buffer.Create();
 
-    glBindVertexArray(vertex_array);
+    GLDispatch::BindVertexArray(vertex_array.Get());
     
-    glBindBuffer(GL_ARRAY_BUFFER, vertex_buffer);
-    glBufferData(GL_ARRAY_BUFFER, full_vertices->size() * sizeof(GLfloat), full_vertices->data(), GL_STATIC_DRAW);
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, vertex_buffer.Get());
+    GLDispatch::BufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices.data(), GL_STATIC_DRAW);
 
-    GLsizei stride = 9 * sizeof(GLfloat);
+    GLsizei stride = sizeof(TotalFrame::PackedVertex);
 
-    // Position
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(0));
-    glEnableVertexAttribArray(0);
+    // Position + face index (w), quantized
+    GLDispatch::VertexAttribPointer(0, 4, GL_SHORT, GL_FALSE, stride, (GLvoid*)(offsetof(TotalFrame::PackedVertex, position)));
+    GLDispatch::EnableVertexAttribArray(0);
 
     // Color
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(3 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(1);
-
-    // Normal
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (GLvoid*)(6 * sizeof(GLfloat)));
-    glEnableVertexAttribArray(2);
+    GLDispatch::VertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)(offsetof(TotalFrame::PackedVertex, color)));
+    GLDispatch::EnableVertexAttribArray(1);
     
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+    GLDispatch::BindVertexArray(0);
 }
 
 void Triangle::Render() {
-    glBindVertexArray(vertex_array);
-    glDrawArrays(GL_TRIANGLES, 0, 3);  // Draw the triangle (filled)
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLDispatch::Subsystem gl_subsystem("Triangle");
+    if (upload_needed) Triangle::Build();
+
+    GLDispatch::BindVertexArray(vertex_array.Get());
+    GLDispatch::DrawArrays(GL_TRIANGLES, 0, 3);  // Draw the triangle (filled)
+    GLDispatch::BindVertexArray(0);
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 void Triangle::RenderOutline() {
-    glBindVertexArray(vertex_array);
-    glDrawArrays(GL_LINE_LOOP, 0, 3);
-    glBindVertexArray(0);
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLDispatch::Subsystem gl_subsystem("Triangle");
+    if (upload_needed) Triangle::Build();
+
+    GLDispatch::BindVertexArray(vertex_array.Get());
+    GLDispatch::DrawArrays(GL_LINE_LOOP, 0, 3);
+    GLDispatch::BindVertexArray(0);
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
 }
 
 std::string Triangle::GetData() {
     std::string temp_data = "";
 
-    for (auto& vertice : (*vertices)) {
+    for (auto& vertice : Triangle::GetVertices()) {
         temp_data += std::to_string(vertice);
         temp_data += ' ';
     }
@@ -83,32 +97,43 @@ std::string Triangle::GetData() {
     return temp_data;
 }
 
+TF_TRIANGLE_VERTICES Triangle::GetVertices() const {
+    TF_TRIANGLE_VERTICES temp_vertices = {};
+    Triangle::UnpackVertices(vertices.data(), position_scale, temp_vertices.data());
+    return temp_vertices;
+}
+
+float Triangle::GetPositionScale() const {
+    return position_scale;
+}
+
 //=============================
 // EXPORTATION FUNCTIONS
 //=============================
 
 void Triangle::Translate(glm::vec3 translation) {
-    std::string temp_data = "";
+    TF_TRIANGLE_VERTICES temp_vertices = Triangle::GetVertices();
 
     int stride = 6;
     for (int i = 0; i < 3; i++) {
         int index = i * stride;
-        
-        (*vertices)[index + 0] += translation.x;
-        (*vertices)[index + 1] += translation.y;
-        (*vertices)[index + 2] += translation.z;
+
+        temp_vertices[index + 0] += translation.x;
+        temp_vertices[index + 1] += translation.y;
+        temp_vertices[index + 2] += translation.z;
     }
 
-    Triangle::UpdateFullVertices();
+    Triangle::PackVertices(temp_vertices.data(), position_scale, vertices.data());
 }
 
-std::vector<glm::vec3> Triangle::GetPositions() {
+std::vector<glm::vec3> Triangle::GetPositions() const {
     std::vector<glm::vec3> temp_positions = {};
-    int stride = 6;
     for (int i = 0; i < 3; i++) {
-        int index = i * stride;
-        
-        temp_positions.push_back(glm::vec3((*vertices)[index + 0], (*vertices)[index + 1], (*vertices)[index + 2]));
+        temp_positions.push_back(glm::vec3(
+            Triangle::DequantizePosition(vertices[i].position[0], position_scale),
+            Triangle::DequantizePosition(vertices[i].position[1], position_scale),
+            Triangle::DequantizePosition(vertices[i].position[2], position_scale)
+        ));
     }
     return temp_positions;
 }
@@ -118,64 +143,109 @@ std::vector<glm::vec3> Triangle::GetPositions() {
 //=============================
 
 glm::vec3 Triangle::GetNormal() {
-    Triangle::UpdateNormal();
-    return normal;
+    std::vector<glm::vec3> points = Triangle::GetPositions();
+    return glm::normalize(glm::cross(points[1] - points[0], points[2] - points[0]));
 }
 
-void Triangle::UpdateNormal() {
-    glm::vec3 point_1 = glm::vec3((*vertices)[0], (*vertices)[1], (*vertices)[2]);
-    glm::vec3 point_2 = glm::vec3((*vertices)[6], (*vertices)[7], (*vertices)[8]);
-    glm::vec3 point_3 = glm::vec3((*vertices)[12], (*vertices)[13], (*vertices)[14]);
-    normal = glm::normalize(glm::cross(point_2 - point_1, point_3 - point_1));
+TotalFrame::FACE Triangle::GetFace() const {
+    return TotalFrame::FACE(vertices[0].position[3]);
 }
 
-void Triangle::UpdateFullVertices() {
-    Triangle::UpdateNormal();
+TotalFrame::FACE Triangle::GetFaceFromNormal(glm::vec3 normal) {
+    glm::vec3 magnitude = glm::abs(normal);
 
-    int v_stride = 6; // vertices/true_vertices stride
-    int f_stride = 9; // full_vertices stride
-
-    for (int i = 0; i < 3; i++) {
-        int v_idx = i * v_stride;
-        int f_idx = i * f_stride;
-
-        // Position
-        (*full_vertices)[f_idx + 0] = (*vertices)[v_idx + 0];
-        (*full_vertices)[f_idx + 1] = (*vertices)[v_idx + 1];
-        (*full_vertices)[f_idx + 2] = (*vertices)[v_idx + 2];
-
-        // Color
-        (*full_vertices)[f_idx + 3] = (*vertices)[v_idx + 3];
-        (*full_vertices)[f_idx + 4] = (*vertices)[v_idx + 4];
-        (*full_vertices)[f_idx + 5] = (*vertices)[v_idx + 5];
-
-        // Normal
-        (*full_vertices)[f_idx + 6] = normal.x;
-        (*full_vertices)[f_idx + 7] = normal.y;
-        (*full_vertices)[f_idx + 8] = normal.z;
-    }
+    // pick the dominant axis, then its sign
+    if (magnitude.x >= magnitude.y && magnitude.x >= magnitude.z) return normal.x >= 0.0f ? TotalFrame::FACE_POSITIVE_X : TotalFrame::FACE_NEGATIVE_X;
+    if (magnitude.y >= magnitude.z) return normal.y >= 0.0f ? TotalFrame::FACE_POSITIVE_Y : TotalFrame::FACE_NEGATIVE_Y;
+    return normal.z >= 0.0f ? TotalFrame::FACE_POSITIVE_Z : TotalFrame::FACE_NEGATIVE_Z;
 }
+
 //=============================
 // COLOR FUNCTIONS
 //=============================
 
 void Triangle::SetColor(glm::vec3 color) {
+    for (auto& vertex : vertices) {
+        vertex.color[0] = Triangle::QuantizeColor(color.r);
+        vertex.color[1] = Triangle::QuantizeColor(color.g);
+        vertex.color[2] = Triangle::QuantizeColor(color.b);
+    }
+
+    // the existing buffer is updated in place on the next Render()
+    upload_needed = true;
+}
+
+glm::vec3 Triangle::GetColor() {
+    return glm::vec3(vertices[0].color[0], vertices[0].color[1], vertices[0].color[2]) / 255.0f;
+}
+
+//=============================
+// PACKING FUNCTIONS
+//=============================
+
+void Triangle::PackVertices(const GLfloat* p_vertices, float p_position_scale, TotalFrame::PackedVertex* vertices_out) {
+    std::array<glm::vec3, 3> positions;
     int stride = 6;
     for (int i = 0; i < 3; i++) {
-        int index = i * stride + 3; // +3 skips past x,y,z to get to r,g,b
-        
-        (*vertices)[index + 0] = color.r;
-        (*vertices)[index + 1] = color.g;
-        (*vertices)[index + 2] = color.b;
+        positions[i] = glm::vec3(p_vertices[i * stride + 0], p_vertices[i * stride + 1], p_vertices[i * stride + 2]);
     }
 
-    Triangle::UpdateFullVertices();
+    // the face comes from the unquantized positions so tiny triangles keep their normal
+    glm::vec3 normal = glm::cross(positions[1] - positions[0], positions[2] - positions[0]);
+    GLshort face = GLshort(Triangle::GetFaceFromNormal(normal));
+
+    for (int i = 0; i < 3; i++) {
+        int index = i * stride;
+
+        vertices_out[i].position[0] = Triangle::QuantizePosition(p_vertices[index + 0], p_position_scale);
+        vertices_out[i].position[1] = Triangle::QuantizePosition(p_vertices[index + 1], p_position_scale);
+        vertices_out[i].position[2] = Triangle::QuantizePosition(p_vertices[index + 2], p_position_scale);
+        vertices_out[i].position[3] = face;
 
-    Triangle::Build();
+        vertices_out[i].color[0] = Triangle::QuantizeColor(p_vertices[index + 3]);
+        vertices_out[i].color[1] = Triangle::QuantizeColor(p_vertices[index + 4]);
+        vertices_out[i].color[2] = Triangle::QuantizeColor(p_vertices[index + 5]);
+        vertices_out[i].color[3] = 255;
+    }
 }
 
-glm::vec3 Triangle::GetColor() {
-    return glm::vec3((*vertices)[3],(*vertices)[4],(*vertices)[5]);
+void Triangle::UnpackVertices(const TotalFrame::PackedVertex* p_vertices, float p_position_scale, GLfloat* vertices_out) {
+    int stride = 6;
+    for (int i = 0; i < 3; i++) {
+        int index = i * stride;
+
+        vertices_out[index + 0] = Triangle::DequantizePosition(p_vertices[i].position[0], p_position_scale);
+        vertices_out[index + 1] = Triangle::DequantizePosition(p_vertices[i].position[1], p_position_scale);
+        vertices_out[index + 2] = Triangle::DequantizePosition(p_vertices[i].position[2], p_position_scale);
+
+        vertices_out[index + 3] = p_vertices[i].color[0] / 255.0f;
+        vertices_out[index + 4] = p_vertices[i].color[1] / 255.0f;
+        vertices_out[index + 5] = p_vertices[i].color[2] / 255.0f;
+    }
+}
+
+float Triangle::GetPositionScale(const std::vector<std::vector<GLfloat>>& triangles_vertices) {
+    float temp_position_scale = 0.0f;
+    for (const auto& triangle_vertices : triangles_vertices) {
+        for (size_t i = 0; i + 2 < triangle_vertices.size(); i += 6) {
+            temp_position_scale = std::max({temp_position_scale, std::fabs(triangle_vertices[i]), std::fabs(triangle_vertices[i + 1]), std::fabs(triangle_vertices[i + 2])});
+        }
+    }
+    return temp_position_scale > 0.0f ? temp_position_scale : 1.0f;
+}
+
+GLshort Triangle::QuantizePosition(float value, float p_position_scale) {
+    float quantized = std::round(value / p_position_scale * TotalFrame::POSITION_QUANTIZATION);
+    return GLshort(glm::clamp(quantized, -TotalFrame::POSITION_QUANTIZATION, TotalFrame::POSITION_QUANTIZATION));
+}
+
+float Triangle::DequantizePosition(GLshort value, float p_position_scale) {
+    // divide first so +-POSITION_QUANTIZATION gives back exactly +-position_scale
+    return float(value) / TotalFrame::POSITION_QUANTIZATION * p_position_scale;
+}
+
+GLubyte Triangle::QuantizeColor(float value) {
+    return GLubyte(std::round(glm::clamp(value, 0.0f, 1.0f) * 255.0f));
 }
 
 //=============================
@@ -183,8 +253,6 @@ glm::vec3 Triangle::GetColor() {
 //=============================
 
 void Triangle::FreeAll() {
-    glDeleteVertexArrays(1, &vertex_array);
-    glDeleteBuffers(1, &vertex_buffer);
-    vertex_array = 0;
-    vertex_buffer = 0;
-}
\ No newline at end of file
+    vertex_array.Reset();
+    vertex_buffer.Reset();
+}
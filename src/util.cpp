@@ -1,4 +1,7 @@
 #include "Util.h"
+#include "GLDispatch.h"
+
+#include <algorithm>
 
 //=============================
 // RECT CENTERING
@@ -29,30 +32,28 @@ std::array<float, 2> Util::Normalize(std::array<float, 2> velocity) {
     return normalized_velocity;
 }
 
+double Util::GetPercentile(const std::vector<double>& sorted_values, double p) {
+    if (sorted_values.empty()) return 0.0;
+
+    size_t rank = size_t(std::ceil(p * double(sorted_values.size())));
+    return sorted_values[std::clamp(rank, size_t(1), sorted_values.size()) - 1];
+}
+
 //=============================
 // OUTPUT CONTROL
 //=============================
 
-void Util::Debug(std::string message) {
-    std::time_t time = std::time(0);
-    std::tm* localTime = localtime(&time);
-    std::cout << "DEBUG || TIME: " << localTime->tm_hour << ":" << localTime->tm_min << ":" << localTime->tm_sec << " || " << message << std::endl;
-}
-
-void Util::ThrowError(std::string error, std::string function) {
-    std::time_t time = std::time(0);
-    std::tm* localTime = localtime(&time);
-    std::cout << "ERROR | " << function << " | "<< localTime->tm_hour << ":" << localTime->tm_min << ":" << localTime->tm_sec << " || " << error << std::endl;
+void Util::GetOpenGLError() {
+    GLenum error = GLDispatch::GetError();
+    if (error != GL_NO_ERROR) TF_LOG_ERROR("OPENGL ERROR " + std::to_string(error), "Util::GetOpenGLError");
 }
 
-void Util::GetOpenGLError() {
-    std::time_t time = std::time(0);
-    std::tm* localTime = localtime(&time);
+//=============================
+// TIMING
+//=============================
 
-    GLenum error = glGetError();
-    if (error != GL_NO_ERROR) {
-        std::cout << "OPENGL ERROR | " << localTime->tm_hour << ":" << localTime->tm_min << ":" << localTime->tm_sec << " || " << error << std::endl;
-    }
+double Util::GetElapsedMilliseconds(Uint64 start_counter) {
+    return double(SDL_GetPerformanceCounter() - start_counter) * 1000.0 / double(SDL_GetPerformanceFrequency());
 }
 
 //=============================
@@ -0,0 +1,344 @@
+#include "VoxelChunks.h"
+
+namespace {
+    // corners of each face in TotalFrame::FACE order, counter clockwise seen from outside
+    constexpr int FACE_CORNERS[6][4][3] = {
+        {{1, 0, 0}, {1, 1, 0}, {1, 1, 1}, {1, 0, 1}}, // +X
+        {{0, 0, 0}, {0, 0, 1}, {0, 1, 1}, {0, 1, 0}}, // -X
+        {{0, 1, 0}, {0, 1, 1}, {1, 1, 1}, {1, 1, 0}}, // +Y
+        {{0, 0, 0}, {1, 0, 0}, {1, 0, 1}, {0, 0, 1}}, // -Y
+        {{0, 0, 1}, {1, 0, 1}, {1, 1, 1}, {0, 1, 1}}, // +Z
+        {{0, 0, 0}, {0, 1, 0}, {1, 1, 0}, {1, 0, 0}}  // -Z
+    };
+    // two triangles per face
+    constexpr int QUAD_TRIANGLES[6] = {0, 1, 2, 0, 2, 3};
+}
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+VoxelChunks::VoxelChunks() {
+    ;
+}
+
+//=============================
+// CELL FUNCTIONS
+//=============================
+
+void VoxelChunks::Set(glm::ivec3 cell, Uint32 color) {
+    glm::ivec3 chunk_coordinate = OccupancyGrid::GetChunkCoordinate(cell);
+    glm::ivec3 local_cell = OccupancyGrid::GetLocalCell(cell, chunk_coordinate);
+    int index = VoxelChunks::_GetCellIndex(local_cell);
+
+    Chunk& chunk = VoxelChunks::_GetOrCreateChunk(chunk_coordinate);
+
+    // recoloring only changes this chunk's mesh
+    if (chunk.occupancy.Get(local_cell)) {
+        if (chunk.colors[index] == color) return;
+        chunk.colors[index] = color;
+        chunk.dirty = true;
+        return;
+    }
+
+    chunk.occupancy.Set(local_cell, true);
+    chunk.colors[index] = color;
+    chunk.total_cells++;
+    chunk.dirty = true;
+    total_cells++;
+
+    VoxelChunks::_DirtyNeighbors(chunk_coordinate, local_cell);
+}
+
+void VoxelChunks::SetChunk(glm::ivec3 chunk_coordinate, const OccupancyGrid::Chunk& cells, const std::array<Uint32, CHUNK_CELLS>& colors) {
+    if (cells.IsEmpty()) return;
+
+    Chunk& chunk = VoxelChunks::_GetOrCreateChunk(chunk_coordinate);
+    chunk.dirty = true;
+
+    // new cells on a border dirty the neighbor across it, same as Set()
+    Uint16 added_columns = 0;
+    bool added_on_side[3][2] = {};
+    for (int row = 0; row < OccupancyGrid::CHUNK_ROWS; row++) {
+        Uint16 bits = cells.rows[row];
+        if (bits == 0) continue;
+
+        Uint16 added = bits & Uint16(~chunk.occupancy.rows[row]);
+        chunk.occupancy.rows[row] |= bits;
+        chunk.total_cells += size_t(__builtin_popcount(added));
+        total_cells += size_t(__builtin_popcount(added));
+
+        for (Uint32 remaining = bits; remaining != 0; remaining &= remaining - 1) {
+            int index = row * CHUNK_SIZE + __builtin_ctz(remaining);
+            chunk.colors[index] = colors[index];
+        }
+
+        if (added == 0) continue;
+        int y = row % CHUNK_SIZE;
+        int z = row / CHUNK_SIZE;
+        added_columns |= added;
+        added_on_side[1][0] |= y == 0;
+        added_on_side[1][1] |= y == CHUNK_SIZE - 1;
+        added_on_side[2][0] |= z == 0;
+        added_on_side[2][1] |= z == CHUNK_SIZE - 1;
+    }
+    added_on_side[0][0] = (added_columns & 1) != 0;
+    added_on_side[0][1] = (added_columns >> (CHUNK_SIZE - 1)) != 0;
+
+    for (int axis = 0; axis < 3; axis++) {
+        for (int side = 0; side < 2; side++) {
+            if (!added_on_side[axis][side]) continue;
+
+            glm::ivec3 neighbor_coordinate = chunk_coordinate;
+            neighbor_coordinate[axis] += side == 0 ? -1 : 1;
+
+            Chunk* neighbor = VoxelChunks::_FindChunk(neighbor_coordinate);
+            if (neighbor != nullptr) neighbor->dirty = true;
+        }
+    }
+}
+
+void VoxelChunks::Clear(glm::ivec3 cell) {
+    glm::ivec3 chunk_coordinate = OccupancyGrid::GetChunkCoordinate(cell);
+    Chunk* chunk = VoxelChunks::_FindChunk(chunk_coordinate);
+    if (chunk == nullptr) return;
+
+    glm::ivec3 local_cell = OccupancyGrid::GetLocalCell(cell, chunk_coordinate);
+    int index = VoxelChunks::_GetCellIndex(local_cell);
+    if (!chunk->occupancy.Get(local_cell)) return;
+
+    chunk->occupancy.Set(local_cell, false);
+    chunk->colors[index] = 0;
+    chunk->total_cells--;
+    chunk->dirty = true;
+    total_cells--;
+
+    VoxelChunks::_DirtyNeighbors(chunk_coordinate, local_cell);
+
+    // empty chunks are dropped, their neighbors were already dirtied above
+    if (chunk->total_cells == 0) chunks.erase(OccupancyGrid::GetKey(chunk_coordinate));
+}
+
+bool VoxelChunks::IsOccupied(glm::ivec3 cell) const {
+    glm::ivec3 chunk_coordinate = OccupancyGrid::GetChunkCoordinate(cell);
+    const Chunk* chunk = VoxelChunks::_FindChunk(chunk_coordinate);
+    if (chunk == nullptr) return false;
+    return chunk->occupancy.Get(OccupancyGrid::GetLocalCell(cell, chunk_coordinate));
+}
+
+Uint32 VoxelChunks::GetColor(glm::ivec3 cell) const {
+    glm::ivec3 chunk_coordinate = OccupancyGrid::GetChunkCoordinate(cell);
+    const Chunk* chunk = VoxelChunks::_FindChunk(chunk_coordinate);
+    if (chunk == nullptr) return 0;
+    return chunk->colors[VoxelChunks::_GetCellIndex(OccupancyGrid::GetLocalCell(cell, chunk_coordinate))];
+}
+
+void VoxelChunks::ClearAll() {
+    chunks.clear();
+    total_cells = 0;
+}
+
+//=============================
+// MESH FUNCTIONS
+//=============================
+
+void VoxelChunks::Remesh(JobSystem* job_system) {
+    std::vector<Chunk*> dirty_chunks = {};
+    for (auto& [key, chunk] : chunks) {
+        if (chunk->dirty) dirty_chunks.push_back(chunk.get());
+    }
+    if (dirty_chunks.empty()) return;
+
+    // each chunk only writes its own mesh and only reads occupancy, which nothing changes meanwhile
+    auto MeshRange = [&](size_t start_index, size_t end_index) {
+        for (size_t i = start_index; i < end_index; i++) {
+            VoxelChunks::_BuildMesh(*dirty_chunks[i]);
+        }
+    };
+
+    if (job_system == nullptr) MeshRange(0, dirty_chunks.size());
+    else job_system->ParallelFor(dirty_chunks.size(), 1, MeshRange);
+}
+
+void VoxelChunks::Render(const Culler::Frustum& frustum, glm::vec3 origin, float cell_size, glm::vec3 stretch, GLint model_matrix_location, TotalFrame::RenderStats& stats_out) {
+    GLDispatch::Subsystem gl_subsystem("VoxelChunks");
+    glm::vec3 chunk_extent = glm::vec3(CHUNK_SIZE * 0.5f * cell_size) * stretch;
+
+    for (auto& [key, chunk] : chunks) {
+        if (chunk->upload_needed) VoxelChunks::_Upload(*chunk);
+        if (chunk->mesh.empty()) continue;
+
+        // cell centers sit on the lattice, so a chunk's corner is half a cell below its first center
+        glm::vec3 chunk_origin = origin + (glm::vec3(chunk->coordinate * CHUNK_SIZE) - 0.5f) * cell_size;
+
+        glm::vec3 chunk_center = (chunk_origin + glm::vec3(CHUNK_SIZE * 0.5f * cell_size)) * stretch;
+        if (!frustum.IsBoxVisible(chunk_center, chunk_extent)) continue;
+
+        glm::mat4 model_matrix = glm::scale(glm::translate(glm::scale(glm::mat4(1.0f), stretch), chunk_origin), glm::vec3(cell_size));
+        GLDispatch::UniformMatrix4fv(model_matrix_location, 1, GL_FALSE, glm::value_ptr(model_matrix));
+
+        GLDispatch::BindVertexArray(chunk->vertex_array.Get());
+        GLDispatch::DrawArrays(GL_TRIANGLES, 0, chunk->mesh.size());
+        GLDispatch::BindVertexArray(0);
+
+        stats_out.draw_calls++;
+        stats_out.triangles += chunk->mesh.size() / 3;
+    }
+}
+
+//=============================
+// GETTERS
+//=============================
+
+size_t VoxelChunks::GetTotalCells() const {
+    return total_cells;
+}
+
+size_t VoxelChunks::GetTotalChunks() const {
+    return chunks.size();
+}
+
+size_t VoxelChunks::GetTotalDirtyChunks() const {
+    size_t total_dirty_chunks = 0;
+    for (const auto& [key, chunk] : chunks) {
+        total_dirty_chunks += chunk->dirty;
+    }
+    return total_dirty_chunks;
+}
+
+size_t VoxelChunks::GetTotalTriangles() const {
+    size_t total_triangles = 0;
+    for (const auto& [key, chunk] : chunks) {
+        total_triangles += chunk->mesh.size() / 3;
+    }
+    return total_triangles;
+}
+
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
+
+int VoxelChunks::_GetCellIndex(glm::ivec3 local_cell) {
+    return (local_cell.z * CHUNK_SIZE + local_cell.y) * CHUNK_SIZE + local_cell.x;
+}
+
+VoxelChunks::Chunk* VoxelChunks::_FindChunk(glm::ivec3 chunk_coordinate) const {
+    auto found = chunks.find(OccupancyGrid::GetKey(chunk_coordinate));
+    return found == chunks.end() ? nullptr : found->second.get();
+}
+
+VoxelChunks::Chunk& VoxelChunks::_GetOrCreateChunk(glm::ivec3 chunk_coordinate) {
+    std::unique_ptr<Chunk>& chunk = chunks[OccupancyGrid::GetKey(chunk_coordinate)];
+    if (chunk == nullptr) {
+        chunk = std::make_unique<Chunk>();
+        chunk->coordinate = chunk_coordinate;
+    }
+    return *chunk;
+}
+
+void VoxelChunks::_DirtyNeighbors(glm::ivec3 chunk_coordinate, glm::ivec3 local_cell) {
+    for (int axis = 0; axis < 3; axis++) {
+        int side = 0;
+        if (local_cell[axis] == 0) side = -1;
+        else if (local_cell[axis] == CHUNK_SIZE - 1) side = 1;
+        if (side == 0) continue;
+
+        glm::ivec3 neighbor_coordinate = chunk_coordinate;
+        neighbor_coordinate[axis] += side;
+
+        Chunk* neighbor = VoxelChunks::_FindChunk(neighbor_coordinate);
+        if (neighbor != nullptr) neighbor->dirty = true;
+    }
+}
+
+void VoxelChunks::_BuildMesh(Chunk& chunk) const {
+    // the six neighbors' occupancy, so faces against them are culled too
+    OccupancyGrid::Neighbors neighbors;
+    for (int face = 0; face < 6; face++) {
+        const Chunk* neighbor = VoxelChunks::_FindChunk(chunk.coordinate + glm::ivec3(TotalFrame::FACE_NORMALS[face]));
+        neighbors[face] = neighbor == nullptr ? nullptr : &neighbor->occupancy;
+    }
+
+    // a bit for every face not covered by another cube, found a slab at a time
+    std::array<OccupancyGrid::Chunk, 6> exposed_faces;
+    OccupancyGrid::GetExposedFaces(chunk.occupancy, neighbors, exposed_faces);
+
+    chunk.mesh.clear();
+
+    for (int face = 0; face < 6; face++) {
+        for (int row = 0; row < OccupancyGrid::CHUNK_ROWS; row++) {
+            int y = row % CHUNK_SIZE;
+            int z = row / CHUNK_SIZE;
+
+            for (Uint16 bits = exposed_faces[face].rows[row]; bits != 0; bits &= Uint16(bits - 1)) {
+                int x = __builtin_ctz(bits);
+                Uint32 color = chunk.colors[row * CHUNK_SIZE + x];
+
+                for (int corner : QUAD_TRIANGLES) {
+                    TotalFrame::PackedVertex vertex;
+                    vertex.position[0] = GLshort(x + FACE_CORNERS[face][corner][0]);
+                    vertex.position[1] = GLshort(y + FACE_CORNERS[face][corner][1]);
+                    vertex.position[2] = GLshort(z + FACE_CORNERS[face][corner][2]);
+                    vertex.position[3] = GLshort(face);
+                    vertex.color[0] = GLubyte(color & 0xFF);
+                    vertex.color[1] = GLubyte((color >> 8) & 0xFF);
+                    vertex.color[2] = GLubyte((color >> 16) & 0xFF);
+                    vertex.color[3] = 255;
+                    chunk.mesh.push_back(vertex);
+                }
+            }
+        }
+    }
+
+    chunk.dirty = false;
+    chunk.upload_needed = true;
+}
+
+void VoxelChunks::_Upload(Chunk& chunk) {
+    chunk.upload_needed = false;
+    if (chunk.mesh.empty()) return;
+
+    if (!chunk.vertex_array) {
+        chunk.vertex_array.Create();
+        chunk.vertex_buffer.Create();
+
+        GLDispatch::BindVertexArray(chunk.vertex_array.Get());
+        GLDispatch::BindBuffer(GL_ARRAY_BUFFER, chunk.vertex_buffer.Get());
+
+        GLsizei stride = sizeof(TotalFrame::PackedVertex);
+
+        // Position + face index (w), chunk local corners
+        GLDispatch::VertexAttribPointer(0, 4, GL_SHORT, GL_FALSE, stride, (GLvoid*)(offsetof(TotalFrame::PackedVertex, position)));
+        GLDispatch::EnableVertexAttribArray(0);
+
+        // Color
+        GLDispatch::VertexAttribPointer(1, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (GLvoid*)(offsetof(TotalFrame::PackedVertex, color)));
+        GLDispatch::EnableVertexAttribArray(1);
+
+        GLDispatch::BindVertexArray(0);
+    }
+
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, chunk.vertex_buffer.Get());
+
+    // the buffer is only reallocated when the mesh outgrows it, and then with room to spare
+    if (chunk.mesh.size() > chunk.buffer_capacity) {
+        chunk.buffer_capacity = std::max(chunk.mesh.size(), chunk.buffer_capacity * 2);
+        GLDispatch::BufferData(GL_ARRAY_BUFFER, chunk.buffer_capacity * sizeof(TotalFrame::PackedVertex), nullptr, GL_DYNAMIC_DRAW);
+    }
+    GLDispatch::BufferSubData(GL_ARRAY_BUFFER, 0, chunk.mesh.size() * sizeof(TotalFrame::PackedVertex), chunk.mesh.data());
+
+    GLDispatch::BindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+//=============================
+// MEMORY MANAGEMENT
+//=============================
+
+void VoxelChunks::FreeAll() {
+    for (auto& [key, chunk] : chunks) {
+        chunk->vertex_array.Reset();
+        chunk->vertex_buffer.Reset();
+        chunk->buffer_capacity = 0;
+        chunk->upload_needed = true;
+    }
+}
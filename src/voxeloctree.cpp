@@ -0,0 +1,517 @@
+#include "VoxelOctree.h"
+
+//=============================
+// DEFAULT CONSTRUCTOR
+//=============================
+
+VoxelOctree::VoxelOctree() {
+    ;
+}
+
+//=============================
+// CELL FUNCTIONS
+//=============================
+
+bool VoxelOctree::Insert(glm::ivec3 cell, Uint32 value) {
+    if (glm::any(glm::greaterThan(glm::abs(cell), glm::ivec3(MAX_CELL)))) return false;
+
+    if (root == NO_NODE) {
+        // the first cell gets a root of 2^1 around it
+        root = VoxelOctree::_NewNode();
+        root_depth = 1;
+        root_origin = cell - ((cell % 2) + 2) % 2;
+    }
+    if (!VoxelOctree::_IsInRoot(cell) && !VoxelOctree::_GrowRoot(cell)) return false;
+
+    // walk down, creating the missing branches
+    Uint32 node = root;
+    glm::ivec3 origin = root_origin;
+    for (int depth = root_depth; depth > 1; depth--) {
+        int child = VoxelOctree::_GetChild(cell, origin, depth);
+        if (!(nodes[node].mask & (1 << child))) {
+            // _NewNode() may reallocate nodes, so it is called before indexing
+            Uint32 new_node = VoxelOctree::_NewNode();
+            nodes[node].children[child] = new_node;
+            nodes[node].mask |= Uint8(1 << child);
+        }
+        origin = VoxelOctree::_GetChildOrigin(origin, depth, child);
+        node = nodes[node].children[child];
+    }
+
+    int child = VoxelOctree::_GetChild(cell, origin, 1);
+    if (!(nodes[node].mask & (1 << child))) {
+        nodes[node].mask |= Uint8(1 << child);
+        total_cells++;
+    }
+    nodes[node].children[child] = value;
+
+    return true;
+}
+
+size_t VoxelOctree::InsertMany(const Entry* entries, size_t count) {
+    // nodes of the last walk by depth, valid while the root stays the same
+    Uint32 path_nodes[MAX_DEPTH + 1];
+    glm::ivec3 path_origins[MAX_DEPTH + 1];
+    Uint32 path_root = NO_NODE;
+    size_t total_inserted = 0;
+
+    for (size_t i = 0; i < count; i++) {
+        glm::ivec3 cell = entries[i].cell;
+
+        // cells outside the root go through Insert(), which grows it
+        if (root == NO_NODE || !VoxelOctree::_IsInRoot(cell)) {
+            total_inserted += VoxelOctree::Insert(cell, entries[i].value);
+            continue;
+        }
+
+        if (path_root != root) {
+            path_root = root;
+            path_nodes[root_depth] = root;
+            path_origins[root_depth] = root_origin;
+            for (int depth = 1; depth < root_depth; depth++) {
+                path_nodes[depth] = NO_NODE;
+            }
+        }
+
+        // the deepest node of the last walk that still holds the cell
+        int depth = 1;
+        while (depth < root_depth) {
+            glm::ivec3 offset = cell - path_origins[depth];
+            if (path_nodes[depth] != NO_NODE && glm::all(glm::greaterThanEqual(offset, glm::ivec3(0))) && glm::all(glm::lessThan(offset, glm::ivec3(1 << depth)))) break;
+            depth++;
+        }
+
+        Uint32 node = path_nodes[depth];
+        glm::ivec3 origin = path_origins[depth];
+        for (; depth > 1; depth--) {
+            int child = VoxelOctree::_GetChild(cell, origin, depth);
+            if (!(nodes[node].mask & (1 << child))) {
+                // _NewNode() may reallocate nodes, so it is called before indexing
+                Uint32 new_node = VoxelOctree::_NewNode();
+                nodes[node].children[child] = new_node;
+                nodes[node].mask |= Uint8(1 << child);
+            }
+            origin = VoxelOctree::_GetChildOrigin(origin, depth, child);
+            node = nodes[node].children[child];
+            path_nodes[depth - 1] = node;
+            path_origins[depth - 1] = origin;
+        }
+
+        int child = VoxelOctree::_GetChild(cell, origin, 1);
+        if (!(nodes[node].mask & (1 << child))) {
+            nodes[node].mask |= Uint8(1 << child);
+            total_cells++;
+        }
+        nodes[node].children[child] = entries[i].value;
+        total_inserted++;
+    }
+
+    return total_inserted;
+}
+
+bool VoxelOctree::Remove(glm::ivec3 cell) {
+    if (root == NO_NODE || !VoxelOctree::_IsInRoot(cell)) return false;
+
+    // remember the path so emptied nodes can be freed on the way back up
+    Uint32 path_nodes[MAX_DEPTH + 1];
+    int path_children[MAX_DEPTH + 1];
+    int path_length = 0;
+
+    Uint32 node = root;
+    glm::ivec3 origin = root_origin;
+    for (int depth = root_depth; depth >= 1; depth--) {
+        int child = VoxelOctree::_GetChild(cell, origin, depth);
+        if (!(nodes[node].mask & (1 << child))) return false;
+
+        path_nodes[path_length] = node;
+        path_children[path_length] = child;
+        path_length++;
+
+        if (depth == 1) break;
+        origin = VoxelOctree::_GetChildOrigin(origin, depth, child);
+        node = nodes[node].children[child];
+    }
+
+    total_cells--;
+
+    for (int i = path_length - 1; i >= 0; i--) {
+        Node& path_node = nodes[path_nodes[i]];
+        path_node.mask &= Uint8(~(1 << path_children[i]));
+        if (path_node.mask != 0) break;
+
+        // the node is empty, free it and take it out of its parent on the next step
+        VoxelOctree::_FreeNode(path_nodes[i]);
+        if (i == 0) root = NO_NODE;
+    }
+
+    VoxelOctree::_ShrinkRoot();
+    return true;
+}
+
+bool VoxelOctree::Find(glm::ivec3 cell, Uint32& value_out) const {
+    if (root == NO_NODE || !VoxelOctree::_IsInRoot(cell)) return false;
+
+    Uint32 node = root;
+    glm::ivec3 origin = root_origin;
+    for (int depth = root_depth; depth >= 1; depth--) {
+        int child = VoxelOctree::_GetChild(cell, origin, depth);
+        if (!(nodes[node].mask & (1 << child))) return false;
+
+        if (depth == 1) {
+            value_out = nodes[node].children[child];
+            return true;
+        }
+        origin = VoxelOctree::_GetChildOrigin(origin, depth, child);
+        node = nodes[node].children[child];
+    }
+    return false;
+}
+
+void VoxelOctree::Clear() {
+    nodes.clear();
+    free_nodes.clear();
+    root = NO_NODE;
+    root_origin = glm::ivec3(0);
+    root_depth = 0;
+    total_cells = 0;
+}
+
+void VoxelOctree::ForEach(const std::function<void(glm::ivec3 cell, Uint32& value)>& function) {
+    if (root == NO_NODE) return;
+    VoxelOctree::_ForEach(root, root_origin, root_depth, function);
+}
+
+//=============================
+// QUERIES
+//=============================
+
+bool VoxelOctree::RayCast(glm::vec3 origin, glm::vec3 direction, RayHit& hit_out) const {
+    if (root == NO_NODE || direction == glm::vec3(0.0f)) return false;
+
+    // 0 on an axis gives an infinite inverse, _RayBox() handles that axis by containment instead
+    glm::vec3 inverse_direction = 1.0f / direction;
+    return VoxelOctree::_RayCast(root, root_origin, root_depth, origin, inverse_direction, hit_out);
+}
+
+void VoxelOctree::QueryRegion(glm::ivec3 min_cell, glm::ivec3 max_cell, std::vector<Entry>& entries_out) const {
+    if (root == NO_NODE || glm::any(glm::greaterThan(min_cell, max_cell))) return;
+    VoxelOctree::_QueryRegion(root, root_origin, root_depth, min_cell, max_cell, entries_out);
+}
+
+//=============================
+// SERIALIZATION
+//=============================
+
+std::vector<Uint8> VoxelOctree::Serialize() const {
+    std::vector<Uint8> data = {};
+
+    auto WriteUint32 = [&](Uint32 value) {
+        for (int byte = 0; byte < 4; byte++) {
+            data.push_back(Uint8(value >> (byte * 8)));
+        }
+    };
+
+    // header: magic, version, total cells, root depth, root origin. all little endian
+    WriteUint32(SERIAL_MAGIC);
+    WriteUint32(SERIAL_VERSION);
+    WriteUint32(Uint32(total_cells));
+    WriteUint32(Uint32(root == NO_NODE ? 0 : root_depth));
+    for (int axis = 0; axis < 3; axis++) {
+        WriteUint32(Uint32(root_origin[axis]));
+    }
+
+    // then every node in pre-order: its child mask, followed by its children (nodes, or values at depth 1)
+    if (root != NO_NODE) VoxelOctree::_Serialize(root, root_depth, data);
+
+    return data;
+}
+
+bool VoxelOctree::Deserialize(const Uint8* data, size_t size) {
+    VoxelOctree::Clear();
+
+    size_t offset = 0;
+    auto ReadUint32 = [&](Uint32& value_out) {
+        if (offset + 4 > size) return false;
+        value_out = 0;
+        for (int byte = 0; byte < 4; byte++) {
+            value_out |= Uint32(data[offset++]) << (byte * 8);
+        }
+        return true;
+    };
+
+    Uint32 header[7];
+    for (auto& value : header) {
+        if (!ReadUint32(value)) {
+            TF_LOG_ERROR("TRUNCATED OCTREE DATA", "VoxelOctree::Deserialize");
+            return false;
+        }
+    }
+    if (header[0] != SERIAL_MAGIC || header[1] != SERIAL_VERSION || header[3] > Uint32(MAX_DEPTH)) {
+        TF_LOG_ERROR("INVALID OCTREE DATA", "VoxelOctree::Deserialize");
+        return false;
+    }
+
+    Uint32 expected_cells = header[2];
+    int depth = int(header[3]);
+    if (depth == 0) return expected_cells == 0;
+
+    root_depth = depth;
+    root_origin = glm::ivec3(Sint32(header[4]), Sint32(header[5]), Sint32(header[6]));
+
+    bool valid = true;
+    root = VoxelOctree::_Deserialize(root_depth, data, size, offset, valid);
+
+    if (!valid || total_cells != expected_cells) {
+        TF_LOG_ERROR("INVALID OCTREE DATA", "VoxelOctree::Deserialize");
+        VoxelOctree::Clear();
+        return false;
+    }
+    return true;
+}
+
+//=============================
+// GETTERS
+//=============================
+
+size_t VoxelOctree::GetTotalCells() const {
+    return total_cells;
+}
+
+size_t VoxelOctree::GetTotalNodes() const {
+    return nodes.size() - free_nodes.size();
+}
+
+size_t VoxelOctree::GetMemoryUsage() const {
+    return nodes.capacity() * sizeof(Node) + free_nodes.capacity() * sizeof(Uint32);
+}
+
+//=============================
+// PRIVATE FUNCTIONS
+//=============================
+
+Uint32 VoxelOctree::_NewNode() {
+    if (!free_nodes.empty()) {
+        Uint32 node = free_nodes.back();
+        free_nodes.pop_back();
+        nodes[node] = Node();
+        return node;
+    }
+    nodes.push_back(Node());
+    return Uint32(nodes.size() - 1);
+}
+
+void VoxelOctree::_FreeNode(Uint32 node) {
+    nodes[node].mask = 0;
+    free_nodes.push_back(node);
+}
+
+int VoxelOctree::_GetChild(glm::ivec3 cell, glm::ivec3 origin, int depth) {
+    int half_size = 1 << (depth - 1);
+    return int(cell.x - origin.x >= half_size) | (int(cell.y - origin.y >= half_size) << 1) | (int(cell.z - origin.z >= half_size) << 2);
+}
+
+glm::ivec3 VoxelOctree::_GetChildOrigin(glm::ivec3 origin, int depth, int child) {
+    int half_size = 1 << (depth - 1);
+    return origin + glm::ivec3(child & 1, (child >> 1) & 1, (child >> 2) & 1) * half_size;
+}
+
+bool VoxelOctree::_IsInRoot(glm::ivec3 cell) const {
+    glm::ivec3 offset = cell - root_origin;
+    int size = 1 << root_depth;
+    return glm::all(glm::greaterThanEqual(offset, glm::ivec3(0))) && glm::all(glm::lessThan(offset, glm::ivec3(size)));
+}
+
+bool VoxelOctree::_GrowRoot(glm::ivec3 cell) {
+    while (!VoxelOctree::_IsInRoot(cell)) {
+        if (root_depth >= MAX_DEPTH) return false;
+
+        // the old root becomes the child on the side away from the cell, so the new root extends toward it
+        int size = 1 << root_depth;
+        int child = 0;
+        glm::ivec3 new_origin = root_origin;
+        for (int axis = 0; axis < 3; axis++) {
+            if (cell[axis] < root_origin[axis]) {
+                new_origin[axis] -= size;
+                child |= 1 << axis;
+            }
+        }
+
+        Uint32 new_root = VoxelOctree::_NewNode();
+        nodes[new_root].children[child] = root;
+        nodes[new_root].mask = Uint8(1 << child);
+
+        root = new_root;
+        root_origin = new_origin;
+        root_depth++;
+    }
+    return true;
+}
+
+void VoxelOctree::_ShrinkRoot() {
+    // a root with one child covers nothing its child does not, so the child takes over
+    while (root != NO_NODE && root_depth > 1) {
+        Uint8 mask = nodes[root].mask;
+        if (mask & (mask - 1)) return;
+
+        int child = 0;
+        while (!(mask & (1 << child))) child++;
+
+        Uint32 old_root = root;
+        root_origin = VoxelOctree::_GetChildOrigin(root_origin, root_depth, child);
+        root = nodes[old_root].children[child];
+        root_depth--;
+        VoxelOctree::_FreeNode(old_root);
+    }
+}
+
+bool VoxelOctree::_RayCast(Uint32 node, glm::ivec3 origin, int depth, glm::vec3 ray_origin, glm::vec3 inverse_direction, RayHit& hit_out) const {
+    const Node& current = nodes[node];
+
+    // children hit by the ray, visited nearest first. the octants never overlap, so the first hit found is the closest
+    struct ChildHit {
+        float t_enter;
+        int child;
+        int axis;
+    };
+    ChildHit child_hits[8];
+    int total_child_hits = 0;
+
+    for (int child = 0; child < 8; child++) {
+        if (!(current.mask & (1 << child))) continue;
+
+        glm::vec3 child_min = glm::vec3(VoxelOctree::_GetChildOrigin(origin, depth, child));
+        glm::vec3 child_max = child_min + float(1 << (depth - 1));
+
+        float t_enter, t_exit;
+        int axis;
+        if (!VoxelOctree::_RayBox(child_min, child_max, ray_origin, inverse_direction, t_enter, t_exit, axis)) continue;
+
+        // insertion sort, there are at most 8
+        int i = total_child_hits++;
+        while (i > 0 && child_hits[i - 1].t_enter > t_enter) {
+            child_hits[i] = child_hits[i - 1];
+            i--;
+        }
+        child_hits[i] = {t_enter, child, axis};
+    }
+
+    for (int i = 0; i < total_child_hits; i++) {
+        const ChildHit& child_hit = child_hits[i];
+        glm::ivec3 child_origin = VoxelOctree::_GetChildOrigin(origin, depth, child_hit.child);
+
+        if (depth == 1) {
+            hit_out.cell = child_origin;
+            hit_out.value = current.children[child_hit.child];
+            hit_out.t = child_hit.t_enter;
+            hit_out.axis = child_hit.axis;
+            return true;
+        }
+        if (VoxelOctree::_RayCast(current.children[child_hit.child], child_origin, depth - 1, ray_origin, inverse_direction, hit_out)) return true;
+    }
+    return false;
+}
+
+bool VoxelOctree::_RayBox(glm::vec3 box_min, glm::vec3 box_max, glm::vec3 ray_origin, glm::vec3 inverse_direction, float& t_enter_out, float& t_exit_out, int& axis_out) {
+    t_enter_out = -std::numeric_limits<float>::max();
+    t_exit_out = std::numeric_limits<float>::max();
+    axis_out = 0;
+
+    for (int axis = 0; axis < 3; axis++) {
+        // parallel to this axis, the line is either always or never between the slabs
+        if (std::isinf(inverse_direction[axis])) {
+            if (ray_origin[axis] < box_min[axis] || ray_origin[axis] > box_max[axis]) return false;
+            continue;
+        }
+
+        float t1 = (box_min[axis] - ray_origin[axis]) * inverse_direction[axis];
+        float t2 = (box_max[axis] - ray_origin[axis]) * inverse_direction[axis];
+        if (t1 > t2) std::swap(t1, t2);
+
+        if (t1 > t_enter_out) {
+            t_enter_out = t1;
+            axis_out = axis;
+        }
+        t_exit_out = std::min(t_exit_out, t2);
+        if (t_enter_out > t_exit_out) return false;
+    }
+    return true;
+}
+
+void VoxelOctree::_QueryRegion(Uint32 node, glm::ivec3 origin, int depth, glm::ivec3 min_cell, glm::ivec3 max_cell, std::vector<Entry>& entries_out) const {
+    const Node& current = nodes[node];
+    int child_size = 1 << (depth - 1);
+
+    for (int child = 0; child < 8; child++) {
+        if (!(current.mask & (1 << child))) continue;
+
+        // skip children outside the region
+        glm::ivec3 child_origin = VoxelOctree::_GetChildOrigin(origin, depth, child);
+        glm::ivec3 child_last = child_origin + (child_size - 1);
+        if (glm::any(glm::greaterThan(child_origin, max_cell)) || glm::any(glm::lessThan(child_last, min_cell))) continue;
+
+        if (depth == 1) entries_out.push_back({child_origin, current.children[child]});
+        else VoxelOctree::_QueryRegion(current.children[child], child_origin, depth - 1, min_cell, max_cell, entries_out);
+    }
+}
+
+void VoxelOctree::_ForEach(Uint32 node, glm::ivec3 origin, int depth, const std::function<void(glm::ivec3 cell, Uint32& value)>& function) {
+    for (int child = 0; child < 8; child++) {
+        if (!(nodes[node].mask & (1 << child))) continue;
+
+        glm::ivec3 child_origin = VoxelOctree::_GetChildOrigin(origin, depth, child);
+        if (depth == 1) function(child_origin, nodes[node].children[child]);
+        else VoxelOctree::_ForEach(nodes[node].children[child], child_origin, depth - 1, function);
+    }
+}
+
+void VoxelOctree::_Serialize(Uint32 node, int depth, std::vector<Uint8>& data_out) const {
+    const Node& current = nodes[node];
+    data_out.push_back(current.mask);
+
+    for (int child = 0; child < 8; child++) {
+        if (!(current.mask & (1 << child))) continue;
+
+        if (depth == 1) {
+            for (int byte = 0; byte < 4; byte++) {
+                data_out.push_back(Uint8(current.children[child] >> (byte * 8)));
+            }
+        } else {
+            VoxelOctree::_Serialize(current.children[child], depth - 1, data_out);
+        }
+    }
+}
+
+Uint32 VoxelOctree::_Deserialize(int depth, const Uint8* data, size_t size, size_t& offset, bool& valid) {
+    // an empty node is never written, so a zero mask is corrupt data
+    if (offset >= size || data[offset] == 0) {
+        valid = false;
+        return NO_NODE;
+    }
+
+    Uint32 node = VoxelOctree::_NewNode();
+    Uint8 mask = data[offset++];
+    nodes[node].mask = mask;
+
+    for (int child = 0; child < 8 && valid; child++) {
+        if (!(mask & (1 << child))) continue;
+
+        if (depth == 1) {
+            if (offset + 4 > size) {
+                valid = false;
+                break;
+            }
+            Uint32 value = 0;
+            for (int byte = 0; byte < 4; byte++) {
+                value |= Uint32(data[offset++]) << (byte * 8);
+            }
+            nodes[node].children[child] = value;
+            total_cells++;
+        } else {
+            // nodes may reallocate while the child is read, so the index is only stored afterwards
+            Uint32 child_node = VoxelOctree::_Deserialize(depth - 1, data, size, offset, valid);
+            nodes[node].children[child] = child_node;
+        }
+    }
+
+    return node;
+}
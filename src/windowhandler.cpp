@@ -6,42 +6,48 @@
 
 WindowHandler::WindowHandler(Uint16 p_w, Uint16 p_h, SDL_FColor p_color, std::string p_title, bool vsync, float p_target_fps) 
                             : width(p_w), height(p_h), color(p_color), title(p_title), target_fps(p_target_fps) {
+    GLDispatch::Subsystem gl_subsystem("WindowHandler");
 
-    // INIT OPENGL
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
-    SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
+    // HEADLESS
+    bool headless = GLDispatch::GetBackend() == GLDispatch::NULL_BACKEND;
 
-    // CREATE WINDOW
-    window = SDL_CreateWindow(title.c_str(), width, height, SDL_WINDOW_OPENGL);
-    
-    // OPENGL CONTEXT + GLEW
-    context = SDL_GL_CreateContext(window);
-    SDL_GL_MakeCurrent(window, context);
+    if (!headless) {
+        // INIT OPENGL
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MAJOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_MINOR_VERSION, 3);
+        SDL_GL_SetAttribute(SDL_GL_CONTEXT_PROFILE_MASK, SDL_GL_CONTEXT_PROFILE_CORE);
 
-    // Vsync
-    if (vsync) SDL_GL_SetSwapInterval(1);
+        // CREATE WINDOW
+        window = SDL_CreateWindow(title.c_str(), width, height, SDL_WINDOW_OPENGL);
 
-    glewExperimental = GL_TRUE;
-    if (glewInit() != GLEW_OK) Util::ThrowError("GLEW NOT INITIALIZED PROPERLY", "windowhandler");
+        // OPENGL CONTEXT + GLEW
+        context = SDL_GL_CreateContext(window);
+        SDL_GL_MakeCurrent(window, context);
 
-    glEnable(GL_DEPTH_TEST);
+        // Vsync
+        if (vsync) SDL_GL_SetSwapInterval(1);
+
+        glewExperimental = GL_TRUE;
+        if (glewInit() != GLEW_OK) TF_LOG_ERROR("GLEW NOT INITIALIZED PROPERLY", "windowhandler");
+    }
+
+    GLDispatch::Enable(GL_DEPTH_TEST);
 
     // backface culling ccw
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
+    GLDispatch::Enable(GL_CULL_FACE);
+    GLDispatch::CullFace(GL_BACK);
+    GLDispatch::FrontFace(GL_CCW);
 
     // line thickness
-    glLineWidth(1.0f);
+    GLDispatch::LineWidth(1.0f);
 
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    GLDispatch::Enable(GL_BLEND);
+    GLDispatch::BlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 
-    glClearColor(color.r, color.g, color.b, color.a);
-    glViewport(0, 0, width, height);
+    GLDispatch::ClearColor(color.r, color.g, color.b, color.a);
+    GLDispatch::Viewport(0, 0, width, height);
 
-    frame_duration = 1000.0f / target_fps;
+    WindowHandler::SetTargetFps(target_fps);
     aspect_ratio = float(width) / float(height);
 }
 
@@ -50,11 +56,47 @@ WindowHandler::WindowHandler(Uint16 p_w, Uint16 p_h, SDL_FColor p_color, std::st
 //=============================
 
 void WindowHandler::Update() {
-    SDL_GL_SwapWindow(window);
+    if (window) SDL_GL_SwapWindow(window);
 }
 
 void WindowHandler::Clear() {
-    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    GLDispatch::Subsystem gl_subsystem("WindowHandler");
+    GLDispatch::Clear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+}
+
+//=============================
+// FRAME PACING
+//=============================
+
+void WindowHandler::WaitForNextFrame(bool animating) {
+    //// IDLE
+    // an event wakes it straight away and is left in the queue for the event loop
+    if (!need_render && !animating) {
+        SDL_WaitEventTimeout(nullptr, MAX_IDLE_WAIT);
+        frame_due = SDL_GetPerformanceCounter();
+        return;
+    }
+
+    //// ACTIVE
+    Uint64 now = SDL_GetPerformanceCounter();
+    if (frame_duration <= 0.0f || frame_due == 0) {
+        frame_due = now;
+        return;
+    }
+
+    Uint64 frequency = SDL_GetPerformanceFrequency();
+    Uint64 frame_counts = Uint64(double(frame_duration) / 1000.0 * double(frequency));
+    Uint64 due = frame_due + frame_counts;
+
+    if (now < due) {
+        double remaining = double(due - now) * 1000.0 / double(frequency);
+        if (remaining > SPIN_MILLISECONDS) SDL_DelayNS(Uint64((remaining - SPIN_MILLISECONDS) * 1000000.0));
+        while (SDL_GetPerformanceCounter() < due) {}
+        now = due;
+    }
+
+    // stay on the frame grid, unless a slow frame put it a whole frame behind
+    frame_due = now - due > frame_counts ? now : due;
 }
 
 //=============================
@@ -73,9 +115,6 @@ void WindowHandler::UpdateDeltaTime(Uint64 p_current_app_time, Uint64 time_frequ
 
     // SET IT EQUAL TO DELTA TIME PTR
     *delta_time = calculated_delta_time;
-
-    // SLEEP TO MAKE TARGET FPS
-    if (*delta_time < floor(frame_duration - *delta_time)) SDL_Delay(floor(frame_duration - *delta_time));
 }
 
 //=============================
@@ -98,6 +137,11 @@ void WindowHandler::SetColor(SDL_FColor p_color) {
     color = p_color;
 }
 
+void WindowHandler::SetTargetFps(float p_target_fps) {
+    target_fps = p_target_fps;
+    frame_duration = target_fps > 0.0f ? 1000.0f / target_fps : 0.0f;
+}
+
 void WindowHandler::PassNamePtr(const std::shared_ptr<std::string>& name) {
     current_file_name = name;
     WindowHandler::UpdateName();
@@ -108,7 +152,7 @@ void WindowHandler::UpdateName() {
     temp_title += title;
     temp_title += " | ";
     temp_title += *current_file_name;
-    SDL_SetWindowTitle(window, temp_title.c_str());
+    if (window) SDL_SetWindowTitle(window, temp_title.c_str());
 }
 
 //=============================
@@ -124,6 +168,7 @@ std::shared_ptr<double> WindowHandler::DeltaTime() {
 //=============================s
 
 WindowHandler::~WindowHandler() {
+    if (!window) return;
     SDL_DestroyWindow(window);
     SDL_GL_DestroyContext(context);
 }
\ No newline at end of file